@@ -3,37 +3,66 @@
 
 #include "matrix.h"
 
+// Element-wise and row-wise activations, templated on the element type
+// (float and double are instantiated in activation_functions.h.cpp)
 namespace ActivationFunctions {
 
     // ReLU activation function
-    Matrix relu(const Matrix& input);
-    Matrix reluDerivative(const Matrix& input);
+    template <typename T> MatrixT<T> relu(const MatrixT<T>& input);
+    template <typename T> MatrixT<T> reluDerivative(const MatrixT<T>& input);
 
     // GELU activation function
-    Matrix gelu(const Matrix& input);
-    Matrix geluDerivative(const Matrix& input);
+    template <typename T> MatrixT<T> gelu(const MatrixT<T>& input);
+    template <typename T> MatrixT<T> geluDerivative(const MatrixT<T>& input);
 
     // Softmax activation function
-    Matrix softmax(const Matrix& input, int axis = 1);
+    template <typename T> MatrixT<T> softmax(const MatrixT<T>& input, int axis = 1);
 
     // Dropout (for inference, acts as identity)
-    Matrix dropout(const Matrix& input, double dropout_rate = 0.0, bool training = false);
+    template <typename T> MatrixT<T> dropout(const MatrixT<T>& input, double dropout_rate = 0.0, bool training = false);
 
     // Layer normalization helpers
-    Matrix layerNorm(const Matrix& input, const Matrix& gamma, const Matrix& beta,
-                     double epsilon = 1e-5, int axis = 1);
+    template <typename T> MatrixT<T> layerNorm(const MatrixT<T>& input, const MatrixT<T>& gamma, const MatrixT<T>& beta,
+                                               double epsilon = 1e-5, int axis = 1);
 
     // Helper functions for layer normalization
-    Matrix computeLayerNormStats(const Matrix& input, int axis = 1);
-    std::pair<Matrix, Matrix> computeMeanAndVariance(const Matrix& input, int axis = 1);
+    template <typename T> MatrixT<T> computeLayerNormStats(const MatrixT<T>& input, int axis = 1);
+    template <typename T> std::pair<MatrixT<T>, MatrixT<T>> computeMeanAndVariance(const MatrixT<T>& input, int axis = 1);
 
     // Additional activation functions
-    Matrix sigmoid(const Matrix& input);
-    Matrix tanh(const Matrix& input);
-    Matrix leakyRelu(const Matrix& input, double alpha = 0.01);
+    template <typename T> MatrixT<T> sigmoid(const MatrixT<T>& input);
+    template <typename T> MatrixT<T> tanh(const MatrixT<T>& input);
+    template <typename T> MatrixT<T> leakyRelu(const MatrixT<T>& input, double alpha = 0.01);
 
     // Utility functions
-    Matrix clip(const Matrix& input, double min_val, double max_val);
+    template <typename T> MatrixT<T> clip(const MatrixT<T>& input, double min_val, double max_val);
+
+    // Output-parameter variants: out must already have the input's shape and
+    // is overwritten without allocating; out may be the input itself
+    template <typename T> void relu_into(OutputViewT<T> out, ConstMatrixViewT<T> input);
+    template <typename T> void reluDerivative_into(OutputViewT<T> out, ConstMatrixViewT<T> input);
+    template <typename T> void gelu_into(OutputViewT<T> out, ConstMatrixViewT<T> input);
+    template <typename T> void geluDerivative_into(OutputViewT<T> out, ConstMatrixViewT<T> input);
+    template <typename T> void softmax_into(OutputViewT<T> out, ConstMatrixViewT<T> input, int axis = 1);
+    template <typename T> void dropout_into(OutputViewT<T> out, ConstMatrixViewT<T> input, double dropout_rate = 0.0, bool training = false);
+    template <typename T> void layerNorm_into(OutputViewT<T> out, ConstMatrixViewT<T> input, ConstMatrixViewT<T> gamma,
+                                              ConstMatrixViewT<T> beta, double epsilon = 1e-5, int axis = 1);
+    template <typename T> void sigmoid_into(OutputViewT<T> out, ConstMatrixViewT<T> input);
+    template <typename T> void tanh_into(OutputViewT<T> out, ConstMatrixViewT<T> input);
+    template <typename T> void leakyRelu_into(OutputViewT<T> out, ConstMatrixViewT<T> input, double alpha = 0.01);
+    template <typename T> void clip_into(OutputViewT<T> out, ConstMatrixViewT<T> input, double min_val, double max_val);
+
+    // In-place variants (pass matrix.view() for a Matrix)
+    template <typename T> void relu_inplace(MatrixViewT<T> x);
+    template <typename T> void gelu_inplace(MatrixViewT<T> x);
+    template <typename T> void softmax_inplace(MatrixViewT<T> x, int axis = 1);
+    template <typename T> void dropout_inplace(MatrixViewT<T> x, double dropout_rate = 0.0, bool training = false);
+    template <typename T> void layerNorm_inplace(MatrixViewT<T> x, ConstMatrixViewT<T> gamma, ConstMatrixViewT<T> beta,
+                                                 double epsilon = 1e-5, int axis = 1);
+    template <typename T> void sigmoid_inplace(MatrixViewT<T> x);
+    template <typename T> void tanh_inplace(MatrixViewT<T> x);
+    template <typename T> void leakyRelu_inplace(MatrixViewT<T> x, double alpha = 0.01);
+    template <typename T> void clip_inplace(MatrixViewT<T> x, double min_val, double max_val);
 }
 
 #endif //ACTIVATION_FUNCTIONS_H
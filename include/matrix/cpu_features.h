@@ -0,0 +1,92 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+// Runtime instruction-set selection for the compute kernels.
+//
+// The GEMM engine (gemm.h), the int8 and 2:4 sparse micro-tiles (quantized.h,
+// sparse.h), the transcendental kernels (vector_math.h), the reductions
+// (reduction.h), the Philox generator (random.h) and the bulk bf16/fp16
+// conversions (half.h) are compiled once per ISA level in their own
+// translation unit: src/matrix/isa_variants.inl includes the module's kernel
+// source into one namespace per level, each under matching
+// #pragma GCC target options. Every public entry point then forwards to the
+// copy of the level chosen at startup, so a binary built without
+// -march=native runs on any x86-64 and still uses AVX-512 where the CPU has
+// it.
+//
+//   Generic  the compiler's baseline flags (SSE2 on x86-64, scalar kernels)
+//   Sse42    SSE4.2 + POPCNT, 128-bit auto-vectorized scalar kernels (SSSE3
+//            and SSE4.1 intrinsics for int8, 2:4 and Philox)
+//   Avx2     AVX2 + FMA + F16C, 256-bit intrinsic kernels
+//   Avx512   AVX-512 F/BW/DQ/VL, 512-bit intrinsic kernels
+//
+// The level is the best one cpuid reports (with the OS saving the wider
+// register state), capped by VIT_ISA=generic|sse4.2|avx2|avx512 when set.
+// The int8 kernels add an AVX-512 VNNI copy, used on Avx512 when
+// has_avx512_vnni().
+//
+// Compilers without #pragma GCC target (clang, MSVC) and other architectures
+// build a single copy at the level the compile flags enable (VIT_NATIVE_ISA:
+// -march=native still gets the AVX-512 kernels). That level is then the only
+// one: detected_isa() reports it and set_isa() and VIT_ISA cannot change it.
+namespace CpuFeatures {
+    enum class Isa { Generic, Sse42, Avx2, Avx512 };
+
+    // Level the dispatched kernels run at
+    Isa active_isa();
+    // Best level this CPU supports (the compiled level without VIT_MULTI_ISA)
+    Isa detected_isa();
+    // Switches the dispatched kernels to isa, capped at detected_isa(); meant
+    // for tests and benchmarks, not for use while kernels are running.
+    // Returns the level actually selected.
+    Isa set_isa(Isa isa);
+    // Whether the CPU has AVX-512 VNNI (vpdpbusd); not part of any level,
+    // the int8 kernels add it on top of Avx512
+    bool has_avx512_vnni();
+
+    const char* isa_name(Isa isa);
+}
+
+// Numeric levels for the #if blocks of the per-ISA kernel sources
+#define VIT_ISA_GENERIC 0
+#define VIT_ISA_SSE42 1
+#define VIT_ISA_AVX2 2
+#define VIT_ISA_AVX512 3
+
+#ifndef VIT_MULTI_ISA
+#if defined(__GNUC__) && !defined(__clang__) && (defined(__x86_64__) || defined(__i386__))
+#define VIT_MULTI_ISA 1
+#else
+#define VIT_MULTI_ISA 0
+#endif
+#endif
+
+// Level of the compile flags, the one the single copy of a build without
+// VIT_MULTI_ISA is compiled at
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+#define VIT_NATIVE_ISA VIT_ISA_AVX512
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+#define VIT_NATIVE_ISA VIT_ISA_AVX2
+#elif defined(__SSE4_2__) && defined(__POPCNT__)
+#define VIT_NATIVE_ISA VIT_ISA_SSE42
+#else
+#define VIT_NATIVE_ISA VIT_ISA_GENERIC
+#endif
+
+// Whether the kernel sources need <immintrin.h>
+#define VIT_ISA_INTRINSICS (VIT_MULTI_ISA || VIT_NATIVE_ISA > VIT_ISA_GENERIC)
+
+// Returns the given call made in the namespace of the active ISA copy
+#if VIT_MULTI_ISA
+#define VIT_ISA_DISPATCH(...) \
+    switch (CpuFeatures::active_isa()) { \
+        case CpuFeatures::Isa::Avx512: return avx512::__VA_ARGS__; \
+        case CpuFeatures::Isa::Avx2: return avx2::__VA_ARGS__; \
+        case CpuFeatures::Isa::Sse42: return sse42::__VA_ARGS__; \
+        default: return generic::__VA_ARGS__; \
+    }
+#else
+#define VIT_ISA_DISPATCH(...) return generic::__VA_ARGS__
+#endif
+
+#endif //CPU_FEATURES_H
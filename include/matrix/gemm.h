@@ -0,0 +1,107 @@
+
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <cstddef>
+#include "precision.h"
+#include "half.h"
+
+// Packed-panel GEMM engine (BLIS/GotoBLAS structure).
+//
+//   C = alpha * op(A) * op(B) + beta * C
+//
+// The k dimension is split into KC-deep slabs (packed B panel sits in L2/L3),
+// M into MC-row blocks (packed A block sits in L2) and N into NC-column
+// blocks. Packed A micro-panels are MR rows wide and packed B micro-panels
+// NR columns wide; the micro-kernel keeps an MR x NR tile of C in registers
+// and streams both panels with broadcast + FMA. Operands are described by
+// element strides, so row-major, column-major (transposed) and strided views
+// are all packed directly from their stored layout.
+//
+// Instantiated for float and double; each type has its own micro-kernel
+// (float tiles are twice as wide for the same register footprint). The
+// engine is compiled for every ISA level and the one matching the CPU is
+// picked at startup (cpu_features.h), so blocking and kernel follow it.
+//
+// An epilogue folds the element-wise work that usually follows a linear
+// layer into the write-back of C:
+//
+//   C = act(alpha * op(A) * op(B) + beta * C + bias) + residual
+//
+// It runs over each MC x NC block of C once the last KC slab has written
+// it, so callers need no separate passes. In the benchmark (tests/08) it
+// costs about the same as those passes: C is still in cache either way.
+namespace Gemm {
+
+    enum class Activation { None, Gelu };
+
+    template <typename T>
+    struct Epilogue {
+        const T* bias = nullptr;                    // n values, one per column of C
+        Activation activation = Activation::None;   // Tanh-approximated GELU (see vector_math.h)
+        const T* residual = nullptr;                // m x n, added after the activation; must not overlap C
+        size_t residual_ld = 0;                     // Leading dimension of residual
+
+        bool empty() const { return !bias && activation == Activation::None && !residual; }
+        // The same epilogue for the block of C starting at (i, j)
+        Epilogue at(size_t i, size_t j) const {
+            Epilogue block = *this;
+            block.bias = bias ? bias + j : nullptr;
+            block.residual = residual ? residual + i * residual_ld + j : nullptr;
+            return block;
+        }
+    };
+
+    // Applies epilogue to a rows x cols block of C (row-major, leading
+    // dimension ldc) whose top-left element is the epilogue's origin
+    template <typename T>
+    void apply_epilogue(const Epilogue<T>& epilogue, size_t rows, size_t cols, T* c, size_t ldc);
+
+    struct BlockSizes {
+        size_t mr;  // Micro-tile rows (register block)
+        size_t nr;  // Micro-tile columns (register block)
+        size_t mc;  // Rows of A packed per L2 block
+        size_t kc;  // Depth of each packed slab
+        size_t nc;  // Columns of B packed per L3 block
+    };
+
+    // Blocking of the micro-kernel in use
+    template <typename T = Scalar>
+    const BlockSizes& block_sizes();
+    template <typename T = Scalar>
+    const char* kernel_name();
+
+    // Element (i, j) of A is a[i * a_row_stride + j * a_col_stride], likewise
+    // for B. C is row-major with leading dimension ldc. When beta == 0, C is
+    // not read (so it may hold garbage or NaN).
+    // B is stored as S: either T itself or bf16/fp16, which is widened to T
+    // while B is packed so the micro-kernel still accumulates in T.
+    template <typename T, typename S>
+    void gemm(size_t m, size_t n, size_t k, T alpha,
+              const T* a, size_t a_row_stride, size_t a_col_stride,
+              const S* b, size_t b_row_stride, size_t b_col_stride,
+              T beta, T* c, size_t ldc, const Epilogue<T>& epilogue = Epilogue<T>());
+
+    // Batched products sharing one shape and one set of strides:
+    //   C_p = alpha * op(A_p) * op(B_p) + beta * C_p,  p < batch
+    // Problems too small to fill the micro-kernel's register tile (e.g.
+    // 17 x 16 attention heads) are computed SIMD-width at a time, one problem
+    // per vector lane, from lane-interleaved copies of A and B; larger ones
+    // run the packed gemm per problem. Problems are spread over the thread
+    // pool. The C_p must not overlap.
+    //
+    // Strided batch: A_p = a + p * a_batch_stride, likewise for B and C
+    template <typename T>
+    void gemm_strided_batched(size_t batch, size_t m, size_t n, size_t k, T alpha,
+                              const T* a, size_t a_row_stride, size_t a_col_stride, size_t a_batch_stride,
+                              const T* b, size_t b_row_stride, size_t b_col_stride, size_t b_batch_stride,
+                              T beta, T* c, size_t ldc, size_t c_batch_stride);
+    // Pointer batch: A_p = a[p], likewise for B and C
+    template <typename T>
+    void gemm_batched(size_t batch, size_t m, size_t n, size_t k, T alpha,
+                      const T* const* a, size_t a_row_stride, size_t a_col_stride,
+                      const T* const* b, size_t b_row_stride, size_t b_col_stride,
+                      T beta, T* const* c, size_t ldc);
+}
+
+#endif //GEMM_H
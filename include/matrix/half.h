@@ -0,0 +1,73 @@
+
+#ifndef HALF_H
+#define HALF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "matrix_view.h"
+
+// 16-bit storage formats. Values are only stored in these formats; every
+// computation widens them to fp32 first (GEMM packing, LayerNorm inputs), so
+// accumulation never happens in 16 bits.
+struct bf16 { uint16_t bits; };     // 1 sign, 8 exponent, 7 mantissa bits
+struct fp16 { uint16_t bits; };     // IEEE binary16: 1 sign, 5 exponent, 10 mantissa bits
+
+// Int8 applies to layer weights only (see quantized.h); HalfMatrix holds the
+// two 16-bit formats
+enum class StorageType { Float32, BFloat16, Float16, Int8 };
+
+namespace HalfPrecision {
+    // Scalar conversions; narrowing rounds to nearest even and keeps NaN a NaN
+    float to_float(bf16 value);
+    float to_float(fp16 value);
+    bf16 to_bf16(float value);
+    fp16 to_fp16(float value);
+
+    // Bulk conversions: AVX-512 (AVX512-BF16 when also compiled in) or
+    // AVX2 + F16C as picked at startup (cpu_features.h), scalar loops
+    // otherwise. Results match the scalar versions bit for bit, except that
+    // the AVX512-BF16 path flushes fp32 subnormals to zero.
+    void to_float(const bf16* src, float* dst, size_t count);
+    void to_float(const fp16* src, float* dst, size_t count);
+    void from_float(const float* src, bf16* dst, size_t count);
+    void from_float(const float* src, fp16* dst, size_t count);
+
+    // Describes the bulk conversion kernels in use
+    const char* kernel_name();
+}
+
+// Row-major matrix stored in bf16 or fp16 (e.g. a reduced-precision copy of
+// a weight matrix or of the activations between transformer blocks).
+// Convert with assign() and widen back with to_matrix().
+class HalfMatrix {
+private:
+    StorageType type;
+    size_t rows;
+    size_t cols;
+    std::vector<uint16_t> buffer;
+
+public:
+    HalfMatrix();
+    template <typename T>
+    HalfMatrix(ConstMatrixViewT<T> source, StorageType type);
+
+    // Rounds source into this matrix (type must be BFloat16 or Float16)
+    template <typename T>
+    void assign(ConstMatrixViewT<T> source, StorageType type);
+    // Widens every element into dst (same shape)
+    void to_matrix(MatrixViewT<float> dst) const;
+    void to_matrix(MatrixViewT<double> dst) const;
+    void clear();
+
+    StorageType getType() const { return type; }
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    bool empty() const { return buffer.empty(); }
+
+    // Typed storage access; valid only for the matching storage type
+    const bf16* bf16_data() const { return reinterpret_cast<const bf16*>(buffer.data()); }
+    const fp16* fp16_data() const { return reinterpret_cast<const fp16*>(buffer.data()); }
+};
+
+#endif //HALF_H
@@ -1,4 +1,5 @@
 
+
 #ifndef MATRIX_H
 #define MATRIX_H
 
@@ -6,66 +7,154 @@
 #include <iostream>
 #include <stdexcept>
 #include <initializer_list>
-
-class Matrix {
+#include <utility>
+#include "matrix_view.h"
+#include "matrix_expr.h"
+
+// Row-major matrix backed by a single 64-byte aligned buffer (on huge pages
+// when large, see memory.h).
+// operator() is unchecked and meant for hot loops; use at() when the
+// indices come from outside and should be validated.
+//
+// A matrix is itself a (contiguous) ConstMatrixViewT, so it binds directly to
+// the view parameters of the templated kernels and T is deduced from it.
+template <typename T>
+class MatrixT : public ConstMatrixViewT<T> {
 private:
-    std::vector<std::vector<double>> data;
-    size_t rows;
-    size_t cols;
+    using Base = ConstMatrixViewT<T>;
+    using Base::ptr;
+    using Base::rows;
+    using Base::cols;
+    using Base::stride;
+
+    size_t capacity;        // Allocated elements (>= rows * cols)
+
+    T* buffer() const { return const_cast<T*>(ptr); }
+    void set_shape(size_t new_rows, size_t new_cols) {
+        rows = new_rows;
+        cols = new_cols;
+        stride = new_cols;
+    }
+    void allocate(size_t count);
+    void release();
 
 public:
+    using value_type = T;
+
+    // Alignment (in bytes) of every buffer and of row 0
+    static constexpr size_t ALIGNMENT = 64;
+
     // Constructors
-    Matrix();
-    Matrix(size_t rows, size_t cols, double value = 0.0);
-    Matrix(const std::initializer_list<std::initializer_list<double>>& init_list);
+    MatrixT();
+    MatrixT(size_t rows, size_t cols, T value = T(0));
+    MatrixT(const std::initializer_list<std::initializer_list<T>>& init_list);
+    explicit MatrixT(const ConstMatrixViewT<T>& view);  // Deep copy of a view
+
+    // Materializes a lazy element-wise expression (see matrix_expr.h)
+    template <typename E>
+    MatrixT(const MatrixExpr<E>& expr) : capacity(0) {
+        static_assert(std::is_same<typename E::value_type, T>::value, "Expression element type must match");
+        set_shape(expr.self().getRows(), expr.self().getCols());
+        allocate(rows * cols);
+        evaluate_into(view(), expr);
+    }
+    template <typename E>
+    MatrixT& operator=(const MatrixExpr<E>& expr) {
+        if (expr.self().getRows() != rows || expr.self().getCols() != cols) {
+            // The operands may live in this buffer, so never reshape under them
+            MatrixT result(expr);
+            return *this = std::move(result);
+        }
+        evaluate_into(view(), expr);
+        return *this;
+    }
 
     // Copy constructor and assignment
-    Matrix(const Matrix& other);
-    Matrix& operator=(const Matrix& other);
+    MatrixT(const MatrixT& other);
+    MatrixT& operator=(const MatrixT& other);
 
     // Move constructor and assignment
-    Matrix(Matrix&& other) noexcept;
-    Matrix& operator=(Matrix&& other) noexcept;
+    MatrixT(MatrixT&& other) noexcept;
+    MatrixT& operator=(MatrixT&& other) noexcept;
 
     // Destructor
-    ~Matrix() = default;
+    ~MatrixT();
+
+    // Element access (unchecked)
+    T& operator()(size_t row, size_t col) { return buffer()[row * cols + col]; }
+    const T& operator()(size_t row, size_t col) const { return ptr[row * cols + col]; }
 
-    // Element access
-    double& operator()(size_t row, size_t col);
-    const double& operator()(size_t row, size_t col) const;
+    // Element access (bounds-checked, throws std::out_of_range)
+    T& at(size_t row, size_t col);
+    const T& at(size_t row, size_t col) const;
 
-    // Dimensions
-    size_t getRows() const { return rows; }
-    size_t getCols() const { return cols; }
+    // Raw storage access
+    T* data() { return buffer(); }
+    const T* data() const { return ptr; }
+    T* row_ptr(size_t row) { return buffer() + row * cols; }
+    const T* row_ptr(size_t row) const { return ptr + row * cols; }
+
+    // Dimensions (getRows, getCols, getStride and size come from the view)
     std::pair<size_t, size_t> shape() const { return {rows, cols}; }
 
+    // Non-owning views (invalidated by resize or reassignment)
+    MatrixViewT<T> view() { return MatrixViewT<T>(buffer(), rows, cols); }
+    ConstMatrixViewT<T> view() const { return ConstMatrixViewT<T>(ptr, rows, cols); }
+    operator MatrixViewT<T>() { return view(); }
+    MatrixViewT<T> block(size_t row, size_t col, size_t num_rows, size_t num_cols) {
+        return view().block(row, col, num_rows, num_cols);
+    }
+    ConstMatrixViewT<T> block(size_t row, size_t col, size_t num_rows, size_t num_cols) const {
+        return view().block(row, col, num_rows, num_cols);
+    }
+    MatrixViewT<T> row_range(size_t row, size_t num_rows) { return view().row_range(row, num_rows); }
+    ConstMatrixViewT<T> row_range(size_t row, size_t num_rows) const { return view().row_range(row, num_rows); }
+    MatrixViewT<T> col_range(size_t col, size_t num_cols) { return view().col_range(col, num_cols); }
+    ConstMatrixViewT<T> col_range(size_t col, size_t num_cols) const { return view().col_range(col, num_cols); }
+
     // Utility functions
-    void fill(double value);
-    void resize(size_t new_rows, size_t new_cols, double value = 0.0);
+    void fill(T value);
+    void resize(size_t new_rows, size_t new_cols, T value = T(0));
+    // Like resize but leaves the contents unspecified (for output buffers
+    // that are about to be overwritten); allocates only when growing
+    void resize_uninitialized(size_t new_rows, size_t new_cols);
+    void reshape(size_t new_rows, size_t new_cols);     // Same elements, new shape
 
     // Display
     void print() const;
 
     // Static factory methods
-    static Matrix zeros(size_t rows, size_t cols);
-    static Matrix ones(size_t rows, size_t cols);
-    static Matrix identity(size_t size);
-    static Matrix random(size_t rows, size_t cols, double min = 0.0, double max = 1.0);
-
-    // Basic operators
-    Matrix operator+(const Matrix& other) const;
-    Matrix operator-(const Matrix& other) const;
-    Matrix operator*(double scalar) const;
-    Matrix operator/(double scalar) const;
-
-    // Comparison
-    bool operator==(const Matrix& other) const;
-    bool operator!=(const Matrix& other) const;
-
-    // Friends for scalar operations
-    friend Matrix operator*(double scalar, const Matrix& matrix);
-    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix);
+    static MatrixT zeros(size_t rows, size_t cols);
+    static MatrixT ones(size_t rows, size_t cols);
+    static MatrixT identity(size_t size);
+    static MatrixT random(size_t rows, size_t cols, double min = 0.0, double max = 1.0);
+
+    // Arithmetic operators (+ - * /) live in matrix_expr.h; lazy() fuses them
+
+    // Compound assignment (in place, no allocation); other may be any view
+    // or a lazy expression
+    MatrixT& operator+=(const ConstMatrixViewT<T>& other);
+    MatrixT& operator-=(const ConstMatrixViewT<T>& other);
+    MatrixT& operator*=(T scalar);
+    template <typename E>
+    MatrixT& operator+=(const MatrixExpr<E>& expr) { return *this = *this + expr.self(); }
+    template <typename E>
+    MatrixT& operator-=(const MatrixExpr<E>& expr) { return *this = *this - expr.self(); }
+
+    // Comparison: same shape and every element within a small absolute
+    // tolerance (1e-9 for double, 1e-5 for float)
+    bool operator==(const MatrixT& other) const;
+    bool operator!=(const MatrixT& other) const;
 };
 
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const MatrixT<T>& matrix);
+
+// Element type used by the ViT stack (see precision.h)
+using Matrix = MatrixT<Scalar>;
+
+extern template class MatrixT<float>;
+extern template class MatrixT<double>;
+
 
 #endif //MATRIX_H
@@ -0,0 +1,233 @@
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "matrix_view.h"
+
+// Fused element-wise arithmetic.
+//
+// `+` and `-` between two operands of equal shape and `+ - * /` with a scalar
+// work on matrices and views and return a new Matrix, as before. Wrapping an
+// operand in lazy() makes the same operators build expression nodes
+// instead. The whole tree is then evaluated in one fused loop when it is
+// assigned to a Matrix (or passed to evaluate_into), so
+// `(lazy(x) - mean) / std` or `lazy(a) + b * s` costs a single pass over
+// memory and at most one allocation.
+//
+// Nodes keep their sub-expressions by value but reference their matrix
+// operands, so a lazy expression must not outlive the matrices it reads;
+// evaluate it in the statement that builds it.
+
+template <typename T>
+class MatrixT;
+
+// CRTP base of every expression node
+template <typename E>
+class MatrixExpr {
+public:
+    const E& self() const { return static_cast<const E&>(*this); }
+};
+
+namespace MatrixExpressions {
+
+struct Add { template <typename T> static T apply(T a, T b) { return a + b; } };
+struct Sub { template <typename T> static T apply(T a, T b) { return a - b; } };
+struct Mul { template <typename T> static T apply(T a, T b) { return a * b; } };
+struct Div { template <typename T> static T apply(T a, T b) { return a / b; } };
+
+// Leaf: a (possibly strided) matrix or view
+template <typename T>
+class Leaf : public MatrixExpr<Leaf<T>> {
+    ConstMatrixViewT<T> view;
+
+public:
+    using value_type = T;
+    struct Row {
+        const T* p;
+        T operator[](size_t j) const { return p[j]; }
+    };
+
+    explicit Leaf(ConstMatrixViewT<T> view) : view(view) {}
+    size_t getRows() const { return view.getRows(); }
+    size_t getCols() const { return view.getCols(); }
+    Row row(size_t i) const { return {view.row_ptr(i)}; }
+};
+
+// Element-wise l op r
+template <typename Op, typename L, typename R>
+class Binary : public MatrixExpr<Binary<Op, L, R>> {
+    L l;
+    R r;
+
+public:
+    using value_type = typename L::value_type;
+    struct Row {
+        typename L::Row l;
+        typename R::Row r;
+        value_type operator[](size_t j) const { return Op::apply(l[j], r[j]); }
+    };
+
+    Binary(const L& l, const R& r, const char* message) : l(l), r(r) {
+        if (l.getRows() != r.getRows() || l.getCols() != r.getCols()) {
+            throw std::invalid_argument(message);
+        }
+    }
+    size_t getRows() const { return l.getRows(); }
+    size_t getCols() const { return l.getCols(); }
+    Row row(size_t i) const { return {l.row(i), r.row(i)}; }
+};
+
+// e op s (or s op e when ScalarLeft)
+template <typename Op, typename E, bool ScalarLeft>
+class WithScalar : public MatrixExpr<WithScalar<Op, E, ScalarLeft>> {
+    using T = typename E::value_type;
+    E e;
+    T s;
+
+public:
+    using value_type = T;
+    struct Row {
+        typename E::Row e;
+        T s;
+        T operator[](size_t j) const { return ScalarLeft ? Op::apply(s, e[j]) : Op::apply(e[j], s); }
+    };
+
+    WithScalar(const E& e, T s) : e(e), s(s) {}
+    size_t getRows() const { return e.getRows(); }
+    size_t getCols() const { return e.getCols(); }
+    Row row(size_t i) const { return {e.row(i), s}; }
+};
+
+// Matrices, views and expression nodes can appear in an expression
+template <typename A, typename = void>
+struct IsOperand : std::false_type {};
+template <typename A>
+struct IsOperand<A, std::void_t<typename A::value_type>>
+    : std::integral_constant<bool, std::is_base_of<ConstMatrixViewT<typename A::value_type>, A>::value ||
+                                   std::is_base_of<MatrixExpr<A>, A>::value> {};
+
+template <typename A>
+using IsExpr = std::is_base_of<MatrixExpr<A>, A>;
+
+template <typename A>
+auto as_expr(const A& a) {
+    if constexpr (IsExpr<A>::value) {
+        return a;
+    } else {
+        return Leaf<typename A::value_type>(a);
+    }
+}
+
+// The node itself when an operand is already lazy, else the evaluated Matrix
+template <bool Lazy, typename E>
+auto finish(const E& e) {
+    if constexpr (Lazy) {
+        return e;
+    } else {
+        return MatrixT<typename E::value_type>(e);
+    }
+}
+
+template <typename A, typename B>
+using EnableMatrixMatrix = std::enable_if_t<IsOperand<A>::value && IsOperand<B>::value &&
+                                            std::is_same<typename A::value_type, typename B::value_type>::value>;
+template <typename A, typename S>
+using EnableMatrixScalar = std::enable_if_t<IsOperand<A>::value && std::is_arithmetic<S>::value>;
+
+} // namespace MatrixExpressions
+
+// Evaluates expr into out (same shape) in a single pass. out may be one of
+// the expression's operands but must not partially overlap one.
+template <typename E>
+void evaluate_into(MatrixViewT<typename E::value_type> out, const MatrixExpr<E>& expr) {
+    const E& e = expr.self();
+    if (out.getRows() != e.getRows() || out.getCols() != e.getCols()) {
+        throw std::invalid_argument("Output dimensions must match the expression");
+    }
+
+    const size_t cols = e.getCols();
+    for (size_t i = 0; i < e.getRows(); ++i) {
+        const typename E::Row row = e.row(i);
+        typename E::value_type* dst = out.row_ptr(i);
+        // Each element only depends on the operands' element at the same index
+#pragma GCC ivdep
+        for (size_t j = 0; j < cols; ++j) {
+            dst[j] = row[j];
+        }
+    }
+}
+
+// Leaf node of a matrix or view, the entry point of a fused expression. A
+// temporary Matrix would be gone before the expression is evaluated.
+template <typename T>
+MatrixExpressions::Leaf<T> lazy(const ConstMatrixViewT<T>& a) {
+    return MatrixExpressions::Leaf<T>(a);
+}
+template <typename T>
+void lazy(MatrixT<T>&&) = delete;
+
+template <typename A, typename B, typename = MatrixExpressions::EnableMatrixMatrix<A, B>>
+auto operator+(const A& a, const B& b) {
+    using namespace MatrixExpressions;
+    using Node = Binary<Add, decltype(as_expr(a)), decltype(as_expr(b))>;
+    return finish<IsExpr<A>::value || IsExpr<B>::value>(
+        Node(as_expr(a), as_expr(b), "Matrices must have the same dimensions for addition"));
+}
+
+template <typename A, typename B, typename = MatrixExpressions::EnableMatrixMatrix<A, B>>
+auto operator-(const A& a, const B& b) {
+    using namespace MatrixExpressions;
+    using Node = Binary<Sub, decltype(as_expr(a)), decltype(as_expr(b))>;
+    return finish<IsExpr<A>::value || IsExpr<B>::value>(
+        Node(as_expr(a), as_expr(b), "Matrices must have the same dimensions for subtraction"));
+}
+
+template <typename A, typename S, typename = MatrixExpressions::EnableMatrixScalar<A, S>>
+auto operator+(const A& a, S s) {
+    using namespace MatrixExpressions;
+    using Node = WithScalar<Add, decltype(as_expr(a)), false>;
+    return finish<IsExpr<A>::value>(Node(as_expr(a), static_cast<typename A::value_type>(s)));
+}
+
+template <typename A, typename S, typename = MatrixExpressions::EnableMatrixScalar<A, S>>
+auto operator-(const A& a, S s) {
+    using namespace MatrixExpressions;
+    using Node = WithScalar<Sub, decltype(as_expr(a)), false>;
+    return finish<IsExpr<A>::value>(Node(as_expr(a), static_cast<typename A::value_type>(s)));
+}
+
+template <typename A, typename S, typename = MatrixExpressions::EnableMatrixScalar<A, S>>
+auto operator-(S s, const A& a) {
+    using namespace MatrixExpressions;
+    using Node = WithScalar<Sub, decltype(as_expr(a)), true>;
+    return finish<IsExpr<A>::value>(Node(as_expr(a), static_cast<typename A::value_type>(s)));
+}
+
+template <typename A, typename S, typename = MatrixExpressions::EnableMatrixScalar<A, S>>
+auto operator*(const A& a, S s) {
+    using namespace MatrixExpressions;
+    using Node = WithScalar<Mul, decltype(as_expr(a)), false>;
+    return finish<IsExpr<A>::value>(Node(as_expr(a), static_cast<typename A::value_type>(s)));
+}
+
+template <typename A, typename S, typename = MatrixExpressions::EnableMatrixScalar<A, S>>
+auto operator*(S s, const A& a) {
+    return a * s;
+}
+
+// Divides every element (not a multiply by 1 / s, which can differ by an
+// ulp from the eager MatrixOps division)
+template <typename A, typename S, typename = MatrixExpressions::EnableMatrixScalar<A, S>>
+auto operator/(const A& a, S s) {
+    using namespace MatrixExpressions;
+    using T = typename A::value_type;
+    if (static_cast<T>(s) == T(0)) {
+        throw std::invalid_argument("Division by zero");
+    }
+    using Node = WithScalar<Div, decltype(as_expr(a)), false>;
+    return finish<IsExpr<A>::value>(Node(as_expr(a), static_cast<T>(s)));
+}
+
+#endif //MATRIX_EXPR_H
@@ -4,40 +4,148 @@
 #define MATRIX_OPS_H
 
 #include "matrix.h"
+#include "matrix_view.h"
+#include "half.h"
+#include "gemm.h"
+#include <vector>
 
+// All kernels take ConstMatrixViewT operands, so they accept a Matrix as well
+// as any strided row/column range or block of one without copying. They are
+// templated on the element type (float and double are instantiated in
+// matrix_ops.cpp); T is deduced from the inputs.
 namespace MatrixOps {
     // Matrix multiplication
-    Matrix matmul(const Matrix& a, const Matrix& b);
+    template <typename T> MatrixT<T> matmul(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void matmul_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);  // out = a * b
+    // c = alpha * a * b + beta * c (packed, cache-blocked GEMM; see gemm.h)
+    template <typename T> void gemm(double alpha, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b, double beta, OutputViewT<T> c);
+    // c = alpha * op(a) * op(b) + beta * c, where op(x) = x^T when the flag is set.
+    // Transposed operands are packed from their stored layout, never materialized.
+    // An epilogue (bias, activation, residual) is applied to each tile of c as
+    // the GEMM writes it, see gemm.h and make_epilogue below.
+    template <typename T> void gemm(double alpha, ConstMatrixViewT<T> a, bool transpose_a,
+                                    ConstMatrixViewT<T> b, bool transpose_b, double beta, OutputViewT<T> c,
+                                    const Gemm::Epilogue<T>& epilogue = Gemm::Epilogue<T>());
+
+    // Epilogue for a linear layer: c + bias (a 1 x n row), then activation,
+    // then + residual (c's shape, must not overlap c; accumulate into c with
+    // beta = 1 instead). Empty views are skipped. The views must outlive the
+    // gemm call.
+    template <typename T> Gemm::Epilogue<T> make_epilogue(ConstMatrixViewT<T> bias,
+                                                          Gemm::Activation activation = Gemm::Activation::None,
+                                                          ConstMatrixViewT<T> residual = ConstMatrixViewT<T>());
+    // The same epilogue as a separate pass over a product that is already in
+    // c (e.g. from the int8 or 2:4 sparse kernels)
+    template <typename T> void apply_epilogue(OutputViewT<T> c, const Gemm::Epilogue<T>& epilogue);
+
+    // Batched products c[p] = alpha * op(a[p]) * op(b[p]) + beta * c[p], p < batch,
+    // for many small problems of one shape (e.g. every attention head of every
+    // sample). All a[p] share one shape and stride, likewise b[p] and c[p];
+    // the c[p] must not overlap. See Gemm::gemm_batched for the scheduling.
+    template <typename T> void batched_gemm(double alpha, const ConstMatrixViewT<T>* a, bool transpose_a,
+                                            const ConstMatrixViewT<T>* b, bool transpose_b, double beta,
+                                            const MatrixViewT<T>* c, size_t batch);
+    // Strided batch: problem p is a, b and c advanced by p times their batch
+    // stride (in elements), e.g. head p's column slice at offset p * head_dim
+    template <typename T> void batched_gemm(double alpha, ConstMatrixViewT<T> a, size_t a_batch_stride, bool transpose_a,
+                                            ConstMatrixViewT<T> b, size_t b_batch_stride, bool transpose_b, double beta,
+                                            OutputViewT<T> c, size_t c_batch_stride, size_t batch);
+    template <typename T> void batched_matmul_into(const MatrixViewT<T>* out, const ConstMatrixViewT<T>* a,
+                                                   const ConstMatrixViewT<T>* b, size_t batch);  // out[p] = a[p] * b[p]
+
+    // Same products with a bf16/fp16 right operand (e.g. 16-bit weights); b is
+    // widened to T while packed, so accumulation stays in T
+    template <typename T> void gemm(double alpha, ConstMatrixViewT<T> a, bool transpose_a,
+                                    const HalfMatrix& b, bool transpose_b, double beta, OutputViewT<T> c,
+                                    const Gemm::Epilogue<T>& epilogue = Gemm::Epilogue<T>());
+    template <typename T> MatrixT<T> matmul(ConstMatrixViewT<T> a, const HalfMatrix& b);
+    template <typename T> void matmul_into(OutputViewT<T> out, ConstMatrixViewT<T> a, const HalfMatrix& b);
+    template <typename T> MatrixT<T> matmul_nt(ConstMatrixViewT<T> a, const HalfMatrix& b);
+
+    // Transposed-operand products: nt = a * b^T, tn = a^T * b, tt = a^T * b^T
+    template <typename T> MatrixT<T> matmul_nt(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> MatrixT<T> matmul_tn(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> MatrixT<T> matmul_tt(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+
+    // Copy between views of equal shape
+    template <typename T> void copy(OutputViewT<T> dst, ConstMatrixViewT<T> src);
 
     // Element-wise operations
-    Matrix add(const Matrix& a, const Matrix& b);          // transformer block
-    Matrix subtract(const Matrix& a, const Matrix& b);     // transformer block
-    Matrix elementWiseMultiply(const Matrix& a, const Matrix& b);
-    Matrix elementWiseDivide(const Matrix& a, const Matrix& b);
+    template <typename T> MatrixT<T> add(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);          // transformer block
+    template <typename T> MatrixT<T> subtract(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);     // transformer block
+    template <typename T> MatrixT<T> elementWiseMultiply(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> MatrixT<T> elementWiseDivide(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
 
     // Matrix operations
-    Matrix transpose(const Matrix& matrix);
+    template <typename T> MatrixT<T> transpose(ConstMatrixViewT<T> matrix);
 
     // Broadcasting operations
-    Matrix addBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector = true);
-    Matrix multiplyBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector = true);
+    template <typename T> MatrixT<T> addBroadcast(ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector = true);
+    template <typename T> MatrixT<T> multiplyBroadcast(ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector = true);
 
-    // Reduction operations
-    double sum(const Matrix& matrix);
-    double mean(const Matrix& matrix);
-    Matrix sumAxis(const Matrix& matrix, int axis); // axis 0: sum columns, axis 1: sum rows
-    Matrix meanAxis(const Matrix& matrix, int axis);
+    // Reduction operations. Axis 0 reduces down each column (1 x cols result),
+    // axis 1 along each row (rows x 1). Rows are summed pairwise with SIMD
+    // partial sums (see reduction.h), columns in plain runs of rows folded in
+    // with Kahan compensation while the rows stream by; tall matrices are split into
+    // fixed row blocks across threads and combined in order, so results do
+    // not depend on the number of threads. Variances are population
+    // variances (divided by n): two-pass along rows, one-pass Welford down
+    // columns. max skips NaN; argmax returns the first index of the max.
+    template <typename T> T sum(ConstMatrixViewT<T> matrix);
+    template <typename T> T mean(ConstMatrixViewT<T> matrix);
+    template <typename T> MatrixT<T> sumAxis(ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> MatrixT<T> meanAxis(ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> MatrixT<T> varAxis(ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> MatrixT<T> maxAxis(ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> std::vector<size_t> argmaxAxis(ConstMatrixViewT<T> matrix, int axis);
 
     // Utility functions
-    Matrix power(const Matrix& matrix, double exponent);
-    Matrix sqrt(const Matrix& matrix);
-    Matrix exp(const Matrix& matrix);
-    Matrix log(const Matrix& matrix);
+    template <typename T> MatrixT<T> power(ConstMatrixViewT<T> matrix, double exponent);
+    template <typename T> MatrixT<T> sqrt(ConstMatrixViewT<T> matrix);
+    template <typename T> MatrixT<T> exp(ConstMatrixViewT<T> matrix);
+    template <typename T> MatrixT<T> log(ConstMatrixViewT<T> matrix);
+
+    // Output-parameter variants: out must already have the result's shape and
+    // is overwritten, nothing is allocated. Except for transpose_into, out may
+    // be one of the inputs itself (but not a partially overlapping view).
+    template <typename T> void add_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void subtract_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void elementWiseMultiply_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void elementWiseDivide_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void transpose_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix);
+    template <typename T> void addBroadcast_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector = true);
+    template <typename T> void multiplyBroadcast_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector = true);
+    template <typename T> void sumAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> void meanAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> void varAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis);
+    // Mean and variance in one pass over matrix
+    template <typename T> void meanVarAxis_into(OutputViewT<T> mean, OutputViewT<T> variance,
+                                                ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> void maxAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis);
+    // out holds cols (axis 0) or rows (axis 1) indices
+    template <typename T> void argmaxAxis_into(size_t* out, ConstMatrixViewT<T> matrix, int axis);
+    template <typename T> void power_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, double exponent);
+    template <typename T> void sqrt_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix);
+    template <typename T> void exp_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix);
+    template <typename T> void log_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix);
+
+    // In-place variants (a op= b). Unary ones take a view so T is deduced;
+    // pass matrix.view() for a Matrix.
+    template <typename T> void add_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void subtract_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void elementWiseMultiply_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void elementWiseDivide_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b);
+    template <typename T> void addBroadcast_inplace(OutputViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector = true);
+    template <typename T> void multiplyBroadcast_inplace(OutputViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector = true);
+    template <typename T> void power_inplace(MatrixViewT<T> matrix, double exponent);
+    template <typename T> void sqrt_inplace(MatrixViewT<T> matrix);
+    template <typename T> void exp_inplace(MatrixViewT<T> matrix);
+    template <typename T> void log_inplace(MatrixViewT<T> matrix);
 
     // Matrix properties
-    double trace(const Matrix& matrix);
-    double determinant(const Matrix& matrix); // For small matrices
-    Matrix inverse(const Matrix& matrix); // For small matrices
+    template <typename T> T trace(ConstMatrixViewT<T> matrix);
+    template <typename T> T determinant(ConstMatrixViewT<T> matrix); // For small matrices
+    template <typename T> MatrixT<T> inverse(ConstMatrixViewT<T> matrix); // For small matrices
 }
 
 
@@ -0,0 +1,99 @@
+
+#ifndef MATRIX_VIEW_H
+#define MATRIX_VIEW_H
+
+#include <cstddef>
+#include <stdexcept>
+#include "precision.h"
+
+// Non-owning, strided window onto row-major storage.
+// A view is (pointer, rows, cols, leading dimension); element (i, j) lives at
+// ptr[i * stride + j]. Views are cheap to copy and never allocate, so row
+// ranges, column ranges (e.g. attention heads) and blocks are zero-copy.
+// The viewed storage must outlive the view.
+template <typename T>
+class ConstMatrixViewT {
+protected:
+    const T* ptr;
+    size_t rows;
+    size_t cols;
+    size_t stride;          // Leading dimension (elements between rows)
+
+public:
+    using value_type = T;
+
+    ConstMatrixViewT() : ptr(nullptr), rows(0), cols(0), stride(0) {}
+    ConstMatrixViewT(const T* ptr, size_t rows, size_t cols, size_t stride)
+        : ptr(ptr), rows(rows), cols(cols), stride(stride) {}
+    ConstMatrixViewT(const T* ptr, size_t rows, size_t cols)
+        : ptr(ptr), rows(rows), cols(cols), stride(cols) {}
+
+    // Element access (unchecked)
+    const T& operator()(size_t row, size_t col) const { return ptr[row * stride + col]; }
+    const T* data() const { return ptr; }
+    const T* row_ptr(size_t row) const { return ptr + row * stride; }
+
+    // Dimensions
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return cols; }
+    size_t getStride() const { return stride; }
+    size_t size() const { return rows * cols; }
+    bool is_contiguous() const { return stride == cols || rows <= 1; }
+
+    // Sub-views
+    ConstMatrixViewT block(size_t row, size_t col, size_t num_rows, size_t num_cols) const {
+        if (row + num_rows > rows || col + num_cols > cols) {
+            throw std::out_of_range("MatrixView block out of range");
+        }
+        return ConstMatrixViewT(ptr + row * stride + col, num_rows, num_cols, stride);
+    }
+    ConstMatrixViewT row_range(size_t row, size_t num_rows) const {
+        return block(row, 0, num_rows, cols);
+    }
+    ConstMatrixViewT col_range(size_t col, size_t num_cols) const {
+        return block(0, col, rows, num_cols);
+    }
+};
+
+template <typename T>
+class MatrixViewT : public ConstMatrixViewT<T> {
+public:
+    MatrixViewT() = default;
+    MatrixViewT(T* ptr, size_t rows, size_t cols, size_t stride)
+        : ConstMatrixViewT<T>(ptr, rows, cols, stride) {}
+    MatrixViewT(T* ptr, size_t rows, size_t cols)
+        : ConstMatrixViewT<T>(ptr, rows, cols) {}
+
+    // Element access (unchecked); constness of the view does not propagate
+    // to the viewed elements, as with pointers
+    T& operator()(size_t row, size_t col) const { return data()[row * this->stride + col]; }
+    T* data() const { return const_cast<T*>(this->ptr); }
+    T* row_ptr(size_t row) const { return data() + row * this->stride; }
+
+    // Sub-views
+    MatrixViewT block(size_t row, size_t col, size_t num_rows, size_t num_cols) const {
+        if (row + num_rows > this->rows || col + num_cols > this->cols) {
+            throw std::out_of_range("MatrixView block out of range");
+        }
+        return MatrixViewT(data() + row * this->stride + col, num_rows, num_cols, this->stride);
+    }
+    MatrixViewT row_range(size_t row, size_t num_rows) const {
+        return block(row, 0, num_rows, this->cols);
+    }
+    MatrixViewT col_range(size_t col, size_t num_cols) const {
+        return block(0, col, this->rows, num_cols);
+    }
+};
+
+// Output parameters of the templated kernels use OutputViewT so the element
+// type is deduced from the inputs only and a Matrix converts implicitly
+// (std::type_identity before C++20).
+template <typename T>
+struct NonDeduced { using type = T; };
+template <typename T>
+using OutputViewT = typename NonDeduced<MatrixViewT<T>>::type;
+
+using ConstMatrixView = ConstMatrixViewT<Scalar>;
+using MatrixView = MatrixViewT<Scalar>;
+
+#endif //MATRIX_VIEW_H
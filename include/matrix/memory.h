@@ -0,0 +1,42 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstddef>
+
+// Allocation policy for the large numeric buffers (Matrix storage, Workspace
+// blocks, GEMM packing buffers).
+//
+// Every buffer is 64-byte aligned. Buffers of at least HUGE_PAGE_THRESHOLD
+// bytes are mapped directly, 2 MB aligned and rounded up to whole 2 MB pages,
+// and backed by huge pages when the system allows: explicit hugetlbfs pages
+// (MAP_HUGETLB) if some are reserved, otherwise transparent huge pages
+// (madvise(MADV_HUGEPAGE)). A 376 MB dataset then needs ~190 TLB entries
+// instead of ~96000, so random row gathers and GEMM over large weight panels
+// stop missing the TLB. Smaller buffers use aligned_alloc.
+//
+// VIT_HUGE_PAGES=0 keeps large buffers on ordinary pages (still mapped
+// directly). allocations() counts which policy each buffer got.
+namespace Memory {
+    constexpr size_t ALIGNMENT = 64;
+    constexpr size_t HUGE_PAGE_SIZE = size_t(2) << 20;
+    constexpr size_t HUGE_PAGE_THRESHOLD = HUGE_PAGE_SIZE;
+
+    enum class Policy {
+        Aligned,                // aligned_alloc (below the threshold)
+        Mapped,                 // Anonymous mapping on ordinary pages
+        TransparentHugePages,   // Anonymous mapping with MADV_HUGEPAGE
+        ExplicitHugePages,      // MAP_HUGETLB from the reserved pool
+    };
+
+    // ALIGNMENT-aligned storage for bytes bytes (nullptr for 0); throws
+    // std::bad_alloc on failure
+    void* allocate(size_t bytes);
+    // Frees a buffer from allocate; bytes must be the size it was allocated with
+    void deallocate(void* ptr, size_t bytes);
+
+    // Buffers allocated so far with each policy
+    size_t allocations(Policy policy);
+    const char* policy_name(Policy policy);
+}
+
+#endif //MEMORY_H
@@ -0,0 +1,76 @@
+#ifndef PACKED_BATCH_H
+#define PACKED_BATCH_H
+
+#include <cstddef>
+#include <stdexcept>
+#include "matrix_view.h"
+#include "tensor3.h"
+
+// Non-owning view of a batch of variable-length sequences packed by rows
+// (e.g. the tokens of images of different resolutions): sequence b is rows
+// [offsets[b], offsets[b + 1]) of one row-major [total_tokens, cols] matrix.
+// offsets holds batch + 1 cumulative row counts, offsets[0] == 0 and
+// offsets[batch] == total_tokens; it is not copied and must outlive the view.
+// The ragged counterpart of Tensor3: row-wise layers run once on flat() over
+// the real tokens only, per-sequence work (attention) indexes operator[].
+template <typename T>
+class ConstPackedBatchViewT {
+protected:
+    ConstMatrixViewT<T> flat_view;
+    const size_t* offset_data;
+    size_t batch;
+
+public:
+    using value_type = T;
+
+    ConstPackedBatchViewT() : offset_data(nullptr), batch(0) {}
+    ConstPackedBatchViewT(ConstMatrixViewT<T> flat, const size_t* offsets, size_t batch)
+        : flat_view(flat), offset_data(offsets), batch(batch) {
+        if (batch > 0 && (offsets[0] != 0 || offsets[batch] != flat.getRows())) {
+            throw std::invalid_argument("Packed batch offsets must span the flat matrix rows");
+        }
+    }
+    // A Tensor3 as a packed batch of equal lengths; writes its batch + 1
+    // offsets into storage
+    ConstPackedBatchViewT(ConstTensor3ViewT<T> tensor, size_t* storage)
+        : flat_view(tensor.flat()), offset_data(storage), batch(tensor.getBatch()) {
+        for (size_t b = 0; b <= batch; ++b) {
+            storage[b] = b * tensor.getRows();
+        }
+    }
+
+    // Dimensions
+    size_t getBatch() const { return batch; }
+    size_t getCols() const { return flat_view.getCols(); }
+    size_t total_rows() const { return flat_view.getRows(); }
+    size_t offset(size_t b) const { return offset_data[b]; }
+    size_t length(size_t b) const { return offset_data[b + 1] - offset_data[b]; }
+    const size_t* offsets() const { return offset_data; }
+
+    // All sequences as one [total_tokens, cols] matrix
+    ConstMatrixViewT<T> flat() const { return flat_view; }
+    // Sequence b, [length(b), cols]
+    ConstMatrixViewT<T> operator[](size_t b) const { return flat_view.row_range(offset(b), length(b)); }
+};
+
+template <typename T>
+class PackedBatchViewT : public ConstPackedBatchViewT<T> {
+public:
+    PackedBatchViewT() = default;
+    PackedBatchViewT(MatrixViewT<T> flat, const size_t* offsets, size_t batch)
+        : ConstPackedBatchViewT<T>(flat, offsets, batch) {}
+    PackedBatchViewT(Tensor3ViewT<T> tensor, size_t* storage)
+        : ConstPackedBatchViewT<T>(tensor, storage) {}
+
+    // Constness of the view does not propagate to the viewed elements
+    MatrixViewT<T> flat() const {
+        const ConstMatrixViewT<T>& f = this->flat_view;
+        return MatrixViewT<T>(const_cast<T*>(f.data()), f.getRows(), f.getCols(), f.getStride());
+    }
+    MatrixViewT<T> operator[](size_t b) const { return flat().row_range(this->offset(b), this->length(b)); }
+};
+
+using ConstPackedBatchView = ConstPackedBatchViewT<Scalar>;
+using PackedBatchView = PackedBatchViewT<Scalar>;
+
+#endif //PACKED_BATCH_H
@@ -0,0 +1,18 @@
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+// Scalar type of the ViT stack.
+//
+// Matrix, MatrixOps and ActivationFunctions are templated on the element
+// type; the transformer modules use the Matrix alias below. float is the
+// production default (twice the SIMD width and half the memory traffic of
+// double). Build with -DVIT_DOUBLE_PRECISION to run the whole model in double
+// as a reference; MatrixT<double> is available in either build.
+#ifdef VIT_DOUBLE_PRECISION
+using Scalar = double;
+#else
+using Scalar = float;
+#endif
+
+#endif //PRECISION_H
@@ -0,0 +1,101 @@
+#ifndef QUANTIZED_H
+#define QUANTIZED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+#include "matrix_view.h"
+
+// Post-training int8 weights for CPU inference.
+//
+// A QuantizedMatrix holds a linear layer's weight as int8 with one fp32 scale
+// per output channel (symmetric, scale = max |w| / 127 over the channel).
+// multiply() quantizes each input row to int8 as well, either with the
+// layer's calibrated input scale (max |x| / 127 seen on calibration data,
+// values beyond it saturate) or, when there is none, with that row's own
+// max |x|. The products accumulate exactly in int32 and are scaled back to
+// fp32 per row and channel. The micro-tiles are chosen at run time with the
+// ISA level (cpu_features.h):
+//
+//   AVX-512 VNNI  vpdpbusd on 16 channels x 4 k per instruction; the signed
+//                 inputs are offset to unsigned and the offset subtracted
+//                 from the accumulator with precomputed channel sums.
+//   AVX-512/AVX2  vpmaddubsw on |x| and sign(x) * w (no 16-bit saturation
+//   /SSE4.2       since |x|, |w| <= 127), widened with vpmaddwd.
+//   Generic       the same integer arithmetic on plain loops the compiler
+//                 vectorizes.
+//
+// All paths produce the same int32 sums, so results do not depend on the
+// ISA. Weights are packed once, in panels of 16 channels by 4 k.
+namespace Quantization {
+    // Largest |x| seen on a layer input while recording (calibration)
+    struct ActivationRange {
+        bool recording = false;
+        float max_abs = 0.0f;
+
+        void start() { recording = true; max_abs = 0.0f; }
+        void stop() { recording = false; }
+        template <typename T>
+        void observe(ConstMatrixViewT<T> x);
+        // Input scale for QuantizedMatrix (0 when nothing was recorded)
+        float scale() const { return max_abs / 127.0f; }
+    };
+
+    // Parameters a quantized model file keeps in fp32 (biases, LayerNorm,
+    // embeddings): shape, then the values as float. read_matrix fills dst and
+    // throws std::runtime_error if the stored shape differs or the stream ends.
+    template <typename T>
+    void write_matrix(std::ostream& os, ConstMatrixViewT<T> m);
+    template <typename T>
+    void read_matrix(std::istream& is, MatrixViewT<T> dst);
+
+    // Describes the int8 kernels of the active ISA level
+    const char* kernel_name();
+}
+
+class QuantizedMatrix {
+public:
+    QuantizedMatrix();
+
+    // Quantizes w for products x * w (w is [in, out], channels are columns)
+    // or, with transposed set, x * w^T (w is [out, in], channels are rows,
+    // e.g. PatchEmbedding's projection). input_scale 0 quantizes every input
+    // row with its own scale.
+    template <typename T>
+    void assign(ConstMatrixViewT<T> w, bool transposed, float input_scale = 0.0f);
+    void clear();
+
+    // out = x * W, out is [x rows, out_features()]
+    template <typename T>
+    void multiply(ConstMatrixViewT<T> x, OutputViewT<T> out) const;
+    // Dequantized weights in the layout assign() received
+    template <typename T>
+    void to_matrix(MatrixViewT<T> dst) const;
+
+    size_t in_features() const { return in; }
+    size_t out_features() const { return out; }
+    bool is_transposed() const { return transposed; }
+    float input_scale() const { return act_scale; }
+    bool empty() const { return packed.empty(); }
+
+    // Binary form: shape, input scale, channel scales and the int8 weights by
+    // channel. read() throws std::runtime_error on a malformed stream.
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
+
+private:
+    size_t in;                  // k
+    size_t out;                 // Output channels
+    bool transposed;            // Layout of the source weight
+    float act_scale;            // Calibrated input scale (0: per row)
+    std::vector<float> scales;  // Per channel
+    std::vector<int32_t> sums;  // Per channel sum of the int8 weights
+    std::vector<int8_t> packed; // Panels of 16 channels, 4 k per channel per group
+
+    size_t groups() const { return (in + 3) / 4; }
+    void pack(const std::vector<int8_t>& by_channel);  // [out, in] int8
+    std::vector<int8_t> unpack() const;
+};
+
+#endif //QUANTIZED_H
@@ -0,0 +1,61 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Counter-based random numbers (Philox4x32-10, Salmon et al., SC'11).
+//
+// A Philox block is a pure function of a 64-bit key and a 128-bit counter,
+// so there is no generator state to share or lock: element i of a stream is
+// always word i % 4 of block i / 4, whichever thread computes it. Streams
+// are numbered; the key is the global seed and the stream number forms the
+// upper half of the counter, so every stream is an independent sequence.
+//
+// Every bulk fill (Matrix::random, dropout masks, noise) takes a fresh stream
+// from a global atomic counter, so with a fixed seed a program produces the
+// same numbers on every run and with any number of threads. The seed comes
+// from VIT_SEED when set, std::random_device otherwise; seed() resets it and
+// restarts the stream counter.
+//
+// Blocks are generated 16 at a time, one block per SIMD lane (AVX-512, AVX2
+// or SSE4.1 by the ISA level chosen at startup, see cpu_features.h, scalar
+// otherwise), and written straight into the destination; uniform fills run at several GB/s per core. Normals take one
+// libm log/sin/cos per pair on top.
+namespace Random {
+    void seed(uint64_t seed);
+    uint64_t get_seed();
+
+    class Stream {
+    public:
+        explicit Stream(uint64_t id) : id(id) {}
+        // The next unused stream of the global sequence
+        static Stream next();
+
+        uint64_t get_id() const { return id; }
+
+        // Elements [first, first + count) of the stream: 32 random bits each
+        void bits(uint64_t first, size_t count, uint32_t* dst) const;
+        // Uniform on [lo, hi), element i from word i
+        void uniform(float* dst, size_t count, float lo, float hi, uint64_t first = 0) const;
+        void uniform(double* dst, size_t count, double lo, double hi, uint64_t first = 0) const;
+        // Normal(mean, stddev) by Box-Muller: elements 2j and 2j + 1 are the
+        // cosine and sine branches of the pair built from words 2j and 2j + 1
+        void normal(float* dst, size_t count, float mean, float stddev, uint64_t first = 0) const;
+        void normal(double* dst, size_t count, double mean, double stddev, uint64_t first = 0) const;
+
+    private:
+        uint64_t id;
+    };
+
+    // Fills dst from a fresh stream, in parallel on the global ThreadPool
+    template <typename T> void uniform(T* dst, size_t count, double lo, double hi);
+    template <typename T> void normal(T* dst, size_t count, double mean, double stddev);
+
+    // Word w is kept by a Bernoulli(p) draw when w < bernoulli_threshold(p)
+    inline uint64_t bernoulli_threshold(double p) {
+        return p <= 0.0 ? 0 : p >= 1.0 ? (uint64_t(1) << 32) : static_cast<uint64_t>(p * 4294967296.0);
+    }
+}
+
+#endif //RANDOM_H
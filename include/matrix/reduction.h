@@ -0,0 +1,33 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <cstddef>
+
+// Reductions over contiguous arrays (rows), the building blocks of the
+// MatrixOps axis reductions and of LayerNorm/softmax.
+//
+// Sums are pairwise: blocks of up to PAIRWISE_BLOCK elements are added into
+// independent lane accumulators (laid out so the compiler turns them into
+// SIMD adds, no -ffast-math needed), folded as a tree, and blocks are
+// combined by recursive halving. The rounding error grows with
+// log2(count) instead of count, at the speed of a plain vectorized loop.
+// Results depend only on the data and count, never on alignment or threads.
+// The loops are compiled for every ISA level, picked at startup
+// (cpu_features.h).
+namespace Reduction {
+    constexpr size_t PAIRWISE_BLOCK = 1024;
+
+    template <typename T>
+    T sum(const T* src, size_t count);
+    // Sum of (src[i] - center)^2: the second pass of a two-pass variance
+    template <typename T>
+    T sum_squared_deviation(const T* src, size_t count, T center);
+    // Largest element; NaN are skipped (-inf when count is 0 or all are NaN)
+    template <typename T>
+    T max(const T* src, size_t count);
+    // Index of the first largest element (0 when count is 0 or all are NaN)
+    template <typename T>
+    size_t argmax(const T* src, size_t count);
+}
+
+#endif //REDUCTION_H
@@ -0,0 +1,74 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "matrix_view.h"
+
+// Structured 2:4 sparse weights for pruned linear layers.
+//
+// Of every 4 consecutive inputs (rows of a [in, out] weight) each output
+// channel keeps the 2 weights with the largest magnitude; the other 2 are
+// zero. SparseMatrix stores only the kept values plus one metadata byte per
+// channel and group (the two positions, 2 bits each), so the weight takes
+// 9/16 of its dense size. It is a storage format: a product costs about as
+// much as the dense GEMM, not half.
+//
+// The kernel broadcasts the 4 inputs of a group and picks each channel's two
+// inputs with a permute driven by the metadata before the multiply-adds: 2
+// multiply-adds + 2 permutes per channel vector and group instead of 4
+// multiply-adds (vpermilps + FMA on AVX-512 and AVX2, pshufb + mul/add on
+// SSE4.2, plain loops otherwise; chosen at run time, see cpu_features.h).
+// The permutes need the issue slots the skipped multiply-adds free, so on a
+// CPU the pattern saves memory rather than time.
+// Kept weights are stored as float; double inputs (VIT_DOUBLE_PRECISION)
+// take a plain reference loop.
+namespace Sparsity {
+    // Magnitude pruning in place: zeroes the 2 smallest |w| of every 4
+    // consecutive rows in each column (ties keep the earlier row). w must
+    // have a multiple of 4 rows.
+    template <typename T>
+    void prune_2_4(MatrixViewT<T> w);
+
+    // True when every column has at most 2 non-zeros per group of 4 rows
+    template <typename T>
+    bool is_2_4_sparse(ConstMatrixViewT<T> w);
+
+    // Describes the sparse kernel of the active ISA level
+    const char* kernel_name();
+}
+
+class SparseMatrix {
+public:
+    SparseMatrix();
+
+    // Prunes w ([in, out], in a multiple of 4) to 2:4 by magnitude and keeps
+    // the remaining weights in the compressed layout
+    template <typename T>
+    void assign(ConstMatrixViewT<T> w);
+    void clear();
+
+    // out = x * W, out is [x rows, out_features()]
+    template <typename T>
+    void multiply(ConstMatrixViewT<T> x, OutputViewT<T> out) const;
+    // Pruned weights as a dense [in, out] matrix
+    template <typename T>
+    void to_matrix(MatrixViewT<T> dst) const;
+
+    size_t in_features() const { return in; }
+    size_t out_features() const { return out; }
+    bool empty() const { return values.empty(); }
+    // Stored weights and metadata, in bytes
+    size_t bytes() const { return values.size() * sizeof(float) + indices.size(); }
+
+private:
+    size_t in;                      // k
+    size_t out;                     // Output channels
+    std::vector<float> values;      // Panels of 16 channels, per group: first kept weight of each channel, then second
+    std::vector<uint8_t> indices;   // Per panel, group and channel: positions of the two kept weights (2 bits each)
+
+    size_t groups() const { return in / 4; }
+};
+
+#endif //SPARSE_H
@@ -0,0 +1,73 @@
+#ifndef TENSOR3_H
+#define TENSOR3_H
+
+#include <cstddef>
+#include <stdexcept>
+#include "matrix_view.h"
+
+// Non-owning [batch, rows, cols] view: a batch of equally shaped matrices
+// (e.g. B token sequences of [S, D]) stored as one row-major
+// [batch * rows, cols] matrix, item b being rows [b * rows, (b + 1) * rows).
+// Row-wise layers (LayerNorm, MLP, the attention projections) run once on
+// flat() as a single [B * S, D] problem; per-item work indexes operator[].
+template <typename T>
+class ConstTensor3ViewT {
+protected:
+    ConstMatrixViewT<T> flat_view;
+    size_t batch;
+    size_t rows;            // Rows per item
+
+public:
+    using value_type = T;
+
+    ConstTensor3ViewT() : batch(0), rows(0) {}
+    ConstTensor3ViewT(ConstMatrixViewT<T> flat, size_t rows_per_item)
+        : flat_view(flat), batch(0), rows(rows_per_item) {
+        if (rows == 0 ? flat.getRows() != 0 : flat.getRows() % rows != 0) {
+            throw std::invalid_argument("Tensor3 rows must divide the flat matrix rows");
+        }
+        batch = rows == 0 ? 0 : flat.getRows() / rows;
+    }
+
+    // Dimensions
+    size_t getBatch() const { return batch; }
+    size_t getRows() const { return rows; }
+    size_t getCols() const { return flat_view.getCols(); }
+
+    // All items as one [batch * rows, cols] matrix
+    ConstMatrixViewT<T> flat() const { return flat_view; }
+    // Item b, [rows, cols]
+    ConstMatrixViewT<T> operator[](size_t b) const { return flat_view.row_range(b * rows, rows); }
+    // Row r of every item, [batch, cols] (e.g. the CLS token of each sequence)
+    ConstMatrixViewT<T> row_of_each(size_t r) const {
+        if (r >= rows) {
+            throw std::out_of_range("Tensor3 row out of range");
+        }
+        return ConstMatrixViewT<T>(flat_view.row_ptr(r), batch, getCols(), rows * flat_view.getStride());
+    }
+};
+
+template <typename T>
+class Tensor3ViewT : public ConstTensor3ViewT<T> {
+public:
+    Tensor3ViewT() = default;
+    Tensor3ViewT(MatrixViewT<T> flat, size_t rows_per_item)
+        : ConstTensor3ViewT<T>(flat, rows_per_item) {}
+
+    // Constness of the view does not propagate to the viewed elements
+    MatrixViewT<T> flat() const {
+        const ConstMatrixViewT<T>& f = this->flat_view;
+        return MatrixViewT<T>(const_cast<T*>(f.data()), f.getRows(), f.getCols(), f.getStride());
+    }
+    MatrixViewT<T> operator[](size_t b) const { return flat().row_range(b * this->rows, this->rows); }
+    MatrixViewT<T> row_of_each(size_t r) const {
+        const ConstMatrixViewT<T> rows_view = ConstTensor3ViewT<T>::row_of_each(r);
+        return MatrixViewT<T>(const_cast<T*>(rows_view.data()), rows_view.getRows(),
+                              rows_view.getCols(), rows_view.getStride());
+    }
+};
+
+using ConstTensor3View = ConstTensor3ViewT<Scalar>;
+using Tensor3View = Tensor3ViewT<Scalar>;
+
+#endif //TENSOR3_H
@@ -0,0 +1,121 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Persistent work-stealing pool shared by the matrix kernels and the
+// transformer modules.
+//
+// parallel_for(count, grain, body) splits [0, count) into chunks of at least
+// grain items (so fewer than 2 * grain items run as one call) and calls
+// body(begin, end) on each. Every participating thread
+// (the caller included) starts with a contiguous run of chunks and, once its
+// own run is empty, steals the back half of another thread's run, so uneven
+// chunks still balance. Nested calls (a kernel invoked from inside a
+// parallel region) and calls made while another thread owns the pool run on
+// the calling thread, so they never deadlock. The first exception thrown by
+// body is rethrown to the caller.
+//
+// The global pool defaults to the number of physical cores; the environment
+// variable VIT_NUM_THREADS or set_num_threads() overrides it.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t num_threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Threads taking part in a parallel_for, the caller included
+    size_t size() const { return workers.size() + 1; }
+    // Restarts the workers with a new size (1 runs everything on the caller)
+    void resize(size_t num_threads);
+
+    template <typename Body>
+    void parallel_for(size_t count, size_t grain, Body&& body);
+
+    // Pool used by the kernels
+    static ThreadPool& global();
+    static void set_num_threads(size_t num_threads) { global().resize(num_threads); }
+    static size_t num_threads() { return global().size(); }
+    // Threads a parallel_for issued from here would use (1 inside a region)
+    static size_t concurrency() { return in_parallel_region() ? 1 : num_threads(); }
+    static bool in_parallel_region() { return inside_region; }
+    // Physical cores (hyperthread siblings counted once)
+    static size_t physical_cores();
+
+private:
+    // Range of chunk indices [lo, hi) packed into one word so the owner
+    // (popping the front) and thieves (splitting off the back) race on a
+    // single compare-and-swap
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> range{0};
+    };
+
+    struct Job {
+        void (*invoke)(void* body, size_t begin, size_t end) = nullptr;
+        void* body = nullptr;
+        size_t count = 0;
+        size_t num_chunks = 0;
+        size_t participants = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<Slot> slots;
+    Job job;
+
+    std::mutex job_mutex;           // Held by the thread that owns the pool
+    std::mutex state_mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    uint64_t generation = 0;
+    bool stopping = false;
+    std::atomic<size_t> active{0};  // Workers still running the current job
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+
+    static thread_local bool inside_region;
+
+    void start(size_t num_threads);
+    void stop();
+    void worker_loop(size_t index, uint64_t seen);
+    void run(size_t count, size_t grain, void (*invoke)(void*, size_t, size_t), void* body);
+    void participate(size_t index);
+    bool take_chunk(size_t index, size_t& chunk);
+    void run_chunk(size_t chunk);
+};
+
+template <typename Body>
+void ThreadPool::parallel_for(size_t count, size_t grain, Body&& body) {
+    if (count == 0) {
+        return;
+    }
+    using B = std::remove_reference_t<Body>;
+    run(count, grain == 0 ? 1 : grain,
+        [](void* b, size_t begin, size_t end) { (*static_cast<B*>(b))(begin, end); },
+        const_cast<void*>(static_cast<const void*>(&body)));
+}
+
+// parallel_for on the global pool
+template <typename Body>
+void parallel_for(size_t count, size_t grain, Body&& body) {
+    ThreadPool::global().parallel_for(count, grain, std::forward<Body>(body));
+}
+
+// Row-parallel loop over a rows x cols problem: each chunk gets whole rows
+// and at least min_elements elements, so small matrices stay on one thread
+template <typename Body>
+void parallel_for_rows(size_t rows, size_t cols, size_t min_elements, Body&& body) {
+    const size_t grain = cols == 0 ? rows : (min_elements + cols - 1) / cols;
+    parallel_for(rows, grain, std::forward<Body>(body));
+}
+
+#endif //THREAD_POOL_H
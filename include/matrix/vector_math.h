@@ -0,0 +1,47 @@
+#ifndef VECTOR_MATH_H
+#define VECTOR_MATH_H
+
+#include <cstddef>
+
+// Bulk transcendental kernels: dst[i] = f(src[i]) over contiguous arrays
+// (dst may be src itself).
+//
+// The float versions are SIMD polynomial/rational approximations (AVX-512 or
+// AVX2+FMA as picked at startup, see cpu_features.h; the same algorithm on
+// scalars otherwise):
+//
+//   exp   Cody-Waite reduction to [-ln2/2, ln2/2], degree-7 polynomial;
+//         max 1.5 ULP. Results under/overflow where expf's do.
+//   tanh  odd degree-11 polynomial for |x| < 0.625, 1 - 2 / (exp(2|x|) + 1)
+//         above; max 1.5 ULP.
+//   erf   odd polynomial for |x| < 1, 1 - exp(-x^2) / x * P(1 / x^2) above;
+//         max 3 ULP.
+//
+// tests/09_vector_math_benchmark.cpp measures these bounds against libm.
+// NaN propagates. Build with -DVIT_EXACT_MATH to route the float versions
+// through libm instead. The double versions always call libm (double is the
+// numerical reference build).
+namespace VectorMath {
+    void exp(const float* src, float* dst, size_t count);
+    void tanh(const float* src, float* dst, size_t count);
+    void erf(const float* src, float* dst, size_t count);
+    void exp(const double* src, double* dst, size_t count);
+    void tanh(const double* src, double* dst, size_t count);
+    void erf(const double* src, double* dst, size_t count);
+
+    // dst[i] = exp(src[i] - shift); returns the sum of dst (softmax numerator)
+    float exp_sum(const float* src, float* dst, size_t count, float shift);
+    double exp_sum(const double* src, double* dst, size_t count, double shift);
+
+    // Tanh-approximated GELU, 0.5 x (1 + tanh(sqrt(2/pi) (x + 0.044715 x^3))),
+    // fused into one pass. The float kernel evaluates the equivalent
+    // x / (1 + exp(-2 sqrt(2/pi) (...))), which does not cancel for x < 0;
+    // max 2 ULP of |x|.
+    void gelu(const float* src, float* dst, size_t count);
+    void gelu(const double* src, double* dst, size_t count);
+
+    // Describes the kernels in use
+    const char* kernel_name();
+}
+
+#endif //VECTOR_MATH_H
@@ -0,0 +1,82 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <cstddef>
+#include <vector>
+#include "matrix_view.h"
+#include "tensor3.h"
+
+// Bump-pointer arena for forward-pass temporaries.
+//
+// matrix() hands out 64-byte aligned views; nothing is freed individually.
+// A Scope records the current position and rolls back to it when it ends,
+// so the temporaries of one layer are recycled by the next. The arena grows
+// by appending blocks; once everything has been released they are merged
+// into a single block of the peak size, so after the first (warm-up) pass
+// a repeated forward of the same shapes never touches the heap.
+class Workspace {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+
+    // Position in the arena, as returned by mark()
+    struct Marker {
+        size_t block;
+        size_t offset;
+    };
+
+    // Rolls the workspace back to where it was on construction
+    class Scope {
+    public:
+        explicit Scope(Workspace& workspace) : workspace(workspace), marker(workspace.mark()) {}
+        ~Scope() { workspace.release(marker); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Workspace& workspace;
+        Marker marker;
+    };
+
+    explicit Workspace(size_t initial_bytes = 0);
+    ~Workspace();
+    Workspace(const Workspace&) = delete;
+    Workspace& operator=(const Workspace&) = delete;
+
+    // Uninitialized, ALIGNMENT-aligned storage valid until released
+    void* allocate(size_t bytes);
+    template <typename T>
+    MatrixViewT<T> matrix(size_t rows, size_t cols) {
+        return MatrixViewT<T>(static_cast<T*>(allocate(rows * cols * sizeof(T))), rows, cols);
+    }
+    template <typename T>
+    Tensor3ViewT<T> tensor3(size_t batch, size_t rows, size_t cols) {
+        return Tensor3ViewT<T>(matrix<T>(batch * rows, cols), rows);
+    }
+
+    Marker mark() const { return {current, offset}; }
+    void release(Marker marker);    // Frees everything allocated after marker
+    void reset() { release({0, 0}); }
+
+    size_t capacity() const;        // Bytes reserved from the heap
+    size_t peak() const { return peak_bytes; }  // Largest amount in use at once
+
+    // Per-thread arena used by the forward overloads that take no workspace
+    static Workspace& local();
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t current;         // Block being bumped
+    size_t offset;          // Bytes used in the current block
+    size_t peak_bytes;
+
+    size_t in_use() const;
+    void add_block(size_t bytes);
+    void free_blocks();
+};
+
+#endif //WORKSPACE_H
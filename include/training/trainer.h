@@ -17,10 +17,10 @@ private:
     
 public:
     SimpleClassifier(size_t input_dim, size_t embed_dim, size_t num_heads, size_t mlp_hidden_dim, size_t num_classes);
-    Matrix forward(const Matrix& input);
+    Matrix forward(ConstMatrixView input);
     double compute_loss(const Matrix& predictions, const std::vector<int>& labels);
     double compute_accuracy(const Matrix& predictions, const std::vector<int>& test_labels);
-    void train_step(const Matrix& batch_images, const std::vector<int>& batch_labels, double learning_rate);
+    void train_step(ConstMatrixView batch_images, const std::vector<int>& batch_labels, double learning_rate);
 };
 
 class Trainer {
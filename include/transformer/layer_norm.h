@@ -5,6 +5,7 @@
 
 #include "../matrix/matrix.h"
 #include "../utils/file_io.h"
+#include <iosfwd>
 #include <string>
 
 class LayerNorm {
@@ -23,9 +24,15 @@ public:
     
     // Forward pass
     Matrix forward(const Matrix& input);
+    // Writes into output, reusing its buffer when it is large enough
+    void forward(ConstMatrixView input, Matrix& output);
+    void forward(ConstMatrixView input, MatrixView output);    // output has input's shape
     
     // Load weights from CSV files
     void load_weights(const std::string& base_path, int layer_idx, const std::string& norm_type);
+    // gamma and beta in fp32 (part of a quantized model file)
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
     
     // Getters
     const Matrix& get_gamma() const { return gamma; }
@@ -2,6 +2,11 @@
 #define MLP_H
 
 #include "../matrix/matrix.h"
+#include "../matrix/half.h"
+#include "../matrix/quantized.h"
+#include "../matrix/sparse.h"
+#include "../matrix/workspace.h"
+#include <iosfwd>
 
 class MLP {
 private:
@@ -11,11 +16,45 @@ private:
     Matrix W1, b1;  // First linear layer
     Matrix W2, b2;  // Second linear layer
     
+    // Optional bf16/fp16 or int8 copies of W1/W2 read by forward instead of
+    // the fp32 weights
+    StorageType weight_storage;
+    HalfMatrix W1_half, W2_half;
+    QuantizedMatrix W1_int8, W2_int8;
+    // Inputs of W1 and W2 seen while calibrating
+    Quantization::ActivationRange input_range, hidden_range;
+    // 2:4 pruned W1/W2 for the sparse kernel, read under Float32 storage
+    SparseMatrix W1_sparse, W2_sparse;
+    
 public:
     MLP(size_t input_dim, size_t hidden_dim);
     
     Matrix forward(const Matrix& input);
+    // Writes into output, reusing its buffer when it is large enough
+    void forward(ConstMatrixView input, Matrix& output);
+    // output must be [rows, input_dim]; the hidden activations come from
+    // workspace. A non-empty residual (output's shape, not output itself) is
+    // added to the result as the second GEMM writes it.
+    void forward(ConstMatrixView input, MatrixView output, Workspace& workspace,
+                 ConstMatrixView residual = ConstMatrixView());
     void initialize_weights();
+    // Stores W1/W2 in bf16/fp16/int8 for forward (Float32 reads the fp32
+    // weights; Int8 uses the calibrated input ranges when recorded). Call
+    // again after the fp32 weights change.
+    void set_weight_storage(StorageType type);
+    // While recording, forward tracks the range of the W1 and W2 inputs
+    void set_calibration(bool recording);
+    // true prunes W1/W2 to 2:4 by magnitude in place and has forward run
+    // them through the sparse kernel (under Float32 storage; bf16/fp16/int8
+    // copies made afterwards hold the pruned weights). false only drops the
+    // sparse copies, the weights stay pruned.
+    void set_sparse(bool enabled);
+    bool is_sparse() const { return !W1_sparse.empty(); }
+    
+    // Int8 weights and fp32 biases (weight storage must be Int8); read() also
+    // restores the fp32 weights by dequantizing
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,11 @@
 #define MULTI_HEAD_ATTENTION_H
 
 #include "../matrix/matrix.h"
+#include "../matrix/half.h"
+#include "../matrix/quantized.h"
+#include "../matrix/workspace.h"
+#include "../matrix/packed_batch.h"
+#include <iosfwd>
 
 class MultiHeadAttention {
 private:
@@ -9,15 +14,75 @@ private:
     size_t num_heads;
     size_t head_dim;
     
-    Matrix W_q, W_k, W_v, W_o;  // Weight matrices
+    // Q, K and V projections packed into one [embed_dim, 3 * embed_dim]
+    // matrix, head-major: the 3 * head_dim columns starting at
+    // h * 3 * head_dim are head h's Q, then K, then V columns, so one GEMM
+    // projects all three and each head reads its slices in place
+    Matrix W_qkv;
+    Matrix W_o;
+    
+    // Optional bf16/fp16 or int8 copies read by forward instead of the fp32 weights
+    StorageType weight_storage;
+    HalfMatrix W_qkv_half, W_o_half;
+    QuantizedMatrix W_qkv_int8, W_o_int8;
+    // Inputs of the QKV and of the output projection seen while calibrating
+    Quantization::ActivationRange input_range, context_range;
+    
+    // out = input * W (+ residual, when not empty)
+    void project(ConstMatrixView input, const Matrix& W, const HalfMatrix& W_half,
+                 const QuantizedMatrix& W_int8, MatrixView out,
+                 ConstMatrixView residual = ConstMatrixView()) const;
     
 public:
     MultiHeadAttention(size_t embed_dim, size_t num_heads);
     
     Matrix forward(const Matrix& input);
-    Matrix scaled_dot_product_attention(const Matrix& Q, const Matrix& K, const Matrix& V);
+    // Writes into output, reusing its buffer when it is large enough
+    void forward(ConstMatrixView input, Matrix& output);
+    // output must be [seq_len, embed_dim]; Q/K/V and the attention tiles come from workspace
+    void forward(ConstMatrixView input, MatrixView output, Workspace& workspace);
+    // A batch of sequences [batch, seq_len, embed_dim]: the projections run
+    // once over all batch * seq_len tokens, the attention core per sequence
+    // and head (in parallel). A non-empty residual
+    // ([batch * seq_len, embed_dim], not output itself) is added to the
+    // output as the output projection writes it.
+    void forward(ConstTensor3View input, Tensor3View output, Workspace& workspace,
+                 ConstMatrixView residual = ConstMatrixView());
+    // Sequences of different lengths packed by rows (see packed_batch.h): the
+    // projections run over the real tokens only and attention is
+    // block-diagonal, each sequence attending to its own tokens. residual
+    // as above, [total_tokens, embed_dim]. For token merging (see
+    // token_merging.h): a non-null key_bias (one value per token, e.g.
+    // log of its size) is added to the scores of that key, and a non-empty
+    // keys ([total_tokens, head_dim]) receives each token's key averaged
+    // over the heads.
+    void forward(ConstPackedBatchView input, PackedBatchView output, Workspace& workspace,
+                 ConstMatrixView residual = ConstMatrixView(), const Scalar* key_bias = nullptr,
+                 MatrixView keys = MatrixView());
+    // softmax(Q K^T / sqrt(head_dim)) V, fused: K and V are streamed in tiles
+    // with a running max and sum per row (online softmax), so the
+    // [seq_len, seq_len] scores are never stored and scratch is O(tile)
+    Matrix scaled_dot_product_attention(ConstMatrixView Q, ConstMatrixView K, ConstMatrixView V);
+    // Writes the head output into out (e.g. a column slice of the full output)
+    void scaled_dot_product_attention(ConstMatrixView Q, ConstMatrixView K, ConstMatrixView V,
+                                      MatrixView out);
+    void scaled_dot_product_attention(ConstMatrixView Q, ConstMatrixView K, ConstMatrixView V,
+                                      MatrixView out, Workspace& workspace);
     
     void initialize_weights();
+    // Stores the projection weights in bf16/fp16/int8 for forward (Float32
+    // reads the fp32 weights). Int8 uses the calibrated input ranges, or
+    // per-row input scales if none were recorded. Call again after the fp32
+    // weights change.
+    void set_weight_storage(StorageType type);
+    // While recording, forward tracks the range of each projection's input
+    // (start resets it); quantize with set_weight_storage(Int8) afterwards
+    void set_calibration(bool recording);
+    
+    // Int8 weights (weight storage must be Int8); read() also restores the
+    // fp32 weights by dequantizing
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
 };
 
 #endif
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
 #include "../matrix/matrix.h"
+#include "../matrix/half.h"
+#include "../matrix/quantized.h"
+#include <iosfwd>
+#include <vector>
 
 class PatchEmbedding {
 private:
@@ -7,9 +11,35 @@ private:
     int embed_dim;
     Matrix projection_weight;
     Matrix projection_bias;
+    HalfMatrix projection_weight_half;  // Optional bf16/fp16 copy read by forward
+    QuantizedMatrix projection_weight_int8;         // Optional int8 copy read by forward
+    Quantization::ActivationRange patch_range;      // Patches seen while calibrating
+    Matrix patches;                     // Scratch buffer reused across forward calls
+    std::vector<size_t> first_patch;    // Row of each image's first patch (mixed sizes)
+    
+    // Full patches of one img_size x img_size image into the rows of dst
+    void extract_patches(const Scalar* image, int img_size, MatrixView dst) const;
+    // embeddings = patches * W^T + bias
+    void project(Matrix& embeddings);
 
 public:
     PatchEmbedding(int patch_size, int embed_dim);
     Matrix forward(const Matrix& images);
+    // Writes into embeddings, reusing its buffer when it is large enough
+    void forward(const Matrix& images, Matrix& embeddings);
+    // Images of different sizes, each square (side x side values in any
+    // shape); the patches of all images are stacked by rows in order
+    void forward(const std::vector<Matrix>& images, Matrix& embeddings);
     int get_num_patches(int img_size) const;
+    int get_patch_size() const { return patch_size; }
+    // Side of a square image, throws std::invalid_argument otherwise
+    static int image_side(const Matrix& image);
+    // Stores the projection weight in bf16/fp16/int8 for forward (Float32
+    // reads the fp32 weight)
+    void set_weight_storage(StorageType type);
+    // While recording, forward tracks the range of the patch values
+    void set_calibration(bool recording);
+    // Int8 projection and fp32 bias (weight storage must be Int8)
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "../matrix/matrix.h"
+#include <iosfwd>
 
 class PositionalEncoding {
 private:
@@ -10,4 +11,12 @@ private:
 public:
     PositionalEncoding(int max_seq_len, int embed_dim);
     Matrix forward(const Matrix& x);
+    void forward_inplace(MatrixView x) const;   // x += positional embeddings
+    // x is CLS plus the grid x grid patches of a smaller image: each patch
+    // takes the embedding of its (row, col) on the full_grid x full_grid
+    // grid the embeddings were learned on (the top-left corner of it)
+    void forward_inplace(MatrixView x, int grid, int full_grid) const;
+    // Embeddings in fp32 (part of a quantized model file)
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef TOKEN_MERGING_H
+#define TOKEN_MERGING_H
+
+#include <cstddef>
+#include "../matrix/packed_batch.h"
+
+// Token merging between transformer blocks (ToMe, bipartite soft matching):
+// each sequence's tokens are split alternately into sets A (even positions)
+// and B (odd positions), every A token is matched to its most similar B
+// token by the cosine similarity of its attention key (averaged over heads),
+// and the r best-matched A tokens are averaged into their B partners. Later
+// blocks then process r fewer tokens per sequence.
+//
+// A token stands for `size` original patches. Merges are size-weighted
+// averages and sizes add up, so a merged token is the mean of everything it
+// absorbed; attention adds log(size) to each key's scores (proportional
+// attention), so a token of size s weighs as much as its s originals. The
+// CLS token (row 0) is never merged and stays row 0.
+namespace TokenMerging {
+    // Tokens left of a sequence of length tokens after merging r: at most
+    // (length - 1) / 2 tokens merge (one per A token besides CLS)
+    size_t merged_length(size_t length, size_t r);
+
+    // Merges r tokens of every sequence of tokens. keys: [total_tokens, d],
+    // one similarity key per token; sizes: one per token. merged must have
+    // offsets of merged_length(length(b), r) per sequence and embed_dim
+    // columns; merged_sizes receives its token sizes. Unmerged A tokens come
+    // first in their original order, then the B tokens. Sequences run in
+    // parallel with scratch from each thread's Workspace::local(). Throws
+    // std::invalid_argument if merged's shape does not match tokens and r.
+    void merge(ConstPackedBatchView tokens, ConstMatrixView keys, const Scalar* sizes, size_t r,
+               PackedBatchView merged, Scalar* merged_sizes);
+}
+
+#endif //TOKEN_MERGING_H
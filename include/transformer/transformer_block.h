@@ -5,6 +5,8 @@
 #include "multi_head_attention.h"
 #include "mlp.h"
 #include "layer_norm.h"
+#include "../matrix/workspace.h"
+#include <iosfwd>
 
 class TransformerBlock {
 private:
@@ -16,6 +18,39 @@ public:
     TransformerBlock(size_t embed_dim, size_t num_heads, size_t mlp_hidden_dim);
     
     Matrix forward(const Matrix& input);
+    // Writes into output, reusing its buffer when it is large enough; the
+    // temporaries come from the thread's Workspace::local() arena, so after
+    // the first call with a given shape nothing is allocated
+    void forward(ConstMatrixView input, Matrix& output);
+    // output must have input's shape; temporaries are released from
+    // workspace before returning
+    void forward(ConstMatrixView input, MatrixView output, Workspace& workspace);
+    // A batch of sequences: LayerNorm, the projections and the MLP run once
+    // over all tokens, attention within each sequence
+    void forward(ConstTensor3View input, Tensor3View output, Workspace& workspace);
+    // Sequences of different lengths packed by rows (see packed_batch.h);
+    // output shares input's offsets. key_bias and keys are passed to the
+    // attention (token merging, see MultiHeadAttention::forward).
+    void forward(ConstPackedBatchView input, PackedBatchView output, Workspace& workspace,
+                 const Scalar* key_bias = nullptr, MatrixView keys = MatrixView());
+    // 16-bit residual stream: widens input, runs the block in Scalar and
+    // rounds the result into output using input's storage type. input holds
+    // one sequence, or a batch of seq_len-row sequences stacked by rows.
+    void forward(const HalfMatrix& input, HalfMatrix& output, Workspace& workspace);
+    void forward(const HalfMatrix& input, size_t seq_len, HalfMatrix& output, Workspace& workspace);
+    // Packed sequences, batch + 1 row offsets as in packed_batch.h
+    void forward(const HalfMatrix& input, const size_t* offsets, size_t batch, HalfMatrix& output,
+                 Workspace& workspace, const Scalar* key_bias = nullptr, MatrixView keys = MatrixView());
+    
+    void set_weight_storage(StorageType type);
+    // Records the input ranges of the linear layers during forward (see
+    // MultiHeadAttention::set_calibration)
+    void set_calibration(bool recording);
+    // 2:4 sparse MLP weights (see MLP::set_sparse)
+    void set_sparse_mlp(bool enabled);
+    // Int8 attention and MLP weights plus the fp32 LayerNorm parameters
+    void write(std::ostream& os) const;
+    void read(std::istream& is);
 };
 
 #endif
\ No newline at end of file
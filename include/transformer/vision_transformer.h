@@ -1,8 +1,10 @@
 #pragma once
 #include "../matrix/matrix.h"
+#include "../matrix/quantized.h"
 #include "patch_embedding.h"
 #include "positional_encoding.h"
 #include "transformer_block.h"
+#include <string>
 #include <vector>
 
 class VisionTransformer {
@@ -13,20 +15,86 @@ private:
     Matrix cls_token;
     Matrix classification_head_weight;
     Matrix classification_head_bias;
+    QuantizedMatrix classification_head_int8;       // Read by forward under Int8 storage
+    Quantization::ActivationRange head_range;       // CLS features seen while calibrating
     
+    int grid_size;     // Patches per side at img_size (the positional embedding grid)
     int embed_dim;
+    int head_dim;      // Width of the attention keys compared by token merging
     int num_classes;
     int num_layers;
     double dropout_rate;
     bool use_cuda;
+    StorageType storage_type;  // Weights and inter-block activations
+    std::vector<size_t> merged_per_layer;   // Tokens merged after each block (token merging)
+    
+    // Reused across forward calls (the other temporaries come from the
+    // workspace)
+    Matrix patch_embeddings;
+    HalfMatrix stream, next;  // 16-bit residual stream between blocks
+    std::vector<size_t> sequence_offsets;   // Packed batch offsets (mixed sizes)
+    
+    // Transformer blocks over the packed sequences, merging tokens between
+    // them when enabled; the result is in sequences or in a buffer taken
+    // from workspace (the returned view, whose offsets reflect the merges)
+    PackedBatchView run_blocks(PackedBatchView sequences, Workspace& workspace);
+    // logits = classification head on the CLS features, one row per image
+    void classify(ConstMatrixView cls, Matrix& logits);
 
 public:
     VisionTransformer(int img_size, int patch_size, int embed_dim, 
                      int num_heads, int mlp_dim, int num_layers, int num_classes, 
                      double dropout = 0.1, bool cuda = false);
     Matrix forward(const Matrix& images, bool training = true);
+    // Writes into logits, reusing its buffer; after the first call with a
+    // given batch size nothing is allocated. The whole batch goes through
+    // each block as one [batch * seq_len, embed_dim] problem (see Tensor3),
+    // so the GEMMs see batch * seq_len rows; the kernels spread it over the
+    // global ThreadPool. Temporaries come from workspace (Workspace::local()
+    // by default) and are released before returning.
+    void forward(const Matrix& images, Matrix& logits, bool training = true);
+    void forward(const Matrix& images, Matrix& logits, Workspace& workspace, bool training = true);
+    // Mixed resolutions: images[b] is one square image (side x side values,
+    // side at most img_size). Their tokens are packed into one
+    // [total_tokens, embed_dim] batch (see packed_batch.h) instead of being
+    // padded to the largest, so compute follows the real token count:
+    // LayerNorm, projections and MLP run over all tokens at once, attention
+    // within each image. A smaller image's patches take the positional
+    // embeddings of the same (row, col) on the img_size grid.
+    void forward(const std::vector<Matrix>& images, Matrix& logits, Workspace& workspace);
     Matrix get_predictions(const Matrix& logits);
     void backward_and_update(const Matrix& images, const std::vector<int>& labels, double learning_rate);
-    void setTraining(bool training) { /* for dropout */ }
+    void setTraining(bool /*training*/) { /* for dropout */ }
     void initWeights();
+    // Stores weights and the activations between transformer blocks in
+    // bf16/fp16 (Float32 keeps everything in Scalar). LayerNorm, softmax and
+    // GEMM accumulation always run in Scalar. Int8 quantizes the linear
+    // layers (patch projection, attention, MLP, classification head) per
+    // output channel and keeps the activations between blocks in Scalar.
+    void set_storage_type(StorageType type);
+    // Prunes the MLP weights of every block to 2:4 by magnitude and runs
+    // them through the sparse kernel (Float32 storage). Pruning is
+    // permanent; false only returns to the dense kernel.
+    void set_sparse_mlp(bool enabled);
+    // Token merging for faster inference: after block i, r[i] tokens of
+    // every image are merged into similar ones (bipartite soft matching on
+    // the attention keys, see token_merging.h), so later blocks process
+    // shorter sequences. Missing entries and 0 merge nothing; an empty
+    // vector turns merging off. CLS is never merged, and merged tokens are
+    // size-weighted averages with proportional attention, so the CLS output
+    // stays close to the unmerged model's. Applies to both forwards.
+    void set_token_merging(const std::vector<size_t>& r);
+    
+    // Post-training int8 calibration: runs images (one row per image) through
+    // the fp32 model in batches and records the input range of every linear
+    // layer. The current storage type is restored afterwards, so under Int8
+    // the weights are re-quantized with the new input scales.
+    void calibrate(const Matrix& images, size_t batch_size = 64);
+    
+    // Quantized model file: int8 linear layers with their scales, the rest
+    // (LayerNorm, embeddings, biases) in fp32. save_quantized requires Int8
+    // storage; load_quantized needs a model built with the same dimensions
+    // and switches it to Int8. Both throw std::runtime_error on failure.
+    void save_quantized(const std::string& path) const;
+    void load_quantized(const std::string& path);
 };
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifdef USE_CUDA
 #include "../../include/cuda/cuda_matrix.h"
 #include <iostream>
+#include <type_traits>
 
 cublasHandle_t CudaMatrix::cublas_handle;
 
@@ -18,6 +19,11 @@ CudaMatrix::~CudaMatrix() {
 }
 
 void CudaMatrix::copyFromHost(const Matrix& host_matrix) {
+    // float matrices are contiguous and bit-compatible with the device buffer
+    if (std::is_same<Scalar, float>::value) {
+        cudaMemcpy(d_data, host_matrix.data(), rows * cols * sizeof(float), cudaMemcpyHostToDevice);
+        return;
+    }
     float* temp = new float[rows * cols];
     for (int i = 0; i < rows; i++) {
         for (int j = 0; j < cols; j++) {
@@ -29,11 +35,15 @@ void CudaMatrix::copyFromHost(const Matrix& host_matrix) {
 }
 
 void CudaMatrix::copyToHost(Matrix& host_matrix) {
+    if (std::is_same<Scalar, float>::value) {
+        cudaMemcpy(host_matrix.data(), d_data, rows * cols * sizeof(float), cudaMemcpyDeviceToHost);
+        return;
+    }
     float* temp = new float[rows * cols];
     cudaMemcpy(temp, d_data, rows * cols * sizeof(float), cudaMemcpyDeviceToHost);
     for (int i = 0; i < rows; i++) {
         for (int j = 0; j < cols; j++) {
-            host_matrix(i, j) = (double)temp[i * cols + j];
+            host_matrix(i, j) = (Scalar)temp[i * cols + j];
         }
     }
     delete[] temp;
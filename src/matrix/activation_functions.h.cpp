@@ -2,247 +2,455 @@
 
 #include "../../include/matrix/activation_functions.h"
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/random.h"
+#include "../../include/matrix/thread_pool.h"
+#include "../../include/matrix/vector_math.h"
+#include "../../include/matrix/reduction.h"
 const double M_PI = 3.14159265358979323846;
 #include <cmath>
-#include  <random>
 #include <algorithm>
 
 namespace ActivationFunctions {
 
-Matrix relu(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = std::max(0.0, input(i, j));
-        }
+namespace {
+
+// Row-wise kernels give each thread at least this many elements (fewer
+// than MatrixOps since most of them evaluate a transcendental per element)
+constexpr size_t PARALLEL_MIN_ELEMENTS = 1 << 12;
+
+// out[i][j] = op(input[i][j]); out may be input itself. Rows are split
+// across the thread pool, so op must be safe to call concurrently.
+template <typename T, typename Op>
+void map_into(MatrixViewT<T> out, ConstMatrixViewT<T> input, Op op) {
+    if (out.getRows() != input.getRows() || out.getCols() != input.getCols()) {
+        throw std::invalid_argument("Output dimensions must match the input");
     }
-    return result;
+    parallel_for_rows(input.getRows(), input.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const T* src = input.row_ptr(i);
+            T* dst = out.row_ptr(i);
+            for (size_t j = 0; j < input.getCols(); ++j) {
+                dst[j] = op(src[j]);
+            }
+        }
+    });
 }
 
-Matrix reluDerivative(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = input(i, j) > 0.0 ? 1.0 : 0.0;
-        }
+// out[i][:] = kernel(input[i][:]) for a VectorMath row kernel; out may be input itself
+template <typename T, typename Kernel>
+void map_rows_into(MatrixViewT<T> out, ConstMatrixViewT<T> input, Kernel kernel) {
+    if (out.getRows() != input.getRows() || out.getCols() != input.getCols()) {
+        throw std::invalid_argument("Output dimensions must match the input");
     }
-    return result;
+    parallel_for_rows(input.getRows(), input.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            kernel(input.row_ptr(i), out.row_ptr(i), input.getCols());
+        }
+    });
 }
 
-Matrix gelu(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    const double sqrt_2_pi = std::sqrt(2.0 / M_PI);
+} // namespace
 
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double x = input(i, j);
-            double tanh_arg = sqrt_2_pi * (x + 0.044715 * x * x * x);
-            result(i, j) = 0.5 * x * (1.0 + std::tanh(tanh_arg));
-        }
-    }
-    return result;
+template <typename T>
+void relu_into(OutputViewT<T> out, ConstMatrixViewT<T> input) {
+    map_into<T>(out, input, [](T x) { return std::max(T(0), x); });
 }
 
-Matrix geluDerivative(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    const double sqrt_2_pi = std::sqrt(2.0 / M_PI);
+template <typename T>
+void reluDerivative_into(OutputViewT<T> out, ConstMatrixViewT<T> input) {
+    map_into<T>(out, input, [](T x) { return x > T(0) ? T(1) : T(0); });
+}
 
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double x = input(i, j);
-            double tanh_arg = sqrt_2_pi * (x + 0.044715 * x * x * x);
-            double tanh_val = std::tanh(tanh_arg);
-            double sech2_val = 1.0 - tanh_val * tanh_val;
+template <typename T>
+void gelu_into(OutputViewT<T> out, ConstMatrixViewT<T> input) {
+    // Fused SIMD tanh-approximation GELU (see vector_math.h)
+    map_rows_into<T>(out, input, [](const T* src, T* dst, size_t count) {
+        VectorMath::gelu(src, dst, count);
+    });
+}
 
-            double derivative = 0.5 * (1.0 + tanh_val) +
-                               0.5 * x * sech2_val * sqrt_2_pi * (1.0 + 3.0 * 0.044715 * x * x);
-            result(i, j) = derivative;
+template <typename T>
+void geluDerivative_into(OutputViewT<T> out, ConstMatrixViewT<T> input) {
+    const T sqrt_2_pi = static_cast<T>(std::sqrt(2.0 / M_PI));
+    map_rows_into<T>(out, input, [sqrt_2_pi](const T* src, T* dst, size_t count) {
+        // The tanh values go through a stack buffer in blocks, so dst may alias src
+        constexpr size_t BLOCK = 256;
+        T tanh_val[BLOCK];
+        for (size_t j0 = 0; j0 < count; j0 += BLOCK) {
+            const size_t n = std::min(BLOCK, count - j0);
+            for (size_t j = 0; j < n; ++j) {
+                const T x = src[j0 + j];
+                tanh_val[j] = sqrt_2_pi * (x + T(0.044715) * x * x * x);
+            }
+            VectorMath::tanh(tanh_val, tanh_val, n);
+            for (size_t j = 0; j < n; ++j) {
+                const T x = src[j0 + j];
+                const T t = tanh_val[j];
+                const T sech2_val = T(1) - t * t;
+                dst[j0 + j] = T(0.5) * (T(1) + t) +
+                              T(0.5) * x * sech2_val * sqrt_2_pi * (T(1) + T(3.0 * 0.044715) * x * x);
+            }
         }
-    }
-    return result;
+    });
 }
 
-Matrix softmax(const Matrix& input, int axis) {
-    Matrix result(input.getRows(), input.getCols());
+template <typename T>
+void softmax_into(OutputViewT<T> out, ConstMatrixViewT<T> input, int axis) {
+    const size_t rows = input.getRows();
+    const size_t cols = input.getCols();
+    if (out.getRows() != rows || out.getCols() != cols) {
+        throw std::invalid_argument("Output dimensions must match the input");
+    }
 
     if (axis == 1) {
-        // Softmax across columns (each row sums to 1)
-        for (size_t i = 0; i < input.getRows(); ++i) {
-            // Find max for numerical stability
-            double max_val = input(i, 0);
-            for (size_t j = 1; j < input.getCols(); ++j) {
-                max_val = std::max(max_val, input(i, j));
+        // Softmax across columns (each row sums to 1); rows are independent
+        parallel_for_rows(rows, cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const T* src = input.row_ptr(i);
+                T* dst = out.row_ptr(i);
+
+                // Find max for numerical stability
+                const T max_val = Reduction::max(src, cols);
+
+                // Compute exponentials into the output row and sum (SIMD exp)
+                const T sum_exp = VectorMath::exp_sum(src, dst, cols, max_val);
+
+                // Normalize
+                const T inv_sum = T(1) / sum_exp;
+                for (size_t j = 0; j < cols; ++j) {
+                    dst[j] *= inv_sum;
+                }
             }
-
-            // Compute exponentials and sum
-            double sum_exp = 0.0;
-            std::vector<double> exp_vals(input.getCols());
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                exp_vals[j] = std::exp(input(i, j) - max_val);
-                sum_exp += exp_vals[j];
-            }
-
-            // Normalize
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                result(i, j) = exp_vals[j] / sum_exp;
-            }
-        }
+        });
     } else if (axis == 0) {
-        // Softmax across rows (each column sums to 1)
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            // Find max for numerical stability
-            double max_val = input(0, j);
-            for (size_t i = 1; i < input.getRows(); ++i) {
-                max_val = std::max(max_val, input(i, j));
+        // Softmax across rows (each column sums to 1), processed row-wise
+        // with per-column running max and sum vectors
+        if (rows == 0) {
+            return;
+        }
+        std::vector<T> max_vals(input.row_ptr(0), input.row_ptr(0) + cols);
+        for (size_t i = 1; i < rows; ++i) {
+            const T* src = input.row_ptr(i);
+            for (size_t j = 0; j < cols; ++j) {
+                max_vals[j] = std::max(max_vals[j], src[j]);
             }
+        }
 
-            // Compute exponentials and sum
-            double sum_exp = 0.0;
-            std::vector<double> exp_vals(input.getRows());
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                exp_vals[i] = std::exp(input(i, j) - max_val);
-                sum_exp += exp_vals[i];
+        std::vector<T> sums(cols, T(0));
+        for (size_t i = 0; i < rows; ++i) {
+            const T* src = input.row_ptr(i);
+            T* dst = out.row_ptr(i);
+            for (size_t j = 0; j < cols; ++j) {
+                dst[j] = src[j] - max_vals[j];
             }
+            VectorMath::exp(dst, dst, cols);
+            for (size_t j = 0; j < cols; ++j) {
+                sums[j] += dst[j];
+            }
+        }
 
-            // Normalize
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                result(i, j) = exp_vals[i] / sum_exp;
+        for (size_t j = 0; j < cols; ++j) {
+            sums[j] = T(1) / sums[j];
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            T* dst = out.row_ptr(i);
+            for (size_t j = 0; j < cols; ++j) {
+                dst[j] *= sums[j];
             }
         }
     } else {
         throw std::invalid_argument("Axis must be 0 or 1");
     }
-
-    return result;
 }
 
-Matrix dropout(const Matrix& input, double dropout_rate, bool training) {
+template <typename T>
+void dropout_into(OutputViewT<T> out, ConstMatrixViewT<T> input, double dropout_rate, bool training) {
     if (!training) {
         // During inference, dropout acts as identity
-        return input;
+        if (out.data() != input.data()) {
+            MatrixOps::copy(out, input);
+        }
+        return;
     }
 
-    // During training, randomly set elements to zero
-    Matrix result = input;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::bernoulli_distribution dis(1.0 - dropout_rate);
-
-    double scale = 1.0 / (1.0 - dropout_rate);
-
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            if (dis(gen)) {
-                result(i, j) *= scale;
-            } else {
-                result(i, j) = 0.0;
+    // During training, randomly set elements to zero. Element (i, j) keeps
+    // word i * cols + j of one counter-based stream, so the mask is the same
+    // whichever thread draws each row.
+    if (out.getRows() != input.getRows() || out.getCols() != input.getCols()) {
+        throw std::invalid_argument("Output dimensions must match the input");
+    }
+    const Random::Stream stream = Random::Stream::next();
+    const uint64_t threshold = Random::bernoulli_threshold(1.0 - dropout_rate);
+    const T scale = static_cast<T>(1.0 / (1.0 - dropout_rate));
+    const size_t cols = input.getCols();
+    parallel_for_rows(input.getRows(), cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        constexpr size_t CHUNK = 256;
+        uint32_t words[CHUNK];
+        for (size_t i = first; i < last; ++i) {
+            const T* src = input.row_ptr(i);
+            T* dst = out.row_ptr(i);
+            for (size_t j0 = 0; j0 < cols; j0 += CHUNK) {
+                const size_t n = std::min(CHUNK, cols - j0);
+                stream.bits(uint64_t(i) * cols + j0, n, words);
+                for (size_t j = 0; j < n; ++j) {
+                    dst[j0 + j] = words[j] < threshold ? src[j0 + j] * scale : T(0);
+                }
             }
         }
-    }
+    });
+}
 
-    return result;
+template <typename T>
+std::pair<MatrixT<T>, MatrixT<T>> computeMeanAndVariance(const MatrixT<T>& input, int axis) {
+    // One pass for both (meanVarAxis_into rejects an invalid axis)
+    const size_t rows = axis == 0 ? 1 : input.getRows();
+    const size_t cols = axis == 0 ? input.getCols() : 1;
+    MatrixT<T> mean(rows, cols), variance(rows, cols);
+    MatrixOps::meanVarAxis_into(mean.view(), variance.view(), input, axis);
+    return {mean, variance};
 }
 
-std::pair<Matrix, Matrix> computeMeanAndVariance(const Matrix& input, int axis) {
-    Matrix mean = MatrixOps::meanAxis(input, axis);
+template <typename T>
+void layerNorm_into(OutputViewT<T> out, ConstMatrixViewT<T> input, ConstMatrixViewT<T> gamma,
+                    ConstMatrixViewT<T> beta, double epsilon, int axis) {
+    const size_t rows = input.getRows();
+    const size_t cols = input.getCols();
+    const T eps = static_cast<T>(epsilon);
+    if (out.getRows() != rows || out.getCols() != cols) {
+        throw std::invalid_argument("Output dimensions must match the input");
+    }
 
-    Matrix variance;
     if (axis == 1) {
-        // Compute variance across columns
-        variance = Matrix(input.getRows(), 1, 0.0);
-        for (size_t i = 0; i < input.getRows(); ++i) {
-            double var_sum = 0.0;
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                double diff = input(i, j) - mean(i, 0);
-                var_sum += diff * diff;
+        // Normalize across columns; statistics are computed per row in place
+        const T* g = gamma.data();
+        const T* b = beta.data();
+        parallel_for_rows(rows, cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const T* src = input.row_ptr(i);
+                T* dst = out.row_ptr(i);
+
+                // Two-pass mean and variance, pairwise summed
+                const T mu = Reduction::sum(src, cols) / cols;
+                const T var_sum = Reduction::sum_squared_deviation(src, cols, mu);
+                const T inv_std = T(1) / std::sqrt(var_sum / cols + eps);
+
+                for (size_t j = 0; j < cols; ++j) {
+                    dst[j] = g[j] * ((src[j] - mu) * inv_std) + b[j];
+                }
             }
-            variance(i, 0) = var_sum / input.getCols();
-        }
+        });
     } else if (axis == 0) {
-        // Compute variance across rows
-        variance = Matrix(1, input.getCols(), 0.0);
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double var_sum = 0.0;
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                double diff = input(i, j) - mean(0, j);
-                var_sum += diff * diff;
+        // Normalize across rows; the column statistics come from one pass
+        // over the input view
+        MatrixT<T> mean(1, cols), variance(1, cols);
+        MatrixOps::meanVarAxis_into(mean.view(), variance.view(), input, 0);
+        std::vector<T> inv_std(cols);
+        for (size_t j = 0; j < cols; ++j) {
+            inv_std[j] = T(1) / std::sqrt(variance(0, j) + eps);
+        }
+
+        const T* mu = mean.data();
+        for (size_t i = 0; i < rows; ++i) {
+            const T* src = input.row_ptr(i);
+            T* dst = out.row_ptr(i);
+            const T g = gamma(i, 0);
+            const T b = beta(i, 0);
+            for (size_t j = 0; j < cols; ++j) {
+                dst[j] = g * ((src[j] - mu[j]) * inv_std[j]) + b;
             }
-            variance(0, j) = var_sum / input.getRows();
         }
-    } else {
-        throw std::invalid_argument("Axis must be 0 or 1");
     }
+}
 
-    return {mean, variance};
+template <typename T>
+void sigmoid_into(OutputViewT<T> out, ConstMatrixViewT<T> input) {
+    map_into<T>(out, input, [](T x) { return T(1) / (T(1) + std::exp(-x)); });
 }
 
-Matrix layerNorm(const Matrix& input, const Matrix& gamma, const Matrix& beta,
-                 double epsilon, int axis) {
-    auto [mean, variance] = computeMeanAndVariance(input, axis);
+template <typename T>
+void tanh_into(OutputViewT<T> out, ConstMatrixViewT<T> input) {
+    map_rows_into<T>(out, input, [](const T* src, T* dst, size_t count) {
+        VectorMath::tanh(src, dst, count);
+    });
+}
+
+template <typename T>
+void leakyRelu_into(OutputViewT<T> out, ConstMatrixViewT<T> input, double alpha) {
+    const T slope = static_cast<T>(alpha);
+    map_into<T>(out, input, [slope](T x) { return x > T(0) ? x : slope * x; });
+}
 
-    Matrix result(input.getRows(), input.getCols());
+template <typename T>
+void clip_into(OutputViewT<T> out, ConstMatrixViewT<T> input, double min_val, double max_val) {
+    const T lo = static_cast<T>(min_val);
+    const T hi = static_cast<T>(max_val);
+    map_into<T>(out, input, [lo, hi](T x) { return std::clamp(x, lo, hi); });
+}
 
-    if (axis == 1) {
-        // Normalize across columns
-        for (size_t i = 0; i < input.getRows(); ++i) {
-            double std_dev = std::sqrt(variance(i, 0) + epsilon);
-            for (size_t j = 0; j < input.getCols(); ++j) {
-                double normalized = (input(i, j) - mean(i, 0)) / std_dev;
-                result(i, j) = gamma(0, j) * normalized + beta(0, j);
-            }
-        }
-    } else if (axis == 0) {
-        // Normalize across rows
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            double std_dev = std::sqrt(variance(0, j) + epsilon);
-            for (size_t i = 0; i < input.getRows(); ++i) {
-                double normalized = (input(i, j) - mean(0, j)) / std_dev;
-                result(i, j) = gamma(i, 0) * normalized + beta(i, 0);
-            }
-        }
-    }
+// Allocating versions
+template <typename T>
+MatrixT<T> relu(const MatrixT<T>& input) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    relu_into(result, input);
+    return result;
+}
 
+template <typename T>
+MatrixT<T> reluDerivative(const MatrixT<T>& input) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    reluDerivative_into(result, input);
     return result;
 }
 
-Matrix sigmoid(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = 1.0 / (1.0 + std::exp(-input(i, j)));
-        }
-    }
+template <typename T>
+MatrixT<T> gelu(const MatrixT<T>& input) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    gelu_into(result, input);
     return result;
 }
 
-Matrix tanh(const Matrix& input) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = std::tanh(input(i, j));
-        }
-    }
+template <typename T>
+MatrixT<T> geluDerivative(const MatrixT<T>& input) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    geluDerivative_into(result, input);
     return result;
 }
 
-Matrix leakyRelu(const Matrix& input, double alpha) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = input(i, j) > 0.0 ? input(i, j) : alpha * input(i, j);
-        }
-    }
+template <typename T>
+MatrixT<T> softmax(const MatrixT<T>& input, int axis) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    softmax_into(result, input, axis);
     return result;
 }
 
-Matrix clip(const Matrix& input, double min_val, double max_val) {
-    Matrix result(input.getRows(), input.getCols());
-    for (size_t i = 0; i < input.getRows(); ++i) {
-        for (size_t j = 0; j < input.getCols(); ++j) {
-            result(i, j) = std::clamp(input(i, j), min_val, max_val);
-        }
-    }
+template <typename T>
+MatrixT<T> dropout(const MatrixT<T>& input, double dropout_rate, bool training) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    dropout_into(result, input, dropout_rate, training);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> layerNorm(const MatrixT<T>& input, const MatrixT<T>& gamma, const MatrixT<T>& beta,
+                 double epsilon, int axis) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    layerNorm_into(result, input, gamma, beta, epsilon, axis);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> sigmoid(const MatrixT<T>& input) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    sigmoid_into(result, input);
     return result;
 }
 
-} // namespace Act
\ No newline at end of file
+template <typename T>
+MatrixT<T> tanh(const MatrixT<T>& input) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    tanh_into(result, input);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> leakyRelu(const MatrixT<T>& input, double alpha) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    leakyRelu_into(result, input, alpha);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> clip(const MatrixT<T>& input, double min_val, double max_val) {
+    MatrixT<T> result(input.getRows(), input.getCols());
+    clip_into(result, input, min_val, max_val);
+    return result;
+}
+
+// In-place versions
+template <typename T>
+void relu_inplace(MatrixViewT<T> x) {
+    relu_into(x, ConstMatrixViewT<T>(x));
+}
+
+template <typename T>
+void gelu_inplace(MatrixViewT<T> x) {
+    gelu_into(x, ConstMatrixViewT<T>(x));
+}
+
+template <typename T>
+void softmax_inplace(MatrixViewT<T> x, int axis) {
+    softmax_into(x, ConstMatrixViewT<T>(x), axis);
+}
+
+template <typename T>
+void dropout_inplace(MatrixViewT<T> x, double dropout_rate, bool training) {
+    dropout_into(x, ConstMatrixViewT<T>(x), dropout_rate, training);
+}
+
+template <typename T>
+void layerNorm_inplace(MatrixViewT<T> x, ConstMatrixViewT<T> gamma, ConstMatrixViewT<T> beta,
+                       double epsilon, int axis) {
+    layerNorm_into(x, ConstMatrixViewT<T>(x), gamma, beta, epsilon, axis);
+}
+
+template <typename T>
+void sigmoid_inplace(MatrixViewT<T> x) {
+    sigmoid_into(x, ConstMatrixViewT<T>(x));
+}
+
+template <typename T>
+void tanh_inplace(MatrixViewT<T> x) {
+    tanh_into(x, ConstMatrixViewT<T>(x));
+}
+
+template <typename T>
+void leakyRelu_inplace(MatrixViewT<T> x, double alpha) {
+    leakyRelu_into(x, ConstMatrixViewT<T>(x), alpha);
+}
+
+template <typename T>
+void clip_inplace(MatrixViewT<T> x, double min_val, double max_val) {
+    clip_into(x, ConstMatrixViewT<T>(x), min_val, max_val);
+}
+
+// Explicit instantiations for the supported element types
+#define ACTIVATION_FUNCTIONS_INSTANTIATE(T) \
+    template MatrixT<T> relu(const MatrixT<T>&); \
+    template MatrixT<T> reluDerivative(const MatrixT<T>&); \
+    template MatrixT<T> gelu(const MatrixT<T>&); \
+    template MatrixT<T> geluDerivative(const MatrixT<T>&); \
+    template MatrixT<T> softmax(const MatrixT<T>&, int); \
+    template MatrixT<T> dropout(const MatrixT<T>&, double, bool); \
+    template std::pair<MatrixT<T>, MatrixT<T>> computeMeanAndVariance(const MatrixT<T>&, int); \
+    template MatrixT<T> layerNorm(const MatrixT<T>&, const MatrixT<T>&, const MatrixT<T>&, double, int); \
+    template MatrixT<T> sigmoid(const MatrixT<T>&); \
+    template MatrixT<T> tanh(const MatrixT<T>&); \
+    template MatrixT<T> leakyRelu(const MatrixT<T>&, double); \
+    template MatrixT<T> clip(const MatrixT<T>&, double, double); \
+    template void relu_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void reluDerivative_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void gelu_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void geluDerivative_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void softmax_into(OutputViewT<T>, ConstMatrixViewT<T>, int); \
+    template void dropout_into(OutputViewT<T>, ConstMatrixViewT<T>, double, bool); \
+    template void layerNorm_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>, double, int); \
+    template void sigmoid_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void tanh_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void leakyRelu_into(OutputViewT<T>, ConstMatrixViewT<T>, double); \
+    template void clip_into(OutputViewT<T>, ConstMatrixViewT<T>, double, double); \
+    template void relu_inplace(MatrixViewT<T>); \
+    template void gelu_inplace(MatrixViewT<T>); \
+    template void softmax_inplace(MatrixViewT<T>, int); \
+    template void dropout_inplace(MatrixViewT<T>, double, bool); \
+    template void layerNorm_inplace(MatrixViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>, double, int); \
+    template void sigmoid_inplace(MatrixViewT<T>); \
+    template void tanh_inplace(MatrixViewT<T>); \
+    template void leakyRelu_inplace(MatrixViewT<T>, double); \
+    template void clip_inplace(MatrixViewT<T>, double, double);
+
+ACTIVATION_FUNCTIONS_INSTANTIATE(float)
+ACTIVATION_FUNCTIONS_INSTANTIATE(double)
+
+#undef ACTIVATION_FUNCTIONS_INSTANTIATE
+
+} // namespace ActivationFunctions
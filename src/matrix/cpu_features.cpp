@@ -0,0 +1,85 @@
+#include "../../include/matrix/cpu_features.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+namespace CpuFeatures {
+
+namespace {
+
+constexpr const char* NAMES[] = {"generic", "sse4.2", "avx2", "avx512"};
+
+Isa detect() {
+#if VIT_MULTI_ISA
+    // libgcc only reports AVX/AVX-512 features when the OS saves their state
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+        return Isa::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c")) {
+        return Isa::Avx2;
+    }
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+        return Isa::Sse42;
+    }
+    return Isa::Generic;
+#else
+    return static_cast<Isa>(VIT_NATIVE_ISA);
+#endif
+}
+
+// Without VIT_MULTI_ISA the compiled level is the only one
+Isa cap(Isa isa) {
+    return VIT_MULTI_ISA && static_cast<int>(isa) < static_cast<int>(detected_isa()) ? isa : detected_isa();
+}
+
+Isa initial_isa() {
+    if (const char* env = std::getenv("VIT_ISA")) {
+        for (size_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); ++i) {
+            if (std::strcmp(env, NAMES[i]) == 0) {
+                return cap(static_cast<Isa>(i));
+            }
+        }
+    }
+    return detected_isa();
+}
+
+std::atomic<Isa>& current() {
+    static std::atomic<Isa> isa(initial_isa());
+    return isa;
+}
+
+} // namespace
+
+Isa detected_isa() {
+    static const Isa isa = detect();
+    return isa;
+}
+
+Isa active_isa() {
+    return current().load(std::memory_order_relaxed);
+}
+
+Isa set_isa(Isa isa) {
+    const Isa selected = cap(isa);
+    current().store(selected, std::memory_order_relaxed);
+    return selected;
+}
+
+bool has_avx512_vnni() {
+#if VIT_MULTI_ISA
+    static const bool vnni = detected_isa() == Isa::Avx512 && __builtin_cpu_supports("avx512vnni");
+    return vnni;
+#elif VIT_NATIVE_ISA == VIT_ISA_AVX512 && defined(__AVX512VNNI__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char* isa_name(Isa isa) {
+    return NAMES[static_cast<size_t>(isa)];
+}
+
+} // namespace CpuFeatures
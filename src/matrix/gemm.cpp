@@ -0,0 +1,100 @@
+#include "../../include/matrix/gemm.h"
+#include "../../include/matrix/cpu_features.h"
+#include "../../include/matrix/half.h"
+#include "../../include/matrix/memory.h"
+#include "../../include/matrix/thread_pool.h"
+#include "../../include/matrix/vector_math.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if VIT_ISA_INTRINSICS
+#include <immintrin.h>
+#endif
+
+namespace Gemm {
+
+namespace {
+
+// One copy of the engine per ISA level: generic::multiply, avx2::multiply, ...
+#define VIT_ISA_SOURCE "gemm_kernels.inl"
+#include "isa_variants.inl"
+
+} // namespace
+
+template <typename T>
+const BlockSizes& block_sizes() {
+    VIT_ISA_DISPATCH(blocking<T>());
+}
+
+template <typename T>
+void apply_epilogue(const Epilogue<T>& epilogue, size_t rows, size_t cols, T* c, size_t ldc) {
+    VIT_ISA_DISPATCH(run_epilogue(epilogue, rows, cols, c, ldc));
+}
+
+template <typename T>
+const char* kernel_name() {
+    VIT_ISA_DISPATCH(name<T>());
+}
+
+template <typename T, typename S>
+void gemm(size_t m, size_t n, size_t k, T alpha,
+          const T* a, size_t a_row_stride, size_t a_col_stride,
+          const S* b, size_t b_row_stride, size_t b_col_stride,
+          T beta, T* c, size_t ldc, const Epilogue<T>& epilogue) {
+    VIT_ISA_DISPATCH(multiply<T, S>(m, n, k, alpha, a, a_row_stride, a_col_stride,
+                                    b, b_row_stride, b_col_stride, beta, c, ldc, epilogue));
+}
+
+template <typename T>
+void gemm_strided_batched(size_t batch, size_t m, size_t n, size_t k, T alpha,
+                          const T* a, size_t a_row_stride, size_t a_col_stride, size_t a_batch_stride,
+                          const T* b, size_t b_row_stride, size_t b_col_stride, size_t b_batch_stride,
+                          T beta, T* c, size_t ldc, size_t c_batch_stride) {
+    VIT_ISA_DISPATCH(multiply_strided_batched(batch, m, n, k, alpha, a, a_row_stride, a_col_stride, a_batch_stride,
+                                              b, b_row_stride, b_col_stride, b_batch_stride,
+                                              beta, c, ldc, c_batch_stride));
+}
+
+template <typename T>
+void gemm_batched(size_t batch, size_t m, size_t n, size_t k, T alpha,
+                  const T* const* a, size_t a_row_stride, size_t a_col_stride,
+                  const T* const* b, size_t b_row_stride, size_t b_col_stride,
+                  T beta, T* const* c, size_t ldc) {
+    VIT_ISA_DISPATCH(multiply_batched(batch, m, n, k, alpha, a, a_row_stride, a_col_stride,
+                                      b, b_row_stride, b_col_stride, beta, c, ldc));
+}
+
+#define GEMM_INSTANTIATE(T, S) \
+    template void gemm<T, S>(size_t, size_t, size_t, T, const T*, size_t, size_t, \
+                             const S*, size_t, size_t, T, T*, size_t, const Epilogue<T>&);
+
+template const BlockSizes& block_sizes<float>();
+template const BlockSizes& block_sizes<double>();
+template const char* kernel_name<float>();
+template const char* kernel_name<double>();
+template void apply_epilogue(const Epilogue<float>&, size_t, size_t, float*, size_t);
+template void apply_epilogue(const Epilogue<double>&, size_t, size_t, double*, size_t);
+
+GEMM_INSTANTIATE(float, float)
+GEMM_INSTANTIATE(double, double)
+GEMM_INSTANTIATE(float, bf16)
+GEMM_INSTANTIATE(float, fp16)
+GEMM_INSTANTIATE(double, bf16)
+GEMM_INSTANTIATE(double, fp16)
+
+#undef GEMM_INSTANTIATE
+
+#define GEMM_BATCHED_INSTANTIATE(T) \
+    template void gemm_strided_batched<T>(size_t, size_t, size_t, size_t, T, \
+                                          const T*, size_t, size_t, size_t, \
+                                          const T*, size_t, size_t, size_t, T, T*, size_t, size_t); \
+    template void gemm_batched<T>(size_t, size_t, size_t, size_t, T, const T* const*, size_t, size_t, \
+                                  const T* const*, size_t, size_t, T, T* const*, size_t);
+
+GEMM_BATCHED_INSTANTIATE(float)
+GEMM_BATCHED_INSTANTIATE(double)
+
+#undef GEMM_BATCHED_INSTANTIATE
+
+} // namespace Gemm
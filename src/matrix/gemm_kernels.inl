@@ -0,0 +1,841 @@
+// Packed-panel GEMM engine (see gemm.h) for one ISA level. gemm.cpp
+// includes it once per level through isa_variants.inl, so there is no include
+// guard and every #if tests VIT_ISA_LEVEL; the entry points (multiply*,
+// run_epilogue, blocking, name) back the public Gemm functions.
+
+// ---------------------------------------------------------------------------
+// Micro-kernels: C[0:MR, 0:NR] = alpha * sum_p A[:, p] B[p, :] + beta * C
+// A is a packed MR-wide micro-panel, B a packed NR-wide micro-panel.
+// ---------------------------------------------------------------------------
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+
+struct Avx512Float {
+    using T = float;
+    using V = __m512;
+    static constexpr size_t WIDTH = 16;
+    static V zero() { return _mm512_setzero_ps(); }
+    static V set1(T x) { return _mm512_set1_ps(x); }
+    static V load(const T* p) { return _mm512_load_ps(p); }
+    static V loadu(const T* p) { return _mm512_loadu_ps(p); }
+    static void storeu(T* p, V v) { _mm512_storeu_ps(p, v); }
+    static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+};
+
+struct Avx512Double {
+    using T = double;
+    using V = __m512d;
+    static constexpr size_t WIDTH = 8;
+    static V zero() { return _mm512_setzero_pd(); }
+    static V set1(T x) { return _mm512_set1_pd(x); }
+    static V load(const T* p) { return _mm512_load_pd(p); }
+    static V loadu(const T* p) { return _mm512_loadu_pd(p); }
+    static void storeu(T* p, V v) { _mm512_storeu_pd(p, v); }
+    static V mul(V a, V b) { return _mm512_mul_pd(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm512_fmadd_pd(a, b, c); }
+};
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+struct Avx2Float {
+    using T = float;
+    using V = __m256;
+    static constexpr size_t WIDTH = 8;
+    static V zero() { return _mm256_setzero_ps(); }
+    static V set1(T x) { return _mm256_set1_ps(x); }
+    static V load(const T* p) { return _mm256_load_ps(p); }
+    static V loadu(const T* p) { return _mm256_loadu_ps(p); }
+    static void storeu(T* p, V v) { _mm256_storeu_ps(p, v); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+};
+
+struct Avx2Double {
+    using T = double;
+    using V = __m256d;
+    static constexpr size_t WIDTH = 4;
+    static V zero() { return _mm256_setzero_pd(); }
+    static V set1(T x) { return _mm256_set1_pd(x); }
+    static V load(const T* p) { return _mm256_load_pd(p); }
+    static V loadu(const T* p) { return _mm256_loadu_pd(p); }
+    static void storeu(T* p, V v) { _mm256_storeu_pd(p, v); }
+    static V mul(V a, V b) { return _mm256_mul_pd(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_pd(a, b, c); }
+};
+
+#endif
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+// Register-blocked kernel shared by every vector ISA: the tile is MR rows of
+// two SIMD vectors; each k step loads one B row and broadcasts MR A values
+template <typename S, size_t MR>
+void simd_micro_kernel(size_t kc, const typename S::T* A, const typename S::T* B,
+                       typename S::T* C, size_t ldc, typename S::T alpha, typename S::T beta) {
+    using T = typename S::T;
+    using V = typename S::V;
+    constexpr size_t W = S::WIDTH;
+
+    V c0[MR], c1[MR];
+#pragma GCC unroll 16
+    for (size_t i = 0; i < MR; ++i) {
+        c0[i] = S::zero();
+        c1[i] = S::zero();
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        const V b0 = S::load(B);
+        const V b1 = S::load(B + W);
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i) {
+            const V a = S::set1(A[i]);
+            c0[i] = S::fmadd(a, b0, c0[i]);
+            c1[i] = S::fmadd(a, b1, c1[i]);
+        }
+        A += MR;
+        B += 2 * W;
+    }
+
+    const V va = S::set1(alpha);
+    if (beta == T(0)) {
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i) {
+            S::storeu(C + i * ldc, S::mul(va, c0[i]));
+            S::storeu(C + i * ldc + W, S::mul(va, c1[i]));
+        }
+    } else {
+        const V vb = S::set1(beta);
+#pragma GCC unroll 16
+        for (size_t i = 0; i < MR; ++i) {
+            T* row = C + i * ldc;
+            S::storeu(row, S::fmadd(va, c0[i], S::mul(vb, S::loadu(row))));
+            S::storeu(row + W, S::fmadd(va, c1[i], S::mul(vb, S::loadu(row + W))));
+        }
+    }
+}
+
+#else
+
+// Portable kernel; fixed-size accumulators let the compiler keep the tile in
+// registers and vectorize the j loop for whatever ISA it targets
+template <typename T, size_t MR, size_t NR>
+void generic_micro_kernel(size_t kc, const T* A, const T* B,
+                          T* C, size_t ldc, T alpha, T beta) {
+    T acc[MR][NR] = {};
+
+    for (size_t p = 0; p < kc; ++p) {
+        for (size_t i = 0; i < MR; ++i) {
+            const T a = A[i];
+            for (size_t j = 0; j < NR; ++j) {
+                acc[i][j] += a * B[j];
+            }
+        }
+        A += MR;
+        B += NR;
+    }
+
+    for (size_t i = 0; i < MR; ++i) {
+        T* row = C + i * ldc;
+        if (beta == T(0)) {
+            for (size_t j = 0; j < NR; ++j) {
+                row[j] = alpha * acc[i][j];
+            }
+        } else {
+            for (size_t j = 0; j < NR; ++j) {
+                row[j] = alpha * acc[i][j] + beta * row[j];
+            }
+        }
+    }
+}
+
+#endif
+
+// Blocking and micro-kernel per element type. The vector kernels hold two
+// registers per tile row, so float tiles are twice as wide as double ones.
+template <typename T>
+struct Kernel;
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+
+template <>
+struct Kernel<double> {
+    static constexpr size_t MR = 12, NR = 16, MC = MR * 16, KC = 256, NC = 2048;
+    static constexpr const char* NAME = "avx512-fma 12x16 (f64)";
+    static void micro(size_t kc, const double* A, const double* B, double* C, size_t ldc,
+                      double alpha, double beta) {
+        simd_micro_kernel<Avx512Double, MR>(kc, A, B, C, ldc, alpha, beta);
+    }
+};
+
+template <>
+struct Kernel<float> {
+    static constexpr size_t MR = 12, NR = 32, MC = MR * 16, KC = 256, NC = 4096;
+    static constexpr const char* NAME = "avx512-fma 12x32 (f32)";
+    static void micro(size_t kc, const float* A, const float* B, float* C, size_t ldc,
+                      float alpha, float beta) {
+        simd_micro_kernel<Avx512Float, MR>(kc, A, B, C, ldc, alpha, beta);
+    }
+};
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+template <>
+struct Kernel<double> {
+    static constexpr size_t MR = 6, NR = 8, MC = MR * 20, KC = 256, NC = 2048;
+    static constexpr const char* NAME = "avx2-fma 6x8 (f64)";
+    static void micro(size_t kc, const double* A, const double* B, double* C, size_t ldc,
+                      double alpha, double beta) {
+        simd_micro_kernel<Avx2Double, MR>(kc, A, B, C, ldc, alpha, beta);
+    }
+};
+
+template <>
+struct Kernel<float> {
+    static constexpr size_t MR = 6, NR = 16, MC = MR * 20, KC = 256, NC = 4096;
+    static constexpr const char* NAME = "avx2-fma 6x16 (f32)";
+    static void micro(size_t kc, const float* A, const float* B, float* C, size_t ldc,
+                      float alpha, float beta) {
+        simd_micro_kernel<Avx2Float, MR>(kc, A, B, C, ldc, alpha, beta);
+    }
+};
+
+#else
+
+template <>
+struct Kernel<double> {
+    static constexpr size_t MR = 4, NR = 8, MC = MR * 24, KC = 256, NC = 2048;
+    static constexpr const char* NAME = VIT_ISA_LEVEL >= VIT_ISA_SSE42 ? "sse4.2 4x8 (f64)" : "generic 4x8 (f64)";
+    static void micro(size_t kc, const double* A, const double* B, double* C, size_t ldc,
+                      double alpha, double beta) {
+        generic_micro_kernel<double, MR, NR>(kc, A, B, C, ldc, alpha, beta);
+    }
+};
+
+template <>
+struct Kernel<float> {
+    static constexpr size_t MR = 4, NR = 8, MC = MR * 24, KC = 256, NC = 4096;
+    static constexpr const char* NAME = VIT_ISA_LEVEL >= VIT_ISA_SSE42 ? "sse4.2 4x8 (f32)" : "generic 4x8 (f32)";
+    static void micro(size_t kc, const float* A, const float* B, float* C, size_t ldc,
+                      float alpha, float beta) {
+        generic_micro_kernel<float, MR, NR>(kc, A, B, C, ldc, alpha, beta);
+    }
+};
+
+#endif
+
+template <typename T>
+const BlockSizes BLOCK_SIZES = {Kernel<T>::MR, Kernel<T>::NR, Kernel<T>::MC, Kernel<T>::KC, Kernel<T>::NC};
+
+template <typename T>
+const BlockSizes& blocking() {
+    return BLOCK_SIZES<T>;
+}
+
+template <typename T>
+const char* name() {
+    return Kernel<T>::NAME;
+}
+
+// Below this many multiply-adds packing costs more than it saves
+constexpr size_t SMALL_GEMM_FLOPS = 16 * 16 * 16;
+// Below this many multiply-adds waking the pool costs more than it saves
+constexpr size_t PARALLEL_GEMM_FLOPS = 64 * 64 * 64;
+
+// ---------------------------------------------------------------------------
+// Packing buffers (one pair per thread and type, grown on demand, 64-byte
+// aligned; a full KC x NC panel of B is large enough for huge pages)
+// ---------------------------------------------------------------------------
+
+template <typename T>
+struct PackBuffer {
+    T* ptr = nullptr;
+    size_t capacity = 0;
+
+    ~PackBuffer() { Memory::deallocate(ptr, capacity * sizeof(T)); }
+
+    T* reserve(size_t count) {
+        if (count > capacity) {
+            Memory::deallocate(ptr, capacity * sizeof(T));
+            ptr = nullptr;
+            capacity = 0;
+            size_t bytes = (count * sizeof(T) + 63) / 64 * 64;
+            ptr = static_cast<T*>(Memory::allocate(bytes));
+            capacity = bytes / sizeof(T);
+        }
+        return ptr;
+    }
+};
+
+template <typename T>
+thread_local PackBuffer<T> packed_a_buffer;
+template <typename T>
+thread_local PackBuffer<T> packed_b_buffer;
+
+// Packs an mc x kc block of A into MR-row micro-panels; each panel stores
+// MR consecutive values per k. Rows past mc are zero-filled.
+template <typename T>
+void pack_a(size_t mc, size_t kc, const T* a, size_t rs, size_t cs, T* dst) {
+    constexpr size_t MR = Kernel<T>::MR;
+    for (size_t i0 = 0; i0 < mc; i0 += MR) {
+        const size_t rows = std::min(MR, mc - i0);
+        const T* panel = a + i0 * rs;
+        if (rows == MR && cs == 1) {
+            // Row-major A: read each row contiguously
+            for (size_t i = 0; i < MR; ++i) {
+                const T* src = panel + i * rs;
+                for (size_t p = 0; p < kc; ++p) {
+                    dst[p * MR + i] = src[p];
+                }
+            }
+            dst += MR * kc;
+        } else if (rows == MR && rs == 1) {
+            // Transposed A: each k already holds MR consecutive rows
+            for (size_t p = 0; p < kc; ++p) {
+                std::memcpy(dst, panel + p * cs, MR * sizeof(T));
+                dst += MR;
+            }
+        } else {
+            for (size_t p = 0; p < kc; ++p) {
+                size_t i = 0;
+                for (; i < rows; ++i) {
+                    dst[i] = panel[i * rs + p * cs];
+                }
+                for (; i < MR; ++i) {
+                    dst[i] = T(0);
+                }
+                dst += MR;
+            }
+        }
+    }
+}
+
+// Element conversion applied while packing B: a no-op for same-type operands,
+// a widening to the compute type for 16-bit stored weights
+template <typename T>
+inline T widen(T value) { return value; }
+template <typename T>
+inline T widen(bf16 value) { return static_cast<T>(HalfPrecision::to_float(value)); }
+template <typename T>
+inline T widen(fp16 value) { return static_cast<T>(HalfPrecision::to_float(value)); }
+
+template <typename T>
+inline void widen_row(const T* src, T* dst, size_t count) { std::memcpy(dst, src, count * sizeof(T)); }
+inline void widen_row(const bf16* src, float* dst, size_t count) { HalfPrecision::to_float(src, dst, count); }
+inline void widen_row(const fp16* src, float* dst, size_t count) { HalfPrecision::to_float(src, dst, count); }
+inline void widen_row(const bf16* src, double* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) dst[i] = widen<double>(src[i]);
+}
+inline void widen_row(const fp16* src, double* dst, size_t count) {
+    for (size_t i = 0; i < count; ++i) dst[i] = widen<double>(src[i]);
+}
+
+// Returns src itself when no conversion is needed, otherwise widens it into scratch
+template <typename T>
+inline const T* widened(const T* src, T*, size_t) { return src; }
+template <typename T, typename S>
+inline const T* widened(const S* src, T* scratch, size_t count) {
+    widen_row(src, scratch, count);
+    return scratch;
+}
+
+// Packs a kc x nc block of B into NR-column micro-panels; each panel stores
+// NR consecutive values per k. Columns past nc are zero-filled. B may be
+// stored in a narrower type S; it is widened to T here, once per panel.
+template <typename T, typename S>
+void pack_b(size_t kc, size_t nc, const S* b, size_t rs, size_t cs, T* dst) {
+    constexpr size_t NR = Kernel<T>::NR;
+    alignas(64) T scratch[Kernel<T>::KC];
+    for (size_t j0 = 0; j0 < nc; j0 += NR) {
+        const size_t cols = std::min(NR, nc - j0);
+        const S* panel = b + j0 * cs;
+        if (cols == NR && cs == 1) {
+            for (size_t p = 0; p < kc; ++p) {
+                widen_row(panel + p * rs, dst, NR);
+                dst += NR;
+            }
+        } else if (cols == NR && rs == 1) {
+            // Transposed B: read each stored row (a column of op(B)) contiguously
+            for (size_t j = 0; j < NR; ++j) {
+                const T* src = widened(panel + j * cs, scratch, kc);
+                for (size_t p = 0; p < kc; ++p) {
+                    dst[p * NR + j] = src[p];
+                }
+            }
+            dst += NR * kc;
+        } else {
+            for (size_t p = 0; p < kc; ++p) {
+                size_t j = 0;
+                for (; j < cols; ++j) {
+                    dst[j] = widen<T>(panel[p * rs + j * cs]);
+                }
+                for (; j < NR; ++j) {
+                    dst[j] = T(0);
+                }
+                dst += NR;
+            }
+        }
+    }
+}
+
+// Gemm::apply_epilogue for this ISA
+template <typename T>
+void run_epilogue(const Epilogue<T>& epilogue, size_t rows, size_t cols, T* c, size_t ldc) {
+    for (size_t i = 0; i < rows; ++i) {
+        T* row = c + i * ldc;
+        if (epilogue.bias) {
+            for (size_t j = 0; j < cols; ++j) {
+                row[j] += epilogue.bias[j];
+            }
+        }
+        if (epilogue.activation == Activation::Gelu) {
+            VectorMath::gelu(row, row, cols);
+        }
+        if (epilogue.residual) {
+            const T* residual = epilogue.residual + i * epilogue.residual_ld;
+            for (size_t j = 0; j < cols; ++j) {
+                row[j] += residual[j];
+            }
+        }
+    }
+}
+
+// Multiplies a packed mc x kc block of A by a packed kc x nc panel of B.
+// epilogue (for the last slab only, positioned at c) runs once over the
+// whole block after its tiles are written: full-width rows keep GELU
+// vectorized, and the block is still in L2.
+template <typename T>
+void macro_kernel(size_t mc, size_t nc, size_t kc, const T* packed_a,
+                  const T* packed_b, T alpha, T beta, T* c, size_t ldc, const Epilogue<T>* epilogue) {
+    constexpr size_t MR = Kernel<T>::MR;
+    constexpr size_t NR = Kernel<T>::NR;
+    alignas(64) T edge[MR * NR];
+
+    for (size_t j0 = 0; j0 < nc; j0 += NR) {
+        const size_t cols = std::min(NR, nc - j0);
+        const T* b_panel = packed_b + j0 * kc;
+
+        for (size_t i0 = 0; i0 < mc; i0 += MR) {
+            const size_t rows = std::min(MR, mc - i0);
+            const T* a_panel = packed_a + i0 * kc;
+            T* c_tile = c + i0 * ldc + j0;
+
+            if (rows == MR && cols == NR) {
+                Kernel<T>::micro(kc, a_panel, b_panel, c_tile, ldc, alpha, beta);
+            } else {
+                // Partial tile: compute the full tile into scratch and merge
+                Kernel<T>::micro(kc, a_panel, b_panel, edge, NR, alpha, T(0));
+                for (size_t i = 0; i < rows; ++i) {
+                    T* row = c_tile + i * ldc;
+                    const T* src = edge + i * NR;
+                    if (beta == T(0)) {
+                        for (size_t j = 0; j < cols; ++j) {
+                            row[j] = src[j];
+                        }
+                    } else {
+                        for (size_t j = 0; j < cols; ++j) {
+                            row[j] = src[j] + beta * row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (epilogue) {
+        run_epilogue(*epilogue, mc, nc, c, ldc);
+    }
+}
+
+template <typename T>
+void scale_c(size_t m, size_t n, T beta, T* c, size_t ldc) {
+    for (size_t i = 0; i < m; ++i) {
+        T* row = c + i * ldc;
+        if (beta == T(0)) {
+            std::fill(row, row + n, T(0));
+        } else if (beta != T(1)) {
+            for (size_t j = 0; j < n; ++j) {
+                row[j] *= beta;
+            }
+        }
+    }
+}
+
+// Unpacked i-k-j loop for tiny products (e.g. per-head attention tiles)
+template <typename T>
+void small_gemm(size_t m, size_t n, size_t k, T alpha,
+                const T* a, size_t rsa, size_t csa,
+                const T* b, size_t rsb, size_t csb,
+                T beta, T* c, size_t ldc) {
+    if (csa == 1 && rsb == 1) {
+        // A row-major and B transposed: every C entry is a contiguous dot product
+        for (size_t i = 0; i < m; ++i) {
+            const T* a_row = a + i * rsa;
+            T* row = c + i * ldc;
+            for (size_t j = 0; j < n; ++j) {
+                const T* b_col = b + j * csb;
+                T total = T(0);
+                for (size_t p = 0; p < k; ++p) {
+                    total += a_row[p] * b_col[p];
+                }
+                row[j] = alpha * total + (beta == T(0) ? T(0) : beta * row[j]);
+            }
+        }
+        return;
+    }
+
+    scale_c(m, n, beta, c, ldc);
+    for (size_t i = 0; i < m; ++i) {
+        T* row = c + i * ldc;
+        for (size_t p = 0; p < k; ++p) {
+            const T a_ip = alpha * a[i * rsa + p * csa];
+            const T* b_row = b + p * rsb;
+            if (csb == 1) {
+                for (size_t j = 0; j < n; ++j) {
+                    row[j] += a_ip * b_row[j];
+                }
+            } else {
+                for (size_t j = 0; j < n; ++j) {
+                    row[j] += a_ip * b_row[j * csb];
+                }
+            }
+        }
+    }
+}
+
+template <typename T, typename S>
+void multiply(size_t m, size_t n, size_t k, T alpha,
+              const T* a, size_t a_row_stride, size_t a_col_stride,
+              const S* b, size_t b_row_stride, size_t b_col_stride,
+              T beta, T* c, size_t ldc, const Epilogue<T>& epilogue) {
+    constexpr size_t MR = Kernel<T>::MR;
+    constexpr size_t NR = Kernel<T>::NR;
+    constexpr size_t MC = Kernel<T>::MC;
+    constexpr size_t KC = Kernel<T>::KC;
+    constexpr size_t NC = Kernel<T>::NC;
+
+    if (m == 0 || n == 0) {
+        return;
+    }
+    const bool has_epilogue = !epilogue.empty();
+    if (k == 0 || alpha == T(0)) {
+        scale_c(m, n, beta, c, ldc);
+        if (has_epilogue) {
+            run_epilogue(epilogue, m, n, c, ldc);
+        }
+        return;
+    }
+    if constexpr (std::is_same<T, S>::value) {
+        // Narrow B always goes through packing, which widens it once
+        if (m * n * k <= SMALL_GEMM_FLOPS) {
+            small_gemm(m, n, k, alpha, a, a_row_stride, a_col_stride,
+                       b, b_row_stride, b_col_stride, beta, c, ldc);
+            if (has_epilogue) {
+                run_epilogue(epilogue, m, n, c, ldc);
+            }
+            return;
+        }
+    }
+
+    const size_t kc_max = std::min(KC, k);
+    const size_t mc_max = std::min(MC, (m + MR - 1) / MR * MR);
+    const size_t nc_max = std::min(NC, (n + NR - 1) / NR * NR);
+    T* packed_b = packed_b_buffer<T>.reserve(kc_max * nc_max);
+
+    // Work is split over (MC row block, run of NR panels) tasks. Row blocks
+    // alone are enough for tall products; short ones (e.g. one sample's 17
+    // tokens) also split the panels so every thread gets a share.
+    const size_t threads = m * n * k >= PARALLEL_GEMM_FLOPS ? ThreadPool::concurrency() : 1;
+    const size_t row_blocks = (m + MC - 1) / MC;
+
+    for (size_t jc = 0; jc < n; jc += NC) {
+        const size_t nc = std::min(NC, n - jc);
+        const size_t panels = (nc + NR - 1) / NR;
+        const size_t panel_runs = row_blocks >= threads
+            ? 1 : std::min(panels, (2 * threads + row_blocks - 1) / row_blocks);
+
+        for (size_t pc = 0; pc < k; pc += KC) {
+            const size_t kc = std::min(KC, k - pc);
+            // Only the first slab applies the caller's beta, only the last
+            // one the epilogue
+            const T slab_beta = (pc == 0) ? beta : T(1);
+            const bool last_slab = pc + kc == k;
+
+            // Pack B panel by panel (each panel is independent)
+            const S* b_slab = b + pc * b_row_stride + jc * b_col_stride;
+            parallel_for(panels, threads > 1 ? 1 : panels, [&](size_t first, size_t last) {
+                const size_t j0 = first * NR;
+                const size_t cols = std::min(nc, last * NR) - j0;
+                pack_b(kc, cols, b_slab + j0 * b_col_stride, b_row_stride, b_col_stride,
+                       packed_b + j0 * kc);
+            });
+
+            // Tasks are ordered row block first, so consecutive tasks on one
+            // thread reuse the A block it packed last
+            parallel_for(row_blocks * panel_runs, 1, [&](size_t first, size_t last) {
+                T* packed_a = packed_a_buffer<T>.reserve(mc_max * kc_max);
+                size_t packed_ic = m;
+                for (size_t task = first; task < last; ++task) {
+                    const size_t ic = task / panel_runs * MC;
+                    const size_t run = task % panel_runs;
+                    const size_t mc = std::min(MC, m - ic);
+                    if (ic != packed_ic) {
+                        pack_a(mc, kc, a + ic * a_row_stride + pc * a_col_stride,
+                               a_row_stride, a_col_stride, packed_a);
+                        packed_ic = ic;
+                    }
+                    const size_t j0 = run * panels / panel_runs * NR;
+                    const size_t j1 = std::min(nc, (run + 1) * panels / panel_runs * NR);
+                    const Epilogue<T> block = epilogue.at(ic, jc + j0);
+                    macro_kernel(mc, j1 - j0, kc, packed_a, packed_b + j0 * kc, alpha, slab_beta,
+                                 c + ic * ldc + jc + j0, ldc, has_epilogue && last_slab ? &block : nullptr);
+                }
+            });
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Batched products
+// ---------------------------------------------------------------------------
+
+// Problem p of a strided batch
+template <typename T>
+struct StridedBatch {
+    const T* a;
+    size_t a_stride;
+    const T* b;
+    size_t b_stride;
+    T* c;
+    size_t c_stride;
+
+    const T* a_at(size_t p) const { return a + p * a_stride; }
+    const T* b_at(size_t p) const { return b + p * b_stride; }
+    T* c_at(size_t p) const { return c + p * c_stride; }
+};
+
+// Problem p of a pointer batch
+template <typename T>
+struct PointerBatch {
+    const T* const* a;
+    const T* const* b;
+    T* const* c;
+
+    const T* a_at(size_t p) const { return a[p]; }
+    const T* b_at(size_t p) const { return b[p]; }
+    T* c_at(size_t p) const { return c[p]; }
+};
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+// Lane-interleaved kernel: W problems are computed at once, problem q in
+// vector lane q. A and B are packed so that element (i, l) of all W problems
+// is one aligned vector; each C tile is then an outer product over k, with
+// no broadcasts and no partial vectors however small m, n and k are.
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+template <typename T>
+using LaneVector = std::conditional_t<std::is_same<T, float>::value, Avx512Float, Avx512Double>;
+constexpr size_t LANE_TILE = 4;  // 4 x 4 accumulators of 32 registers
+#else
+template <typename T>
+using LaneVector = std::conditional_t<std::is_same<T, float>::value, Avx2Float, Avx2Double>;
+constexpr size_t LANE_TILE = 3;  // 3 x 3 accumulators of 16 registers
+#endif
+
+// Interleaving pays off while a problem cannot fill one register tile and the
+// packed copies of a group still fit in L2
+constexpr size_t INTERLEAVED_MAX_ELEMENTS = 64 * 1024;
+
+// out[(ri * RJ + rj) * W + q] = sum_l A_q(ri, l) * B_q(l, rj) for an RI x RJ tile;
+// a points at the tile's first packed row, b at its first packed column
+template <typename S, size_t RI, size_t RJ>
+void interleaved_tile(size_t k, size_t n, const typename S::T* a, const typename S::T* b,
+                      typename S::T* out) {
+    using V = typename S::V;
+    constexpr size_t W = S::WIDTH;
+
+    V acc[RI][RJ];
+#pragma GCC unroll 4
+    for (size_t ri = 0; ri < RI; ++ri) {
+#pragma GCC unroll 4
+        for (size_t rj = 0; rj < RJ; ++rj) {
+            acc[ri][rj] = S::zero();
+        }
+    }
+
+    for (size_t l = 0; l < k; ++l) {
+        V bv[RJ];
+#pragma GCC unroll 4
+        for (size_t rj = 0; rj < RJ; ++rj) {
+            bv[rj] = S::load(b + (l * n + rj) * W);
+        }
+#pragma GCC unroll 4
+        for (size_t ri = 0; ri < RI; ++ri) {
+            const V av = S::load(a + (ri * k + l) * W);
+#pragma GCC unroll 4
+            for (size_t rj = 0; rj < RJ; ++rj) {
+                acc[ri][rj] = S::fmadd(av, bv[rj], acc[ri][rj]);
+            }
+        }
+    }
+
+#pragma GCC unroll 4
+    for (size_t ri = 0; ri < RI; ++ri) {
+#pragma GCC unroll 4
+        for (size_t rj = 0; rj < RJ; ++rj) {
+            S::storeu(out + (ri * RJ + rj) * W, acc[ri][rj]);
+        }
+    }
+}
+
+// Edge tiles get their own instantiation so the accumulators stay in registers
+template <typename S, size_t RI>
+void interleaved_tile(size_t cols, size_t k, size_t n, const typename S::T* a,
+                      const typename S::T* b, typename S::T* out) {
+    switch (cols) {
+        case 4: interleaved_tile<S, RI, 4>(k, n, a, b, out); break;
+        case 3: interleaved_tile<S, RI, 3>(k, n, a, b, out); break;
+        case 2: interleaved_tile<S, RI, 2>(k, n, a, b, out); break;
+        default: interleaved_tile<S, RI, 1>(k, n, a, b, out); break;
+    }
+}
+
+template <typename S>
+void interleaved_tile(size_t rows, size_t cols, size_t k, size_t n, const typename S::T* a,
+                      const typename S::T* b, typename S::T* out) {
+    switch (rows) {
+        case 4: interleaved_tile<S, 4>(cols, k, n, a, b, out); break;
+        case 3: interleaved_tile<S, 3>(cols, k, n, a, b, out); break;
+        case 2: interleaved_tile<S, 2>(cols, k, n, a, b, out); break;
+        default: interleaved_tile<S, 1>(cols, k, n, a, b, out); break;
+    }
+}
+
+// Computes problems [first, first + lanes) of the batch, lanes <= W
+template <typename T, typename Batch>
+void interleaved_group(const Batch& batch, size_t first, size_t lanes,
+                       size_t m, size_t n, size_t k, T alpha,
+                       size_t rsa, size_t csa, size_t rsb, size_t csb, T beta, size_t ldc) {
+    using S = LaneVector<T>;
+    constexpr size_t W = S::WIDTH;
+
+    // packed_a[(i * k + l) * W + q] = alpha * A_q(i, l), packed_b[(l * n + j) * W + q] = B_q(l, j);
+    // unused lanes stay zero
+    T* packed_a = packed_a_buffer<T>.reserve(m * k * W);
+    T* packed_b = packed_b_buffer<T>.reserve(k * n * W);
+    if (lanes < W) {
+        std::fill(packed_a, packed_a + m * k * W, T(0));
+        std::fill(packed_b, packed_b + k * n * W, T(0));
+    }
+    const T* a_lane[W];
+    const T* b_lane[W];
+    for (size_t q = 0; q < lanes; ++q) {
+        a_lane[q] = batch.a_at(first + q);
+        b_lane[q] = batch.b_at(first + q);
+    }
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t l = 0; l < k; ++l) {
+            T* dst = packed_a + (i * k + l) * W;
+            const size_t offset = i * rsa + l * csa;
+            for (size_t q = 0; q < lanes; ++q) {
+                dst[q] = alpha * a_lane[q][offset];
+            }
+        }
+    }
+    for (size_t l = 0; l < k; ++l) {
+        for (size_t j = 0; j < n; ++j) {
+            T* dst = packed_b + (l * n + j) * W;
+            const size_t offset = l * rsb + j * csb;
+            for (size_t q = 0; q < lanes; ++q) {
+                dst[q] = b_lane[q][offset];
+            }
+        }
+    }
+
+    alignas(64) T tile[LANE_TILE * LANE_TILE * W];
+    for (size_t i0 = 0; i0 < m; i0 += LANE_TILE) {
+        const size_t rows = std::min(LANE_TILE, m - i0);
+        for (size_t j0 = 0; j0 < n; j0 += LANE_TILE) {
+            const size_t cols = std::min(LANE_TILE, n - j0);
+            interleaved_tile<S>(rows, cols, k, n, packed_a + i0 * k * W, packed_b + j0 * W, tile);
+
+            // Scatter each lane back to its own C
+            for (size_t q = 0; q < lanes; ++q) {
+                T* c = batch.c_at(first + q) + i0 * ldc + j0;
+                for (size_t ri = 0; ri < rows; ++ri) {
+                    for (size_t rj = 0; rj < cols; ++rj) {
+                        const T value = tile[(ri * cols + rj) * W + q];
+                        T& dst = c[ri * ldc + rj];
+                        dst = beta == T(0) ? value : value + beta * dst;
+                    }
+                }
+            }
+        }
+    }
+}
+
+#endif
+
+template <typename T, typename Batch>
+void gemm_batch(size_t count, size_t m, size_t n, size_t k, T alpha, const Batch& batch,
+                size_t rsa, size_t csa, size_t rsb, size_t csb, T beta, size_t ldc) {
+    if (count == 0 || m == 0 || n == 0) {
+        return;
+    }
+    const size_t flops = m * n * k;
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    constexpr size_t W = LaneVector<T>::WIDTH;
+    const bool too_small_for_tile = m < Kernel<T>::MR || n < Kernel<T>::NR;
+    if (k > 0 && alpha != T(0) && count > 1 && too_small_for_tile &&
+        (m * k + k * n) * W <= INTERLEAVED_MAX_ELEMENTS) {
+        // Each chunk of groups carries at least PARALLEL_GEMM_FLOPS of work
+        const size_t groups = (count + W - 1) / W;
+        const size_t grain = std::max<size_t>(1, PARALLEL_GEMM_FLOPS / (flops * W));
+        parallel_for(groups, grain, [&](size_t first, size_t last) {
+            for (size_t g = first; g < last; ++g) {
+                interleaved_group(batch, g * W, std::min(W, count - g * W), m, n, k, alpha,
+                                  rsa, csa, rsb, csb, beta, ldc);
+            }
+        });
+        return;
+    }
+#endif
+
+    // One problem per task when there are enough of them to go round;
+    // otherwise each product parallelizes internally
+    if (count >= ThreadPool::concurrency()) {
+        const size_t grain = std::max<size_t>(1, PARALLEL_GEMM_FLOPS / std::max<size_t>(1, flops));
+        parallel_for(count, grain, [&](size_t first, size_t last) {
+            for (size_t p = first; p < last; ++p) {
+                multiply<T, T>(m, n, k, alpha, batch.a_at(p), rsa, csa, batch.b_at(p), rsb, csb,
+                               beta, batch.c_at(p), ldc, Epilogue<T>());
+            }
+        });
+    } else {
+        for (size_t p = 0; p < count; ++p) {
+            multiply<T, T>(m, n, k, alpha, batch.a_at(p), rsa, csa, batch.b_at(p), rsb, csb,
+                           beta, batch.c_at(p), ldc, Epilogue<T>());
+        }
+    }
+}
+
+template <typename T>
+void multiply_strided_batched(size_t batch, size_t m, size_t n, size_t k, T alpha,
+                              const T* a, size_t a_row_stride, size_t a_col_stride, size_t a_batch_stride,
+                              const T* b, size_t b_row_stride, size_t b_col_stride, size_t b_batch_stride,
+                              T beta, T* c, size_t ldc, size_t c_batch_stride) {
+    const StridedBatch<T> problems{a, a_batch_stride, b, b_batch_stride, c, c_batch_stride};
+    gemm_batch(batch, m, n, k, alpha, problems, a_row_stride, a_col_stride,
+               b_row_stride, b_col_stride, beta, ldc);
+}
+
+template <typename T>
+void multiply_batched(size_t batch, size_t m, size_t n, size_t k, T alpha,
+                      const T* const* a, size_t a_row_stride, size_t a_col_stride,
+                      const T* const* b, size_t b_row_stride, size_t b_col_stride,
+                      T beta, T* const* c, size_t ldc) {
+    const PointerBatch<T> problems{a, b, c};
+    gemm_batch(batch, m, n, k, alpha, problems, a_row_stride, a_col_stride,
+               b_row_stride, b_col_stride, beta, ldc);
+}
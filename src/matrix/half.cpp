@@ -0,0 +1,223 @@
+
+#include "../../include/matrix/half.h"
+#include "../../include/matrix/cpu_features.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if VIT_ISA_INTRINSICS || defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+// GCC 12 reports the deliberately undefined pass-through operand inside the
+// AVX-512 conversion intrinsics as maybe-uninitialized
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace HalfPrecision {
+
+namespace {
+
+inline uint32_t float_bits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline float bits_float(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Scalar conversions
+// ---------------------------------------------------------------------------
+
+float to_float(bf16 value) {
+    // bf16 is the upper half of an fp32
+    return bits_float(static_cast<uint32_t>(value.bits) << 16);
+}
+
+bf16 to_bf16(float value) {
+    uint32_t bits = float_bits(value);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        // NaN: truncate and force the quiet bit so the payload cannot become Inf
+        return bf16{static_cast<uint16_t>((bits >> 16) | 0x0040u)};
+    }
+    // Round to nearest, ties to even
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return bf16{static_cast<uint16_t>(bits >> 16)};
+}
+
+float to_float(fp16 value) {
+#if defined(__F16C__)
+    return _cvtsh_ss(value.bits);
+#else
+    // Rebias the exponent with a multiply so normals, subnormals, Inf and NaN
+    // all come out exact without branching on the exponent field
+    const uint32_t w = static_cast<uint32_t>(value.bits) << 16;
+    const uint32_t sign = w & 0x80000000u;
+    const uint32_t two_w = w + w;
+
+    const float normalized = bits_float((two_w >> 4) + (0xE0u << 23)) * 0x1.0p-112f;
+    const float denormalized = bits_float((two_w >> 17) | (126u << 23)) - 0.5f;
+    const uint32_t result = two_w < (1u << 27) ? float_bits(denormalized) : float_bits(normalized);
+    return bits_float(sign | result);
+#endif
+}
+
+fp16 to_fp16(float value) {
+#if defined(__F16C__)
+    return fp16{static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT))};
+#else
+    // Scale into binary16 range so the FPU performs round-to-nearest-even on
+    // the dropped mantissa bits (and overflows to Inf where binary16 would)
+    float base = (std::abs(value) * 0x1.0p+112f) * 0x1.0p-110f;
+    const uint32_t w = float_bits(value);
+    const uint32_t shl1_w = w + w;
+    const uint32_t sign = w & 0x80000000u;
+    uint32_t bias = shl1_w & 0xFF000000u;
+    if (bias < 0x71000000u) {
+        bias = 0x71000000u;
+    }
+
+    base = bits_float((bias >> 1) + 0x07800000u) + base;
+    const uint32_t bits = float_bits(base);
+    const uint32_t exp_bits = (bits >> 13) & 0x00007C00u;
+    const uint32_t mantissa_bits = bits & 0x00000FFFu;
+    const uint32_t nonsign = exp_bits + mantissa_bits;
+    return fp16{static_cast<uint16_t>((sign >> 16) | (shl1_w > 0xFF000000u ? 0x7E00u : nonsign))};
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Bulk conversions
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// One copy per ISA level: generic::to_float, avx2::to_float, ...
+#define VIT_ISA_SOURCE "half_kernels.inl"
+#include "isa_variants.inl"
+
+} // namespace
+
+void to_float(const bf16* src, float* dst, size_t count) {
+    VIT_ISA_DISPATCH(to_float(src, dst, count));
+}
+
+void from_float(const float* src, bf16* dst, size_t count) {
+    VIT_ISA_DISPATCH(from_float(src, dst, count));
+}
+
+void to_float(const fp16* src, float* dst, size_t count) {
+    VIT_ISA_DISPATCH(to_float(src, dst, count));
+}
+
+void from_float(const float* src, fp16* dst, size_t count) {
+    VIT_ISA_DISPATCH(from_float(src, dst, count));
+}
+
+const char* kernel_name() {
+    VIT_ISA_DISPATCH(name());
+}
+
+} // namespace HalfPrecision
+
+// ---------------------------------------------------------------------------
+// HalfMatrix
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Narrows one row; double rows go through fp32 (the widest type both formats round from)
+void narrow_row(const float* src, uint16_t* dst, size_t count, StorageType type) {
+    if (type == StorageType::BFloat16) {
+        HalfPrecision::from_float(src, reinterpret_cast<bf16*>(dst), count);
+    } else {
+        HalfPrecision::from_float(src, reinterpret_cast<fp16*>(dst), count);
+    }
+}
+
+void narrow_row(const double* src, uint16_t* dst, size_t count, StorageType type) {
+    for (size_t j = 0; j < count; ++j) {
+        const float value = static_cast<float>(src[j]);
+        dst[j] = type == StorageType::BFloat16 ? HalfPrecision::to_bf16(value).bits
+                                               : HalfPrecision::to_fp16(value).bits;
+    }
+}
+
+void widen_row(const uint16_t* src, float* dst, size_t count, StorageType type) {
+    if (type == StorageType::BFloat16) {
+        HalfPrecision::to_float(reinterpret_cast<const bf16*>(src), dst, count);
+    } else {
+        HalfPrecision::to_float(reinterpret_cast<const fp16*>(src), dst, count);
+    }
+}
+
+void widen_row(const uint16_t* src, double* dst, size_t count, StorageType type) {
+    for (size_t j = 0; j < count; ++j) {
+        dst[j] = type == StorageType::BFloat16 ? HalfPrecision::to_float(bf16{src[j]})
+                                               : HalfPrecision::to_float(fp16{src[j]});
+    }
+}
+
+} // namespace
+
+HalfMatrix::HalfMatrix() : type(StorageType::BFloat16), rows(0), cols(0) {}
+
+template <typename T>
+HalfMatrix::HalfMatrix(ConstMatrixViewT<T> source, StorageType type) : HalfMatrix() {
+    assign(source, type);
+}
+
+template <typename T>
+void HalfMatrix::assign(ConstMatrixViewT<T> source, StorageType new_type) {
+    if (new_type != StorageType::BFloat16 && new_type != StorageType::Float16) {
+        throw std::invalid_argument("HalfMatrix stores only BFloat16 or Float16");
+    }
+
+    type = new_type;
+    rows = source.getRows();
+    cols = source.getCols();
+    buffer.resize(rows * cols);
+    for (size_t i = 0; i < rows; ++i) {
+        narrow_row(source.row_ptr(i), buffer.data() + i * cols, cols, type);
+    }
+}
+
+void HalfMatrix::to_matrix(MatrixViewT<float> dst) const {
+    if (dst.getRows() != rows || dst.getCols() != cols) {
+        throw std::invalid_argument("Destination must have the same dimensions as the HalfMatrix");
+    }
+
+    for (size_t i = 0; i < rows; ++i) {
+        widen_row(buffer.data() + i * cols, dst.row_ptr(i), cols, type);
+    }
+}
+
+void HalfMatrix::to_matrix(MatrixViewT<double> dst) const {
+    if (dst.getRows() != rows || dst.getCols() != cols) {
+        throw std::invalid_argument("Destination must have the same dimensions as the HalfMatrix");
+    }
+
+    for (size_t i = 0; i < rows; ++i) {
+        widen_row(buffer.data() + i * cols, dst.row_ptr(i), cols, type);
+    }
+}
+
+void HalfMatrix::clear() {
+    rows = 0;
+    cols = 0;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+template HalfMatrix::HalfMatrix(ConstMatrixViewT<float>, StorageType);
+template HalfMatrix::HalfMatrix(ConstMatrixViewT<double>, StorageType);
+template void HalfMatrix::assign(ConstMatrixViewT<float>, StorageType);
+template void HalfMatrix::assign(ConstMatrixViewT<double>, StorageType);
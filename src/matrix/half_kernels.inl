@@ -0,0 +1,114 @@
+// Bulk bf16/fp16 conversions (see half.h) for one ISA level. half.cpp
+// includes it once per level through isa_variants.inl, so there is no
+// include guard and every #if tests VIT_ISA_LEVEL (AVX512-BF16 is only used
+// when the compile flags enable it). The loop tails and the levels without
+// vector code use the scalar conversions.
+
+void to_float(const bf16* src, float* dst, size_t count) {
+    size_t i = 0;
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    for (; i + 16 <= count; i += 16) {
+        __m512i wide = _mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+        _mm512_storeu_ps(dst + i, _mm512_castsi512_ps(_mm512_slli_epi32(wide, 16)));
+    }
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    for (; i + 8 <= count; i += 8) {
+        __m256i wide = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(wide, 16)));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = HalfPrecision::to_float(src[i]);
+    }
+}
+
+void from_float(const float* src, bf16* dst, size_t count) {
+    size_t i = 0;
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512 && defined(__AVX512BF16__)
+    for (; i + 16 <= count; i += 16) {
+        __m256bh narrow = _mm512_cvtneps_pbh(_mm512_loadu_ps(src + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), reinterpret_cast<__m256i&>(narrow));
+    }
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    const __m512i abs_mask = _mm512_set1_epi32(0x7FFFFFFF);
+    const __m512i inf = _mm512_set1_epi32(0x7F800000);
+    const __m512i round = _mm512_set1_epi32(0x7FFF);
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i quiet = _mm512_set1_epi32(0x0040);
+    for (; i + 16 <= count; i += 16) {
+        __m512i bits = _mm512_castps_si512(_mm512_loadu_ps(src + i));
+        __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(bits, 16), one);
+        __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(bits, _mm512_add_epi32(round, lsb)), 16);
+        __m512i nan = _mm512_or_si512(_mm512_srli_epi32(bits, 16), quiet);
+        __mmask16 is_nan = _mm512_cmpgt_epi32_mask(_mm512_and_si512(bits, abs_mask), inf);
+        __m512i result = _mm512_mask_blend_epi32(is_nan, rounded, nan);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_cvtepi32_epi16(result));
+    }
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    const __m256i abs_mask = _mm256_set1_epi32(0x7FFFFFFF);
+    const __m256i inf = _mm256_set1_epi32(0x7F800000);
+    const __m256i round = _mm256_set1_epi32(0x7FFF);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i quiet = _mm256_set1_epi32(0x0040);
+    for (; i + 8 <= count; i += 8) {
+        __m256i bits = _mm256_castps_si256(_mm256_loadu_ps(src + i));
+        __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), one);
+        __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, _mm256_add_epi32(round, lsb)), 16);
+        __m256i nan = _mm256_or_si256(_mm256_srli_epi32(bits, 16), quiet);
+        __m256i is_nan = _mm256_cmpgt_epi32(_mm256_and_si256(bits, abs_mask), inf);
+        __m256i result = _mm256_blendv_epi8(rounded, nan, is_nan);
+        // Pack 32 -> 16 bits; packus works per 128-bit lane, so gather the halves
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(result, result), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(packed));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = HalfPrecision::to_bf16(src[i]);
+    }
+}
+
+void to_float(const fp16* src, float* dst, size_t count) {
+    size_t i = 0;
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    for (; i + 16 <= count; i += 16) {
+        _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i))));
+    }
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = HalfPrecision::to_float(src[i]);
+    }
+}
+
+void from_float(const float* src, fp16* dst, size_t count) {
+    size_t i = 0;
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    for (; i + 16 <= count; i += 16) {
+        __m256i narrow = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), narrow);
+    }
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    for (; i + 8 <= count; i += 8) {
+        __m128i narrow = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), narrow);
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = HalfPrecision::to_fp16(src[i]);
+    }
+}
+
+const char* name() {
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512 && defined(__AVX512BF16__)
+    return "bf16: avx512-bf16, fp16: avx512f";
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    return "bf16: avx512f, fp16: avx512f";
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    return "bf16: avx2, fp16: f16c";
+#else
+    return "bf16: scalar, fp16: scalar";
+#endif
+}
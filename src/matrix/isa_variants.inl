@@ -0,0 +1,62 @@
+// Compiles the kernel source named by VIT_ISA_SOURCE once per ISA level
+// (see cpu_features.h). Each copy lands in its own namespace, under the
+// target options of its level, with VIT_ISA_LEVEL set for the source's #if
+// blocks (the compiler's own __AVX2__-style macros do not follow
+// #pragma GCC target in C++). Include it inside the module's namespace, after
+// every header the source needs; VIT_ISA_DISPATCH picks the copy. Without
+// VIT_MULTI_ISA the generic namespace holds the only copy, built at
+// VIT_NATIVE_ISA.
+
+// GCC 12's AVX-512 headers build _mm512_undefined_*() from a self-initialized
+// local, which -Wall reports as "'__Y' may be used uninitialized" wherever an
+// intrinsic using it is inlined into a #pragma GCC target copy. The value is
+// never read (the write mask is all ones), so the warnings are silenced
+// around the kernel copies only.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+#if VIT_MULTI_ISA
+#define VIT_ISA_LEVEL VIT_ISA_GENERIC
+#else
+#define VIT_ISA_LEVEL VIT_NATIVE_ISA
+#endif
+namespace generic {
+#include VIT_ISA_SOURCE
+}
+#undef VIT_ISA_LEVEL
+
+#if VIT_MULTI_ISA
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2,popcnt")
+#define VIT_ISA_LEVEL VIT_ISA_SSE42
+namespace sse42 {
+#include VIT_ISA_SOURCE
+}
+#undef VIT_ISA_LEVEL
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c,bmi,bmi2,lzcnt,popcnt")
+#define VIT_ISA_LEVEL VIT_ISA_AVX2
+namespace avx2 {
+#include VIT_ISA_SOURCE
+}
+#undef VIT_ISA_LEVEL
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512dq,avx512vl,avx2,fma,f16c,bmi,bmi2,lzcnt,popcnt")
+#define VIT_ISA_LEVEL VIT_ISA_AVX512
+namespace avx512 {
+#include VIT_ISA_SOURCE
+}
+#undef VIT_ISA_LEVEL
+#pragma GCC pop_options
+
+#endif
+
+#pragma GCC diagnostic pop
+
+#undef VIT_ISA_SOURCE
@@ -1,216 +1,313 @@
 
 #include "../../include/matrix/matrix.h"
-#include <random>
+#include "../../include/matrix/memory.h"
+#include "../../include/matrix/random.h"
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <new>
+#include <type_traits>
+
+// Storage management
+template <typename T>
+void MatrixT<T>::allocate(size_t count) {
+    ptr = nullptr;
+    capacity = 0;
+    if (count == 0) {
+        return;
+    }
+
+    // Large buffers (e.g. a whole dataset) get huge pages, see memory.h
+    size_t bytes = count * sizeof(T);
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    ptr = static_cast<T*>(Memory::allocate(bytes));
+    capacity = bytes / sizeof(T);
+}
+
+template <typename T>
+void MatrixT<T>::release() {
+    Memory::deallocate(buffer(), capacity * sizeof(T));
+    ptr = nullptr;
+    capacity = 0;
+}
 
 // Default constructor
-Matrix::Matrix() : rows(0), cols(0) {}
+template <typename T>
+MatrixT<T>::MatrixT() : capacity(0) {}
 
 // Parameterized constructor
-Matrix::Matrix(size_t rows, size_t cols, double value)
-    : rows(rows), cols(cols), data(rows, std::vector<double>(cols, value)) {}
+template <typename T>
+MatrixT<T>::MatrixT(size_t rows, size_t cols, T value) : capacity(0) {
+    set_shape(rows, cols);
+    allocate(rows * cols);
+    std::fill(buffer(), buffer() + rows * cols, value);
+}
 
 // Initializer list constructor
-Matrix::Matrix(const std::initializer_list<std::initializer_list<double>>& init_list) {
-    rows = init_list.size();
-    if (rows == 0) {
-        cols = 0;
+template <typename T>
+MatrixT<T>::MatrixT(const std::initializer_list<std::initializer_list<T>>& init_list)
+    : capacity(0) {
+    if (init_list.size() == 0) {
         return;
     }
 
-    cols = init_list.begin()->size();
-    data.resize(rows);
-
-    size_t i = 0;
+    size_t init_cols = init_list.begin()->size();
     for (const auto& row : init_list) {
-        if (row.size() != cols) {
+        if (row.size() != init_cols) {
             throw std::invalid_argument("All rows must have the same number of columns");
         }
-        data[i].assign(row.begin(), row.end());
-        ++i;
+    }
+
+    set_shape(init_list.size(), init_cols);
+    allocate(rows * cols);
+
+    T* dst = buffer();
+    for (const auto& row : init_list) {
+        dst = std::copy(row.begin(), row.end(), dst);
+    }
+}
+
+// View constructor
+template <typename T>
+MatrixT<T>::MatrixT(const ConstMatrixViewT<T>& view) : capacity(0) {
+    set_shape(view.getRows(), view.getCols());
+    allocate(rows * cols);
+    for (size_t i = 0; i < rows; ++i) {
+        std::memcpy(row_ptr(i), view.row_ptr(i), cols * sizeof(T));
     }
 }
 
 // Copy constructor
-Matrix::Matrix(const Matrix& other)
-    : rows(other.rows), cols(other.cols), data(other.data) {}
+template <typename T>
+MatrixT<T>::MatrixT(const MatrixT& other) : Base(), capacity(0) {
+    set_shape(other.rows, other.cols);
+    allocate(rows * cols);
+    if (rows * cols > 0) {
+        std::memcpy(buffer(), other.ptr, rows * cols * sizeof(T));
+    }
+}
 
 // Copy assignment
-Matrix& Matrix::operator=(const Matrix& other) {
+template <typename T>
+MatrixT<T>& MatrixT<T>::operator=(const MatrixT& other) {
     if (this != &other) {
-        rows = other.rows;
-        cols = other.cols;
-        data = other.data;
+        size_t count = other.rows * other.cols;
+        if (count > capacity) {
+            release();
+            allocate(count);
+        }
+        set_shape(other.rows, other.cols);
+        if (count > 0) {
+            std::memcpy(buffer(), other.ptr, count * sizeof(T));
+        }
     }
     return *this;
 }
 
 // Move constructor
-Matrix::Matrix(Matrix&& other) noexcept
-    : rows(other.rows), cols(other.cols), data(std::move(other.data)) {
-    other.rows = 0;
-    other.cols = 0;
+template <typename T>
+MatrixT<T>::MatrixT(MatrixT&& other) noexcept : Base(other), capacity(other.capacity) {
+    other.ptr = nullptr;
+    other.set_shape(0, 0);
+    other.capacity = 0;
 }
 
 // Move assignment
-Matrix& Matrix::operator=(Matrix&& other) noexcept {
+template <typename T>
+MatrixT<T>& MatrixT<T>::operator=(MatrixT&& other) noexcept {
     if (this != &other) {
-        rows = other.rows;
-        cols = other.cols;
-        data = std::move(other.data);
-        other.rows = 0;
-        other.cols = 0;
+        release();
+        ptr = other.ptr;
+        set_shape(other.rows, other.cols);
+        capacity = other.capacity;
+        other.ptr = nullptr;
+        other.set_shape(0, 0);
+        other.capacity = 0;
     }
     return *this;
 }
 
-// Element access
-double& Matrix::operator()(size_t row, size_t col) {
+// Destructor
+template <typename T>
+MatrixT<T>::~MatrixT() {
+    release();
+}
+
+// Checked element access
+template <typename T>
+T& MatrixT<T>::at(size_t row, size_t col) {
     if (row >= rows || col >= cols) {
         throw std::out_of_range("Matrix indices out of range");
     }
-    return data[row][col];
+    return buffer()[row * cols + col];
 }
 
-const double& Matrix::operator()(size_t row, size_t col) const {
+template <typename T>
+const T& MatrixT<T>::at(size_t row, size_t col) const {
     if (row >= rows || col >= cols) {
         throw std::out_of_range("Matrix indices out of range");
     }
-    return data[row][col];
+    return ptr[row * cols + col];
 }
 
 // Utility functions
-void Matrix::fill(double value) {
-    for (auto& row : data) {
-        std::fill(row.begin(), row.end(), value);
+template <typename T>
+void MatrixT<T>::fill(T value) {
+    std::fill(buffer(), buffer() + rows * cols, value);
+}
+
+template <typename T>
+void MatrixT<T>::resize(size_t new_rows, size_t new_cols, T value) {
+    // Reuse the existing buffer whenever it is large enough
+    size_t count = new_rows * new_cols;
+    if (count > capacity) {
+        release();
+        allocate(count);
     }
+    set_shape(new_rows, new_cols);
+    std::fill(buffer(), buffer() + count, value);
 }
 
-void Matrix::resize(size_t new_rows, size_t new_cols, double value) {
-    rows = new_rows;
-    cols = new_cols;
-    data.assign(rows, std::vector<double>(cols, value));
+template <typename T>
+void MatrixT<T>::resize_uninitialized(size_t new_rows, size_t new_cols) {
+    size_t count = new_rows * new_cols;
+    if (count > capacity) {
+        release();
+        allocate(count);
+    }
+    set_shape(new_rows, new_cols);
+}
+
+template <typename T>
+void MatrixT<T>::reshape(size_t new_rows, size_t new_cols) {
+    if (new_rows * new_cols != rows * cols) {
+        throw std::invalid_argument("Reshape must preserve the number of elements");
+    }
+    set_shape(new_rows, new_cols);
 }
 
-void Matrix::print() const {
-    for (const auto& row : data) {
-        for (const auto& elem : row) {
-            std::cout << std::setw(8) << std::fixed << std::setprecision(3) << elem << " ";
+template <typename T>
+void MatrixT<T>::print() const {
+    for (size_t i = 0; i < rows; ++i) {
+        const T* row = row_ptr(i);
+        for (size_t j = 0; j < cols; ++j) {
+            std::cout << std::setw(8) << std::fixed << std::setprecision(3) << row[j] << " ";
         }
         std::cout << std::endl;
     }
 }
 
 // Static factory methods
-Matrix Matrix::zeros(size_t rows, size_t cols) {
-    return Matrix(rows, cols, 0.0);
+template <typename T>
+MatrixT<T> MatrixT<T>::zeros(size_t rows, size_t cols) {
+    return MatrixT(rows, cols, T(0));
 }
 
-Matrix Matrix::ones(size_t rows, size_t cols) {
-    return Matrix(rows, cols, 1.0);
+template <typename T>
+MatrixT<T> MatrixT<T>::ones(size_t rows, size_t cols) {
+    return MatrixT(rows, cols, T(1));
 }
 
-Matrix Matrix::identity(size_t size) {
-    Matrix result(size, size, 0.0);
+template <typename T>
+MatrixT<T> MatrixT<T>::identity(size_t size) {
+    MatrixT result(size, size, T(0));
     for (size_t i = 0; i < size; ++i) {
-        result(i, i) = 1.0;
+        result(i, i) = T(1);
     }
     return result;
 }
 
-Matrix Matrix::random(size_t rows, size_t cols, double min, double max) {
-    Matrix result(rows, cols);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<double> dis(min, max);
-
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = dis(gen);
-        }
-    }
+template <typename T>
+MatrixT<T> MatrixT<T>::random(size_t rows, size_t cols, double min, double max) {
+    MatrixT result(rows, cols);
+    Random::uniform(result.data(), rows * cols, min, max);
     return result;
 }
 
-// Basic operators
-Matrix Matrix::operator+(const Matrix& other) const {
-    if (rows != other.rows || cols != other.cols) {
+// Compound assignment
+template <typename T>
+MatrixT<T>& MatrixT<T>::operator+=(const ConstMatrixViewT<T>& other) {
+    if (rows != other.getRows() || cols != other.getCols()) {
         throw std::invalid_argument("Matrices must have the same dimensions for addition");
     }
 
-    Matrix result(rows, cols);
     for (size_t i = 0; i < rows; ++i) {
+        const T* b = other.row_ptr(i);
+        T* out = row_ptr(i);
         for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = data[i][j] + other.data[i][j];
+            out[j] += b[j];
         }
     }
-    return result;
+    return *this;
 }
 
-Matrix Matrix::operator-(const Matrix& other) const {
-    if (rows != other.rows || cols != other.cols) {
+template <typename T>
+MatrixT<T>& MatrixT<T>::operator-=(const ConstMatrixViewT<T>& other) {
+    if (rows != other.getRows() || cols != other.getCols()) {
         throw std::invalid_argument("Matrices must have the same dimensions for subtraction");
     }
 
-    Matrix result(rows, cols);
     for (size_t i = 0; i < rows; ++i) {
+        const T* b = other.row_ptr(i);
+        T* out = row_ptr(i);
         for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = data[i][j] - other.data[i][j];
+            out[j] -= b[j];
         }
     }
-    return result;
-}
-
-Matrix Matrix::operator*(double scalar) const {
-    Matrix result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            result(i, j) = data[i][j] * scalar;
-        }
-    }
-    return result;
+    return *this;
 }
 
-Matrix Matrix::operator/(double scalar) const {
-    if (scalar == 0.0) {
-        throw std::invalid_argument("Division by zero");
+template <typename T>
+MatrixT<T>& MatrixT<T>::operator*=(T scalar) {
+    T* out = buffer();
+    for (size_t i = 0; i < rows * cols; ++i) {
+        out[i] *= scalar;
     }
-    return (*this) * (1.0 / scalar);
+    return *this;
 }
 
 // Comparison operators
-bool Matrix::operator==(const Matrix& other) const {
+template <typename T>
+bool MatrixT<T>::operator==(const MatrixT& other) const {
     if (rows != other.rows || cols != other.cols) {
         return false;
     }
 
-    const double epsilon = 1e-9;
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            if (std::abs(data[i][j] - other.data[i][j]) > epsilon) {
-                return false;
-            }
+    // Absolute tolerance per type: 1e-9 in double, as before the scalar
+    // type became a parameter; float gets 1e-5 (about 80 ulp at 1.0), since
+    // 1e-9 is below its epsilon and would demand exact equality
+    const T epsilon = static_cast<T>(std::is_same<T, float>::value ? 1e-5 : 1e-9);
+    for (size_t i = 0; i < rows * cols; ++i) {
+        if (std::abs(ptr[i] - other.ptr[i]) > epsilon) {
+            return false;
         }
     }
     return true;
 }
 
-bool Matrix::operator!=(const Matrix& other) const {
+template <typename T>
+bool MatrixT<T>::operator!=(const MatrixT& other) const {
     return !(*this == other);
 }
 
-// Friend functions
-Matrix operator*(double scalar, const Matrix& matrix) {
-    return matrix * scalar;
-}
-
-std::ostream& operator<<(std::ostream& os, const Matrix& matrix) {
-    for (size_t i = 0; i < matrix.rows; ++i) {
-        for (size_t j = 0; j < matrix.cols; ++j) {
-            os << std::setw(8) << std::fixed << std::setprecision(3) << matrix.data[i][j];
-            if (j < matrix.cols - 1) os << " ";
+template <typename T>
+std::ostream& operator<<(std::ostream& os, const MatrixT<T>& matrix) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    for (size_t i = 0; i < rows; ++i) {
+        const T* row = matrix.row_ptr(i);
+        for (size_t j = 0; j < cols; ++j) {
+            os << std::setw(8) << std::fixed << std::setprecision(3) << row[j];
+            if (j < cols - 1) os << " ";
         }
-        if (i < matrix.rows - 1) os << "\n";
+        if (i < rows - 1) os << "\n";
     }
     return os;
-}
\ No newline at end of file
+}
+
+template class MatrixT<float>;
+template class MatrixT<double>;
+template std::ostream& operator<<(std::ostream&, const MatrixT<float>&);
+template std::ostream& operator<<(std::ostream&, const MatrixT<double>&);
@@ -1,103 +1,430 @@
 
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/gemm.h"
+#include "../../include/matrix/thread_pool.h"
+#include "../../include/matrix/vector_math.h"
+#include "../../include/matrix/reduction.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 namespace MatrixOps {
 
-Matrix matmul(const Matrix& a, const Matrix& b) {
-    if (a.getCols() != b.getRows()) {
+namespace {
+
+// Element-wise loops and reductions give each thread at least this many elements
+constexpr size_t PARALLEL_MIN_ELEMENTS = 1 << 15;
+
+// Shared driver for every gemm overload: b is given as raw storage so it can
+// be a view of T or a 16-bit HalfMatrix
+template <typename T, typename S>
+void gemm_impl(double alpha, ConstMatrixViewT<T> a, bool transpose_a,
+               const S* b, size_t b_rows, size_t b_cols, size_t b_stride, bool transpose_b,
+               double beta, MatrixViewT<T> c, const Gemm::Epilogue<T>& epilogue) {
+    // Logical shapes of op(a) and op(b)
+    const size_t m = transpose_a ? a.getCols() : a.getRows();
+    const size_t k = transpose_a ? a.getRows() : a.getCols();
+    const size_t k_b = transpose_b ? b_cols : b_rows;
+    const size_t n = transpose_b ? b_rows : b_cols;
+
+    if (k != k_b) {
         throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
+    if (c.getRows() != m || c.getCols() != n) {
+        throw std::invalid_argument("Output dimensions incompatible for multiplication");
+    }
 
-    size_t rows = a.getRows();
-    size_t cols = b.getCols();
-    size_t inner = a.getCols();
+    // A transposed operand is the same storage walked with swapped strides
+    const size_t a_row_stride = transpose_a ? 1 : a.getStride();
+    const size_t a_col_stride = transpose_a ? a.getStride() : 1;
+    const size_t b_row_stride = transpose_b ? 1 : b_stride;
+    const size_t b_col_stride = transpose_b ? b_stride : 1;
 
-    Matrix result(rows, cols, 0.0);
+    Gemm::gemm<T>(m, n, k, static_cast<T>(alpha),
+                  a.data(), a_row_stride, a_col_stride,
+                  b, b_row_stride, b_col_stride,
+                  static_cast<T>(beta), c.data(), c.getStride(), epilogue);
+}
 
-    for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-            for (size_t k = 0; k < inner; ++k) {
-                result(i, j) += a(i, k) * b(k, j);
+// Shape checks shared by the batched gemm overloads; sets m, n and k
+template <typename T>
+void batched_shape(ConstMatrixViewT<T> a, bool transpose_a, ConstMatrixViewT<T> b, bool transpose_b,
+                   ConstMatrixViewT<T> c, size_t& m, size_t& n, size_t& k) {
+    m = transpose_a ? a.getCols() : a.getRows();
+    k = transpose_a ? a.getRows() : a.getCols();
+    n = transpose_b ? b.getRows() : b.getCols();
+    if ((transpose_b ? b.getCols() : b.getRows()) != k) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (c.getRows() != m || c.getCols() != n) {
+        throw std::invalid_argument("Output dimensions incompatible for multiplication");
+    }
+}
+
+template <typename T>
+bool same_layout(ConstMatrixViewT<T> x, ConstMatrixViewT<T> y) {
+    return x.getRows() == y.getRows() && x.getCols() == y.getCols() && x.getStride() == y.getStride();
+}
+
+// Reductions split the rows into fixed blocks, each reduced by one task and
+// combined in block order, so results do not depend on the number of threads
+constexpr size_t MAX_ROW_BLOCKS = 64;
+
+struct RowBlocks {
+    size_t rows, size, count;
+    RowBlocks(size_t rows, size_t cols)
+        : rows(rows),
+          size(std::max<size_t>((rows + MAX_ROW_BLOCKS - 1) / MAX_ROW_BLOCKS,
+                                cols == 0 ? rows : (PARALLEL_MIN_ELEMENTS + cols - 1) / cols)),
+          count(size == 0 ? 0 : (rows + size - 1) / size) {}
+    size_t begin(size_t block) const { return block * size; }
+    size_t end(size_t block) const { return std::min(rows, (block + 1) * size); }
+};
+
+// Column-wise accumulators live on the stack for this many columns
+constexpr size_t COLUMN_CHUNK = 256;
+
+// Runs body(j0, n) on column chunks [j0, j0 + n), spread over threads when
+// the matrix is large (a short, wide matrix that forms a single row block)
+template <typename Body>
+void for_column_chunks(size_t cols, size_t rows, Body&& body) {
+    const size_t chunks = (cols + COLUMN_CHUNK - 1) / COLUMN_CHUNK;
+    parallel_for_rows(chunks, COLUMN_CHUNK * rows, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            const size_t j0 = chunk * COLUMN_CHUNK;
+            body(j0, std::min(COLUMN_CHUNK, cols - j0));
+        }
+    });
+}
+
+// Rows added plainly before a run is folded into the compensated sum
+constexpr size_t SUM_RUN = 32;
+
+// Sums of columns [j0, j0 + n) over rows [first, last) into sum[], with the
+// running Kahan compensation in compensation[] (the sum is sum - compensation).
+// Runs of SUM_RUN rows are added plainly into run[] and each run is folded
+// in with compensation, so the error is bounded by the run length instead
+// of growing with the number of rows, at nearly the cost of a plain sum.
+// Lane-wise across columns, so it vectorizes as the rows stream by.
+template <typename T>
+void sum_columns(ConstMatrixViewT<T> matrix, size_t first, size_t last, size_t j0, size_t n,
+                 T* sum, T* compensation, T* run) {
+    for (size_t r0 = first; r0 < last; r0 += SUM_RUN) {
+        const size_t r1 = std::min(last, r0 + SUM_RUN);
+        std::copy(matrix.row_ptr(r0) + j0, matrix.row_ptr(r0) + j0 + n, run);
+        for (size_t i = r0 + 1; i < r1; ++i) {
+            const T* src = matrix.row_ptr(i) + j0;
+            for (size_t j = 0; j < n; ++j) {
+                run[j] += src[j];
             }
         }
+        for (size_t j = 0; j < n; ++j) {
+            const T y = run[j] - compensation[j];
+            const T t = sum[j] + y;
+            compensation[j] = (t - sum[j]) - y;
+            sum[j] = t;
+        }
     }
+}
 
-    return result;
+// Welford's update of the running mean and M2 (sum of squared deviations)
+// of columns [j0, j0 + n) over rows [first, last); both start at zero
+template <typename T>
+void welford_columns(ConstMatrixViewT<T> matrix, size_t first, size_t last, size_t j0, size_t n,
+                     T* mean, T* m2) {
+    for (size_t i = first; i < last; ++i) {
+        const T* src = matrix.row_ptr(i) + j0;
+        const T inv_count = T(1) / static_cast<T>(i - first + 1);
+        for (size_t j = 0; j < n; ++j) {
+            const T delta = src[j] - mean[j];
+            mean[j] += delta * inv_count;
+            m2[j] += delta * (src[j] - mean[j]);
+        }
+    }
 }
 
-Matrix add(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have the same dimensions for addition");
+// Running column maxima over rows [first, last) and, when index is given,
+// the first row holding each. NaN never replace the running value.
+template <typename T>
+void max_columns(ConstMatrixViewT<T> matrix, size_t first, size_t last, size_t j0, size_t n,
+                 T* value, size_t* index) {
+    for (size_t i = first; i < last; ++i) {
+        const T* src = matrix.row_ptr(i) + j0;
+        if (index) {
+            for (size_t j = 0; j < n; ++j) {
+                const bool greater = src[j] > value[j];
+                value[j] = greater ? src[j] : value[j];
+                index[j] = greater ? i : index[j];
+            }
+        } else {
+            for (size_t j = 0; j < n; ++j) {
+                value[j] = src[j] > value[j] ? src[j] : value[j];
+            }
+        }
+    }
+}
+
+// Shape of an axis reduction's result: 1 x cols (axis 0) or rows x 1 (axis 1)
+template <typename T>
+MatrixT<T> axis_result(ConstMatrixViewT<T> matrix, int axis) {
+    if (axis != 0 && axis != 1) {
+        throw std::invalid_argument("Axis must be 0 or 1");
     }
+    return axis == 0 ? MatrixT<T>(1, matrix.getCols()) : MatrixT<T>(matrix.getRows(), 1);
+}
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            result(i, j) = a(i, j) + b(i, j);
+template <typename T>
+void check_axis_output(ConstMatrixViewT<T> out, ConstMatrixViewT<T> matrix, int axis) {
+    if (axis == 0) {
+        if (out.getRows() != 1 || out.getCols() != matrix.getCols()) {
+            throw std::invalid_argument("Output must be a 1 x cols row vector");
+        }
+    } else if (axis == 1) {
+        if (out.getRows() != matrix.getRows() || out.getCols() != 1) {
+            throw std::invalid_argument("Output must be a rows x 1 column vector");
         }
+    } else {
+        throw std::invalid_argument("Axis must be 0 or 1");
     }
-    return result;
 }
 
-Matrix subtract(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have the same dimensions for subtraction");
+} // namespace
+
+template <typename T>
+void batched_gemm(double alpha, const ConstMatrixViewT<T>* a, bool transpose_a,
+                  const ConstMatrixViewT<T>* b, bool transpose_b, double beta,
+                  const MatrixViewT<T>* c, size_t batch) {
+    if (batch == 0) {
+        return;
+    }
+    size_t m, n, k;
+    batched_shape<T>(a[0], transpose_a, b[0], transpose_b, c[0], m, n, k);
+    for (size_t p = 1; p < batch; ++p) {
+        if (!same_layout(a[p], a[0]) || !same_layout(b[p], b[0]) || !same_layout<T>(c[p], c[0])) {
+            throw std::invalid_argument("Batched operands must share one shape and stride");
+        }
     }
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            result(i, j) = a(i, j) - b(i, j);
+    // Gemm takes pointer arrays; gather them a block at a time on the stack
+    constexpr size_t BLOCK = 256;
+    const T* a_ptrs[BLOCK];
+    const T* b_ptrs[BLOCK];
+    T* c_ptrs[BLOCK];
+    for (size_t p0 = 0; p0 < batch; p0 += BLOCK) {
+        const size_t count = std::min(BLOCK, batch - p0);
+        for (size_t p = 0; p < count; ++p) {
+            a_ptrs[p] = a[p0 + p].data();
+            b_ptrs[p] = b[p0 + p].data();
+            c_ptrs[p] = c[p0 + p].data();
         }
+        Gemm::gemm_batched<T>(count, m, n, k, static_cast<T>(alpha),
+                              a_ptrs, transpose_a ? 1 : a[0].getStride(), transpose_a ? a[0].getStride() : 1,
+                              b_ptrs, transpose_b ? 1 : b[0].getStride(), transpose_b ? b[0].getStride() : 1,
+                              static_cast<T>(beta), c_ptrs, c[0].getStride());
     }
+}
+
+template <typename T>
+void batched_gemm(double alpha, ConstMatrixViewT<T> a, size_t a_batch_stride, bool transpose_a,
+                  ConstMatrixViewT<T> b, size_t b_batch_stride, bool transpose_b, double beta,
+                  OutputViewT<T> c, size_t c_batch_stride, size_t batch) {
+    size_t m, n, k;
+    batched_shape<T>(a, transpose_a, b, transpose_b, c, m, n, k);
+    Gemm::gemm_strided_batched<T>(batch, m, n, k, static_cast<T>(alpha),
+                                  a.data(), transpose_a ? 1 : a.getStride(), transpose_a ? a.getStride() : 1, a_batch_stride,
+                                  b.data(), transpose_b ? 1 : b.getStride(), transpose_b ? b.getStride() : 1, b_batch_stride,
+                                  static_cast<T>(beta), c.data(), c.getStride(), c_batch_stride);
+}
+
+template <typename T>
+void batched_matmul_into(const MatrixViewT<T>* out, const ConstMatrixViewT<T>* a,
+                         const ConstMatrixViewT<T>* b, size_t batch) {
+    batched_gemm(1.0, a, false, b, false, 0.0, out, batch);
+}
+
+template <typename T>
+void gemm(double alpha, ConstMatrixViewT<T> a, bool transpose_a,
+          ConstMatrixViewT<T> b, bool transpose_b, double beta, OutputViewT<T> c,
+          const Gemm::Epilogue<T>& epilogue) {
+    gemm_impl(alpha, a, transpose_a, b.data(), b.getRows(), b.getCols(), b.getStride(),
+              transpose_b, beta, c, epilogue);
+}
+
+template <typename T>
+void gemm(double alpha, ConstMatrixViewT<T> a, bool transpose_a,
+          const HalfMatrix& b, bool transpose_b, double beta, OutputViewT<T> c,
+          const Gemm::Epilogue<T>& epilogue) {
+    if (b.getType() == StorageType::BFloat16) {
+        gemm_impl(alpha, a, transpose_a, b.bf16_data(), b.getRows(), b.getCols(), b.getCols(),
+                  transpose_b, beta, c, epilogue);
+    } else {
+        gemm_impl(alpha, a, transpose_a, b.fp16_data(), b.getRows(), b.getCols(), b.getCols(),
+                  transpose_b, beta, c, epilogue);
+    }
+}
+
+template <typename T>
+Gemm::Epilogue<T> make_epilogue(ConstMatrixViewT<T> bias, Gemm::Activation activation, ConstMatrixViewT<T> residual) {
+    if (bias.size() != 0 && bias.getRows() != 1) {
+        throw std::invalid_argument("Epilogue bias must be a row vector");
+    }
+    Gemm::Epilogue<T> epilogue;
+    epilogue.bias = bias.size() != 0 ? bias.data() : nullptr;
+    epilogue.activation = activation;
+    epilogue.residual = residual.size() != 0 ? residual.data() : nullptr;
+    epilogue.residual_ld = residual.getStride();
+    return epilogue;
+}
+
+template <typename T>
+void apply_epilogue(OutputViewT<T> c, const Gemm::Epilogue<T>& epilogue) {
+    if (epilogue.empty()) {
+        return;
+    }
+    parallel_for_rows(c.getRows(), c.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        Gemm::apply_epilogue(epilogue.at(first, 0), last - first, c.getCols(), c.row_ptr(first), c.getStride());
+    });
+}
+
+template <typename T>
+void gemm(double alpha, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b, double beta, OutputViewT<T> c) {
+    gemm(alpha, a, false, b, false, beta, c);
+}
+
+template <typename T>
+void matmul_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    gemm(1.0, a, b, 0.0, out);
+}
+
+template <typename T>
+MatrixT<T> matmul(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    if (a.getCols() != b.getRows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+
+    MatrixT<T> result(a.getRows(), b.getCols());
+    matmul_into(result, a, b);
     return result;
 }
 
-Matrix elementWiseMultiply(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have same dimensions for element-wise multiplication");
+template <typename T>
+MatrixT<T> matmul(ConstMatrixViewT<T> a, const HalfMatrix& b) {
+    MatrixT<T> result(a.getRows(), b.getCols());
+    gemm(1.0, a, false, b, false, 0.0, result);
+    return result;
+}
+
+template <typename T>
+void matmul_into(OutputViewT<T> out, ConstMatrixViewT<T> a, const HalfMatrix& b) {
+    gemm(1.0, a, false, b, false, 0.0, out);
+}
+
+template <typename T>
+MatrixT<T> matmul_nt(ConstMatrixViewT<T> a, const HalfMatrix& b) {
+    MatrixT<T> result(a.getRows(), b.getRows());
+    gemm(1.0, a, false, b, true, 0.0, result);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> matmul_nt(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    if (a.getCols() != b.getCols()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            result(i, j) = a(i, j) * b(i, j);
-        }
+    MatrixT<T> result(a.getRows(), b.getRows());
+    gemm(1.0, a, false, b, true, 0.0, result);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> matmul_tn(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    if (a.getRows() != b.getRows()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
+
+    MatrixT<T> result(a.getCols(), b.getCols());
+    gemm(1.0, a, true, b, false, 0.0, result);
     return result;
 }
 
-Matrix elementWiseDivide(const Matrix& a, const Matrix& b) {
-    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
-        throw std::invalid_argument("Matrices must have same dimensions for element-wise division");
+template <typename T>
+MatrixT<T> matmul_tt(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    if (a.getRows() != b.getCols()) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
     }
 
-    Matrix result(a.getRows(), a.getCols());
-    for (size_t i = 0; i < a.getRows(); ++i) {
-        for (size_t j = 0; j < a.getCols(); ++j) {
-            if (b(i, j) == 0.0) {
-                throw std::invalid_argument("Division by zero in element-wise division");
+    MatrixT<T> result(a.getCols(), b.getRows());
+    gemm(1.0, a, true, b, true, 0.0, result);
+    return result;
+}
+
+template <typename T>
+void copy(OutputViewT<T> dst, ConstMatrixViewT<T> src) {
+    if (dst.getRows() != src.getRows() || dst.getCols() != src.getCols()) {
+        throw std::invalid_argument("Views must have the same dimensions for copy");
+    }
+
+    parallel_for_rows(src.getRows(), src.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const T* from = src.row_ptr(i);
+            T* to = dst.row_ptr(i);
+            for (size_t j = 0; j < src.getCols(); ++j) {
+                to[j] = from[j];
             }
-            result(i, j) = a(i, j) / b(i, j);
         }
+    });
+}
+
+namespace {
+
+template <typename T>
+void check_same_shape(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b, const char* message) {
+    if (a.getRows() != b.getRows() || a.getCols() != b.getCols()) {
+        throw std::invalid_argument(message);
     }
-    return result;
 }
 
-Matrix transpose(const Matrix& matrix) {
-    Matrix result(matrix.getCols(), matrix.getRows());
-    for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result(j, i) = matrix(i, j);
+// out[i][j] = op(src[i][j]); out may be src itself
+template <typename T, typename Op>
+void map_into(MatrixViewT<T> out, ConstMatrixViewT<T> src, Op op) {
+    check_same_shape<T>(out, src, "Output dimensions must match the input");
+    parallel_for_rows(src.getRows(), src.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const T* s = src.row_ptr(i);
+            T* o = out.row_ptr(i);
+            for (size_t j = 0; j < src.getCols(); ++j) {
+                o[j] = op(s[j]);
+            }
         }
-    }
-    return result;
+    });
+}
+
+// out[i][j] = op(a[i][j], b[i][j]); out may be a or b itself
+template <typename T, typename Op>
+void zip_into(MatrixViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b, Op op,
+              const char* message) {
+    check_same_shape(a, b, message);
+    check_same_shape<T>(out, a, "Output dimensions must match the inputs");
+    parallel_for_rows(a.getRows(), a.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const T* pa = a.row_ptr(i);
+            const T* pb = b.row_ptr(i);
+            T* o = out.row_ptr(i);
+            for (size_t j = 0; j < a.getCols(); ++j) {
+                o[j] = op(pa[j], pb[j]);
+            }
+        }
+    });
 }
 
-Matrix addBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+// out = op(matrix, vector) with the vector repeated across rows (row_vector)
+// or across columns; out may be matrix itself
+template <typename T, typename Op>
+void broadcast_into(MatrixViewT<T> out, ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector,
+                    bool row_vector, Op op) {
+    check_same_shape<T>(out, matrix, "Output dimensions must match the input");
+    const size_t cols = matrix.getCols();
 
     if (row_vector) {
         // Broadcasting row vector across all rows
@@ -105,153 +432,568 @@ Matrix addBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector)
             throw std::invalid_argument("Vector dimensions incompatible for row broadcasting");
         }
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) + vector(0, j);
+        const T* v = vector.data();
+        parallel_for_rows(matrix.getRows(), cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const T* src = matrix.row_ptr(i);
+                T* o = out.row_ptr(i);
+                for (size_t j = 0; j < cols; ++j) {
+                    o[j] = op(src[j], v[j]);
+                }
             }
-        }
+        });
     } else {
         // Broadcasting column vector across all columns
         if (vector.getRows() != matrix.getRows() || vector.getCols() != 1) {
             throw std::invalid_argument("Vector dimensions incompatible for column broadcasting");
         }
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) + vector(i, 0);
+        parallel_for_rows(matrix.getRows(), cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const T v = vector(i, 0);
+                const T* src = matrix.row_ptr(i);
+                T* o = out.row_ptr(i);
+                for (size_t j = 0; j < cols; ++j) {
+                    o[j] = op(src[j], v);
+                }
             }
-        }
+        });
     }
+}
 
-    return result;
+} // namespace
+
+template <typename T>
+void add_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    zip_into(out, a, b, [](T x, T y) { return x + y; },
+             "Matrices must have the same dimensions for addition");
 }
 
-Matrix multiplyBroadcast(const Matrix& matrix, const Matrix& vector, bool row_vector) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+void subtract_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    zip_into(out, a, b, [](T x, T y) { return x - y; },
+             "Matrices must have the same dimensions for subtraction");
+}
 
-    if (row_vector) {
-        if (vector.getCols() != matrix.getCols() || vector.getRows() != 1) {
-            throw std::invalid_argument("Vector dimensions incompatible for row broadcasting");
-        }
+template <typename T>
+void elementWiseMultiply_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    zip_into(out, a, b, [](T x, T y) { return x * y; },
+             "Matrices must have same dimensions for element-wise multiplication");
+}
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) * vector(0, j);
+template <typename T>
+void elementWiseDivide_into(OutputViewT<T> out, ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    check_same_shape(a, b, "Matrices must have same dimensions for element-wise division");
+    for (size_t i = 0; i < b.getRows(); ++i) {
+        const T* pb = b.row_ptr(i);
+        for (size_t j = 0; j < b.getCols(); ++j) {
+            if (pb[j] == 0.0) {
+                throw std::invalid_argument("Division by zero in element-wise division");
             }
         }
-    } else {
-        if (vector.getRows() != matrix.getRows() || vector.getCols() != 1) {
-            throw std::invalid_argument("Vector dimensions incompatible for column broadcasting");
-        }
+    }
+
+    zip_into(out, a, b, [](T x, T y) { return x / y; },
+             "Matrices must have same dimensions for element-wise division");
+}
+
+template <typename T>
+MatrixT<T> add(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    MatrixT<T> result(a.getRows(), a.getCols());
+    add_into(result, a, b);
+    return result;
+}
 
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, j) = matrix(i, j) * vector(i, 0);
+template <typename T>
+MatrixT<T> subtract(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    MatrixT<T> result(a.getRows(), a.getCols());
+    subtract_into(result, a, b);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> elementWiseMultiply(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    MatrixT<T> result(a.getRows(), a.getCols());
+    elementWiseMultiply_into(result, a, b);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> elementWiseDivide(ConstMatrixViewT<T> a, ConstMatrixViewT<T> b) {
+    MatrixT<T> result(a.getRows(), a.getCols());
+    elementWiseDivide_into(result, a, b);
+    return result;
+}
+
+template <typename T>
+void add_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b) {
+    add_into(a, ConstMatrixViewT<T>(a), b);
+}
+
+template <typename T>
+void subtract_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b) {
+    subtract_into(a, ConstMatrixViewT<T>(a), b);
+}
+
+template <typename T>
+void elementWiseMultiply_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b) {
+    elementWiseMultiply_into(a, ConstMatrixViewT<T>(a), b);
+}
+
+template <typename T>
+void elementWiseDivide_inplace(OutputViewT<T> a, ConstMatrixViewT<T> b) {
+    elementWiseDivide_into(a, ConstMatrixViewT<T>(a), b);
+}
+
+template <typename T>
+void transpose_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    if (out.getRows() != cols || out.getCols() != rows) {
+        throw std::invalid_argument("Output dimensions incompatible for transpose");
+    }
+
+    // Blocked so both the reads and the writes stay within a few cache lines
+    const size_t block = 32;
+    for (size_t ii = 0; ii < rows; ii += block) {
+        const size_t i_end = std::min(ii + block, rows);
+        for (size_t jj = 0; jj < cols; jj += block) {
+            const size_t j_end = std::min(jj + block, cols);
+            for (size_t i = ii; i < i_end; ++i) {
+                const T* src = matrix.row_ptr(i);
+                for (size_t j = jj; j < j_end; ++j) {
+                    out(j, i) = src[j];
+                }
             }
         }
     }
+}
 
+template <typename T>
+MatrixT<T> transpose(ConstMatrixViewT<T> matrix) {
+    MatrixT<T> result(matrix.getCols(), matrix.getRows());
+    transpose_into(result, matrix);
     return result;
 }
 
-double sum(const Matrix& matrix) {
-    double total = 0.0;
-    for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            total += matrix(i, j);
+template <typename T>
+void addBroadcast_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector,
+                       bool row_vector) {
+    broadcast_into(out, matrix, vector, row_vector, [](T x, T v) { return x + v; });
+}
+
+template <typename T>
+void multiplyBroadcast_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector,
+                            bool row_vector) {
+    broadcast_into(out, matrix, vector, row_vector, [](T x, T v) { return x * v; });
+}
+
+template <typename T>
+MatrixT<T> addBroadcast(ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector) {
+    MatrixT<T> result(matrix.getRows(), matrix.getCols());
+    addBroadcast_into(result, matrix, vector, row_vector);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> multiplyBroadcast(ConstMatrixViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector) {
+    MatrixT<T> result(matrix.getRows(), matrix.getCols());
+    multiplyBroadcast_into(result, matrix, vector, row_vector);
+    return result;
+}
+
+template <typename T>
+void addBroadcast_inplace(OutputViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector) {
+    addBroadcast_into(matrix, ConstMatrixViewT<T>(matrix), vector, row_vector);
+}
+
+template <typename T>
+void multiplyBroadcast_inplace(OutputViewT<T> matrix, ConstMatrixViewT<T> vector, bool row_vector) {
+    multiplyBroadcast_into(matrix, ConstMatrixViewT<T>(matrix), vector, row_vector);
+}
+
+template <typename T>
+T sum(ConstMatrixViewT<T> matrix) {
+    const size_t cols = matrix.getCols();
+    const RowBlocks blocks(matrix.getRows(), cols);
+    const bool contiguous = matrix.getStride() == cols;
+
+    T partial[MAX_ROW_BLOCKS];
+    parallel_for(blocks.count, 1, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            const size_t begin = blocks.begin(block), end = blocks.end(block);
+            if (contiguous) {
+                // The whole block is one array
+                partial[block] = Reduction::sum(matrix.row_ptr(begin), (end - begin) * cols);
+                continue;
+            }
+            // Pairwise row sums, compensated across rows
+            T total = 0.0, compensation = 0.0;
+            for (size_t i = begin; i < end; ++i) {
+                const T y = Reduction::sum(matrix.row_ptr(i), cols) - compensation;
+                const T t = total + y;
+                compensation = (t - total) - y;
+                total = t;
+            }
+            partial[block] = total;
         }
-    }
-    return total;
+    });
+    return Reduction::sum(partial, blocks.count);
 }
 
-double mean(const Matrix& matrix) {
+template <typename T>
+T mean(ConstMatrixViewT<T> matrix) {
     return sum(matrix) / (matrix.getRows() * matrix.getCols());
 }
 
-Matrix sumAxis(const Matrix& matrix, int axis) {
-    if (axis == 0) {
-        // Sum across rows (result is row vector)
-        Matrix result(1, matrix.getCols(), 0.0);
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            for (size_t i = 0; i < matrix.getRows(); ++i) {
-                result(0, j) += matrix(i, j);
+template <typename T>
+void sumAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    check_axis_output<T>(out, matrix, axis);
+    if (axis == 1) {
+        parallel_for_rows(rows, cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                out(i, 0) = Reduction::sum(matrix.row_ptr(i), cols);
             }
+        });
+        return;
+    }
+
+    T* o = out.data();
+    const RowBlocks blocks(rows, cols);
+    if (blocks.count <= 1) {
+        // One pass over the rows per column chunk, compensation on the stack
+        for_column_chunks(cols, rows, [&](size_t j0, size_t n) {
+            T compensation[COLUMN_CHUNK] = {}, run[COLUMN_CHUNK];
+            std::fill(o + j0, o + j0 + n, T(0));
+            sum_columns(matrix, 0, rows, j0, n, o + j0, compensation, run);
+            for (size_t j = 0; j < n; ++j) {
+                o[j0 + j] -= compensation[j];
+            }
+        });
+        return;
+    }
+
+    // Every row block accumulates its own column sums and compensations
+    // (and run buffer), which are then combined in block order
+    std::vector<T> partial(3 * blocks.count * cols, T(0));
+    parallel_for(blocks.count, 1, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            T* block_sum = partial.data() + 3 * block * cols;
+            sum_columns(matrix, blocks.begin(block), blocks.end(block), 0, cols,
+                        block_sum, block_sum + cols, block_sum + 2 * cols);
         }
-        return result;
-    } else if (axis == 1) {
-        // Sum across columns (result is column vector)
-        Matrix result(matrix.getRows(), 1, 0.0);
-        for (size_t i = 0; i < matrix.getRows(); ++i) {
-            for (size_t j = 0; j < matrix.getCols(); ++j) {
-                result(i, 0) += matrix(i, j);
+    });
+    // Compensated again across blocks, lane-wise over the columns (block 0's
+    // run buffer holds the compensation)
+    T* compensation = partial.data() + 2 * cols;
+    std::fill(o, o + cols, T(0));
+    std::fill(compensation, compensation + cols, T(0));
+    for (size_t block = 0; block < blocks.count; ++block) {
+        const T* block_sum = partial.data() + 3 * block * cols;
+        for (size_t j = 0; j < cols; ++j) {
+            const T y = (block_sum[j] - block_sum[cols + j]) - compensation[j];
+            const T t = o[j] + y;
+            compensation[j] = (t - o[j]) - y;
+            o[j] = t;
+        }
+    }
+}
+
+template <typename T>
+void meanAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis) {
+    sumAxis_into(out, matrix, axis);
+    const T scale = T(1) / static_cast<T>(axis == 0 ? matrix.getRows() : matrix.getCols());
+    map_into<T>(out, out, [scale](T x) { return x * scale; });
+}
+
+template <typename T>
+void meanVarAxis_into(OutputViewT<T> mean, OutputViewT<T> variance, ConstMatrixViewT<T> matrix, int axis) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    check_axis_output<T>(mean, matrix, axis);
+    check_axis_output<T>(variance, matrix, axis);
+    if (axis == 1) {
+        // Two passes over each row while it is in L1
+        parallel_for_rows(rows, cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const T* src = matrix.row_ptr(i);
+                const T mu = Reduction::sum(src, cols) / static_cast<T>(cols);
+                mean(i, 0) = mu;
+                variance(i, 0) = Reduction::sum_squared_deviation(src, cols, mu) / static_cast<T>(cols);
+            }
+        });
+        return;
+    }
+
+    // Welford down the columns: the running mean and sum of squared
+    // deviations (M2) of each column, one pass over the rows
+    T* mu = mean.data();
+    T* var = variance.data();
+    const RowBlocks blocks(rows, cols);
+    if (blocks.count <= 1) {
+        for_column_chunks(cols, rows, [&](size_t j0, size_t n) {
+            std::fill(mu + j0, mu + j0 + n, T(0));
+            std::fill(var + j0, var + j0 + n, T(0));
+            welford_columns(matrix, 0, rows, j0, n, mu + j0, var + j0);
+            for (size_t j = j0; j < j0 + n; ++j) {
+                var[j] /= static_cast<T>(rows);
             }
+        });
+        return;
+    }
+
+    // Per-block means and M2, merged in block order (Chan et al.)
+    std::vector<T> partial(2 * blocks.count * cols, T(0));
+    parallel_for(blocks.count, 1, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            T* block_mean = partial.data() + 2 * block * cols;
+            welford_columns(matrix, blocks.begin(block), blocks.end(block), 0, cols, block_mean, block_mean + cols);
         }
-        return result;
-    } else {
-        throw std::invalid_argument("Axis must be 0 or 1");
+    });
+    std::copy(partial.begin(), partial.begin() + cols, mu);
+    std::copy(partial.begin() + cols, partial.begin() + 2 * cols, var);
+    size_t count = blocks.end(0);
+    for (size_t block = 1; block < blocks.count; ++block) {
+        const T* block_mean = partial.data() + 2 * block * cols;
+        const T* block_m2 = block_mean + cols;
+        const size_t block_count = blocks.end(block) - blocks.begin(block);
+        const T total = static_cast<T>(count + block_count);
+        const T weight = static_cast<T>(block_count) / total;
+        const T cross = static_cast<T>(count) * static_cast<T>(block_count) / total;
+        for (size_t j = 0; j < cols; ++j) {
+            const T delta = block_mean[j] - mu[j];
+            mu[j] += delta * weight;
+            var[j] += block_m2[j] + delta * delta * cross;
+        }
+        count += block_count;
+    }
+    for (size_t j = 0; j < cols; ++j) {
+        var[j] /= static_cast<T>(rows);
     }
 }
 
-Matrix meanAxis(const Matrix& matrix, int axis) {
-    Matrix result = sumAxis(matrix, axis);
-    if (axis == 0) {
-        result = result / static_cast<double>(matrix.getRows());
-    } else {
-        result = result / static_cast<double>(matrix.getCols());
+template <typename T>
+void varAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis) {
+    check_axis_output<T>(out, matrix, axis);
+    MatrixT<T> mean(out.getRows(), out.getCols());
+    meanVarAxis_into(mean.view(), out, matrix, axis);
+}
+
+template <typename T>
+void maxAxis_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, int axis) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    check_axis_output<T>(out, matrix, axis);
+    if (axis == 1) {
+        parallel_for_rows(rows, cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                out(i, 0) = Reduction::max(matrix.row_ptr(i), cols);
+            }
+        });
+        return;
+    }
+
+    T* o = out.data();
+    const RowBlocks blocks(rows, cols);
+    if (blocks.count <= 1) {
+        for_column_chunks(cols, rows, [&](size_t j0, size_t n) {
+            std::fill(o + j0, o + j0 + n, -std::numeric_limits<T>::infinity());
+            max_columns<T>(matrix, 0, rows, j0, n, o + j0, nullptr);
+        });
+        return;
+    }
+    std::vector<T> partial(blocks.count * cols, -std::numeric_limits<T>::infinity());
+    parallel_for(blocks.count, 1, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            max_columns<T>(matrix, blocks.begin(block), blocks.end(block), 0, cols,
+                           partial.data() + block * cols, nullptr);
+        }
+    });
+    std::copy(partial.begin(), partial.begin() + cols, o);
+    for (size_t block = 1; block < blocks.count; ++block) {
+        const T* block_max = partial.data() + block * cols;
+        for (size_t j = 0; j < cols; ++j) {
+            o[j] = block_max[j] > o[j] ? block_max[j] : o[j];
+        }
     }
-    return result;
 }
 
-Matrix power(const Matrix& matrix, double exponent) {
-    Matrix result(matrix.getRows(), matrix.getCols());
-    for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result(i, j) = std::pow(matrix(i, j), exponent);
+template <typename T>
+void argmaxAxis_into(size_t* out, ConstMatrixViewT<T> matrix, int axis) {
+    const size_t rows = matrix.getRows();
+    const size_t cols = matrix.getCols();
+    if (axis == 1) {
+        parallel_for_rows(rows, cols, PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                out[i] = Reduction::argmax(matrix.row_ptr(i), cols);
+            }
+        });
+        return;
+    }
+    if (axis != 0) {
+        throw std::invalid_argument("Axis must be 0 or 1");
+    }
+
+    // Per-block column maxima and their rows; blocks are merged in order
+    // with a strict comparison so ties keep the earliest row
+    const RowBlocks blocks(rows, cols);
+    std::vector<T> values(blocks.count * cols, -std::numeric_limits<T>::infinity());
+    std::vector<size_t> indices(blocks.count * cols, 0);
+    parallel_for(blocks.count, 1, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            max_columns<T>(matrix, blocks.begin(block), blocks.end(block), 0, cols,
+                           values.data() + block * cols, indices.data() + block * cols);
+        }
+    });
+    for (size_t j = 0; j < cols; ++j) {
+        T best = values[j];
+        out[j] = indices[j];
+        for (size_t block = 1; block < blocks.count; ++block) {
+            if (values[block * cols + j] > best) {
+                best = values[block * cols + j];
+                out[j] = indices[block * cols + j];
+            }
         }
     }
+}
+
+template <typename T>
+MatrixT<T> sumAxis(ConstMatrixViewT<T> matrix, int axis) {
+    MatrixT<T> result = axis_result<T>(matrix, axis);
+    sumAxis_into(result, matrix, axis);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> meanAxis(ConstMatrixViewT<T> matrix, int axis) {
+    MatrixT<T> result = axis_result<T>(matrix, axis);
+    meanAxis_into(result, matrix, axis);
     return result;
 }
 
-Matrix sqrt(const Matrix& matrix) {
-    return power(matrix, 0.5);
+template <typename T>
+MatrixT<T> varAxis(ConstMatrixViewT<T> matrix, int axis) {
+    MatrixT<T> result = axis_result<T>(matrix, axis);
+    varAxis_into(result, matrix, axis);
+    return result;
 }
 
-Matrix exp(const Matrix& matrix) {
-    Matrix result(matrix.getRows(), matrix.getCols());
-    for (size_t i = 0; i < matrix.getRows(); ++i) {
-        for (size_t j = 0; j < matrix.getCols(); ++j) {
-            result(i, j) = std::exp(matrix(i, j));
-        }
+template <typename T>
+MatrixT<T> maxAxis(ConstMatrixViewT<T> matrix, int axis) {
+    MatrixT<T> result = axis_result<T>(matrix, axis);
+    maxAxis_into(result, matrix, axis);
+    return result;
+}
+
+template <typename T>
+std::vector<size_t> argmaxAxis(ConstMatrixViewT<T> matrix, int axis) {
+    if (axis != 0 && axis != 1) {
+        throw std::invalid_argument("Axis must be 0 or 1");
     }
+    std::vector<size_t> result(axis == 0 ? matrix.getCols() : matrix.getRows());
+    argmaxAxis_into(result.data(), matrix, axis);
     return result;
 }
 
-Matrix log(const Matrix& matrix) {
-    Matrix result(matrix.getRows(), matrix.getCols());
+template <typename T>
+void power_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix, double exponent) {
+    map_into<T>(out, matrix, [exponent](T x) { return static_cast<T>(std::pow(x, exponent)); });
+}
+
+template <typename T>
+void sqrt_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix) {
+    map_into<T>(out, matrix, [](T x) { return std::sqrt(x); });
+}
+
+template <typename T>
+void exp_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix) {
+    check_same_shape<T>(out, matrix, "Output dimensions must match the input");
+    parallel_for_rows(matrix.getRows(), matrix.getCols(), PARALLEL_MIN_ELEMENTS, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            VectorMath::exp(matrix.row_ptr(i), out.row_ptr(i), matrix.getCols());
+        }
+    });
+}
+
+template <typename T>
+void log_into(OutputViewT<T> out, ConstMatrixViewT<T> matrix) {
     for (size_t i = 0; i < matrix.getRows(); ++i) {
+        const T* src = matrix.row_ptr(i);
         for (size_t j = 0; j < matrix.getCols(); ++j) {
-            if (matrix(i, j) <= 0.0) {
+            if (src[j] <= 0.0) {
                 throw std::invalid_argument("Logarithm of non-positive number");
             }
-            result(i, j) = std::log(matrix(i, j));
         }
     }
+
+    map_into<T>(out, matrix, [](T x) { return std::log(x); });
+}
+
+template <typename T>
+MatrixT<T> power(ConstMatrixViewT<T> matrix, double exponent) {
+    MatrixT<T> result(matrix.getRows(), matrix.getCols());
+    power_into(result, matrix, exponent);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> sqrt(ConstMatrixViewT<T> matrix) {
+    MatrixT<T> result(matrix.getRows(), matrix.getCols());
+    sqrt_into(result, matrix);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> exp(ConstMatrixViewT<T> matrix) {
+    MatrixT<T> result(matrix.getRows(), matrix.getCols());
+    exp_into(result, matrix);
+    return result;
+}
+
+template <typename T>
+MatrixT<T> log(ConstMatrixViewT<T> matrix) {
+    MatrixT<T> result(matrix.getRows(), matrix.getCols());
+    log_into(result, matrix);
     return result;
 }
 
-double trace(const Matrix& matrix) {
+template <typename T>
+void power_inplace(MatrixViewT<T> matrix, double exponent) {
+    power_into(matrix, ConstMatrixViewT<T>(matrix), exponent);
+}
+
+template <typename T>
+void sqrt_inplace(MatrixViewT<T> matrix) {
+    sqrt_into(matrix, ConstMatrixViewT<T>(matrix));
+}
+
+template <typename T>
+void exp_inplace(MatrixViewT<T> matrix) {
+    exp_into(matrix, ConstMatrixViewT<T>(matrix));
+}
+
+template <typename T>
+void log_inplace(MatrixViewT<T> matrix) {
+    log_into(matrix, ConstMatrixViewT<T>(matrix));
+}
+
+template <typename T>
+T trace(ConstMatrixViewT<T> matrix) {
     if (matrix.getRows() != matrix.getCols()) {
         throw std::invalid_argument("Matrix must be square to calculate trace");
     }
 
-    double tr = 0.0;
+    T tr = 0.0;
     for (size_t i = 0; i < matrix.getRows(); ++i) {
         tr += matrix(i, i);
     }
     return tr;
 }
 
-double determinant(const Matrix& matrix) {
+template <typename T>
+T determinant(ConstMatrixViewT<T> matrix) {
     if (matrix.getRows() != matrix.getCols()) {
         throw std::invalid_argument("Matrix must be square to calculate determinant");
     }
@@ -271,12 +1013,13 @@ double determinant(const Matrix& matrix) {
     }
 }
 
-Matrix inverse(const Matrix& matrix) {
+template <typename T>
+MatrixT<T> inverse(ConstMatrixViewT<T> matrix) {
     if (matrix.getRows() != matrix.getCols()) {
         throw std::invalid_argument("Matrix must be square to calculate inverse");
     }
 
-    double det = determinant(matrix);
+    T det = determinant(matrix);
     if (std::abs(det) < 1e-10) {
         throw std::invalid_argument("Matrix is singular and cannot be inverted");
     }
@@ -284,11 +1027,11 @@ Matrix inverse(const Matrix& matrix) {
     size_t n = matrix.getRows();
 
     if (n == 1) {
-        Matrix result(1, 1);
+        MatrixT<T> result(1, 1);
         result(0, 0) = 1.0 / matrix(0, 0);
         return result;
     } else if (n == 2) {
-        Matrix result(2, 2);
+        MatrixT<T> result(2, 2);
         result(0, 0) = matrix(1, 1) / det;
         result(0, 1) = -matrix(0, 1) / det;
         result(1, 0) = -matrix(1, 0) / det;
@@ -299,4 +1042,81 @@ Matrix inverse(const Matrix& matrix) {
     }
 }
 
+// Explicit instantiations for the supported element types
+#define MATRIX_OPS_INSTANTIATE(T) \
+    template MatrixT<T> matmul(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void matmul_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void gemm(double, ConstMatrixViewT<T>, ConstMatrixViewT<T>, double, OutputViewT<T>); \
+    template void gemm(double, ConstMatrixViewT<T>, bool, ConstMatrixViewT<T>, bool, double, OutputViewT<T>, \
+                       const Gemm::Epilogue<T>&); \
+    template void gemm(double, ConstMatrixViewT<T>, bool, const HalfMatrix&, bool, double, OutputViewT<T>, \
+                       const Gemm::Epilogue<T>&); \
+    template Gemm::Epilogue<T> make_epilogue(ConstMatrixViewT<T>, Gemm::Activation, ConstMatrixViewT<T>); \
+    template void apply_epilogue(OutputViewT<T>, const Gemm::Epilogue<T>&); \
+    template void batched_gemm(double, const ConstMatrixViewT<T>*, bool, const ConstMatrixViewT<T>*, bool, double, \
+                               const MatrixViewT<T>*, size_t); \
+    template void batched_gemm(double, ConstMatrixViewT<T>, size_t, bool, ConstMatrixViewT<T>, size_t, bool, double, \
+                               OutputViewT<T>, size_t, size_t); \
+    template void batched_matmul_into(const MatrixViewT<T>*, const ConstMatrixViewT<T>*, const ConstMatrixViewT<T>*, size_t); \
+    template MatrixT<T> matmul(ConstMatrixViewT<T>, const HalfMatrix&); \
+    template void matmul_into(OutputViewT<T>, ConstMatrixViewT<T>, const HalfMatrix&); \
+    template MatrixT<T> matmul_nt(ConstMatrixViewT<T>, const HalfMatrix&); \
+    template MatrixT<T> matmul_nt(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> matmul_tn(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> matmul_tt(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void copy(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> add(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> subtract(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> elementWiseMultiply(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> elementWiseDivide(ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void add_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void subtract_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void elementWiseMultiply_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void elementWiseDivide_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>); \
+    template void add_inplace(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void subtract_inplace(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void elementWiseMultiply_inplace(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void elementWiseDivide_inplace(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> transpose(ConstMatrixViewT<T>); \
+    template void transpose_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template MatrixT<T> addBroadcast(ConstMatrixViewT<T>, ConstMatrixViewT<T>, bool); \
+    template MatrixT<T> multiplyBroadcast(ConstMatrixViewT<T>, ConstMatrixViewT<T>, bool); \
+    template void addBroadcast_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>, bool); \
+    template void multiplyBroadcast_into(OutputViewT<T>, ConstMatrixViewT<T>, ConstMatrixViewT<T>, bool); \
+    template void addBroadcast_inplace(OutputViewT<T>, ConstMatrixViewT<T>, bool); \
+    template void multiplyBroadcast_inplace(OutputViewT<T>, ConstMatrixViewT<T>, bool); \
+    template T sum(ConstMatrixViewT<T>); \
+    template T mean(ConstMatrixViewT<T>); \
+    template MatrixT<T> sumAxis(ConstMatrixViewT<T>, int); \
+    template MatrixT<T> meanAxis(ConstMatrixViewT<T>, int); \
+    template void sumAxis_into(OutputViewT<T>, ConstMatrixViewT<T>, int); \
+    template void meanAxis_into(OutputViewT<T>, ConstMatrixViewT<T>, int); \
+    template MatrixT<T> varAxis(ConstMatrixViewT<T>, int); \
+    template MatrixT<T> maxAxis(ConstMatrixViewT<T>, int); \
+    template std::vector<size_t> argmaxAxis(ConstMatrixViewT<T>, int); \
+    template void varAxis_into(OutputViewT<T>, ConstMatrixViewT<T>, int); \
+    template void meanVarAxis_into(OutputViewT<T>, OutputViewT<T>, ConstMatrixViewT<T>, int); \
+    template void maxAxis_into(OutputViewT<T>, ConstMatrixViewT<T>, int); \
+    template void argmaxAxis_into(size_t*, ConstMatrixViewT<T>, int); \
+    template MatrixT<T> power(ConstMatrixViewT<T>, double); \
+    template MatrixT<T> sqrt(ConstMatrixViewT<T>); \
+    template MatrixT<T> exp(ConstMatrixViewT<T>); \
+    template MatrixT<T> log(ConstMatrixViewT<T>); \
+    template void power_into(OutputViewT<T>, ConstMatrixViewT<T>, double); \
+    template void sqrt_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void exp_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void log_into(OutputViewT<T>, ConstMatrixViewT<T>); \
+    template void power_inplace(MatrixViewT<T>, double); \
+    template void sqrt_inplace(MatrixViewT<T>); \
+    template void exp_inplace(MatrixViewT<T>); \
+    template void log_inplace(MatrixViewT<T>); \
+    template T trace(ConstMatrixViewT<T>); \
+    template T determinant(ConstMatrixViewT<T>); \
+    template MatrixT<T> inverse(ConstMatrixViewT<T>);
+
+MATRIX_OPS_INSTANTIATE(float)
+MATRIX_OPS_INSTANTIATE(double)
+
+#undef MATRIX_OPS_INSTANTIATE
+
 } // namespace MatrixOps
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "../../include/matrix/memory.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace Memory {
+
+namespace {
+
+constexpr size_t NUM_POLICIES = 4;
+std::atomic<size_t> policy_counts[NUM_POLICIES];
+
+void count(Policy policy) {
+    policy_counts[static_cast<size_t>(policy)].fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t round_up(size_t bytes, size_t multiple) {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+#if defined(__linux__)
+
+bool huge_pages_enabled() {
+    static const bool enabled = [] {
+        const char* env = std::getenv("VIT_HUGE_PAGES");
+        return !(env && std::strcmp(env, "0") == 0);
+    }();
+    return enabled;
+}
+
+// Anonymous mapping of bytes (a multiple of HUGE_PAGE_SIZE) starting on a
+// 2 MB boundary, so transparent huge pages can back all of it
+void* map_aligned(size_t bytes) {
+    const size_t padded = bytes + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+    // Trim the unaligned head and the tail
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = round_up(start, HUGE_PAGE_SIZE);
+    if (aligned > start) {
+        munmap(raw, aligned - start);
+    }
+    const size_t tail = start + padded - (aligned + bytes);
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+void* map_large(size_t bytes) {
+    if (huge_pages_enabled()) {
+        // Explicit huge pages only exist if the administrator reserved some
+        // (vm.nr_hugepages); the mapping fails immediately otherwise
+        void* ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) {
+            count(Policy::ExplicitHugePages);
+            return ptr;
+        }
+    }
+
+    void* ptr = map_aligned(bytes);
+    if (!ptr) {
+        return nullptr;
+    }
+    if (huge_pages_enabled() && madvise(ptr, bytes, MADV_HUGEPAGE) == 0) {
+        count(Policy::TransparentHugePages);
+    } else {
+        count(Policy::Mapped);
+    }
+    return ptr;
+}
+
+#endif
+
+} // namespace
+
+void* allocate(size_t bytes) {
+    if (bytes == 0) {
+        return nullptr;
+    }
+#if defined(__linux__)
+    if (bytes >= HUGE_PAGE_THRESHOLD) {
+        void* ptr = map_large(round_up(bytes, HUGE_PAGE_SIZE));
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+#endif
+    // aligned_alloc requires the size to be a multiple of the alignment
+    void* ptr = std::aligned_alloc(ALIGNMENT, round_up(bytes, ALIGNMENT));
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    count(Policy::Aligned);
+    return ptr;
+}
+
+void deallocate(void* ptr, size_t bytes) {
+    if (!ptr) {
+        return;
+    }
+#if defined(__linux__)
+    // The size alone tells which allocator produced the buffer
+    if (bytes >= HUGE_PAGE_THRESHOLD) {
+        munmap(ptr, round_up(bytes, HUGE_PAGE_SIZE));
+        return;
+    }
+#endif
+    std::free(ptr);
+}
+
+size_t allocations(Policy policy) {
+    return policy_counts[static_cast<size_t>(policy)].load(std::memory_order_relaxed);
+}
+
+const char* policy_name(Policy policy) {
+    switch (policy) {
+        case Policy::Aligned: return "aligned";
+        case Policy::Mapped: return "mapped (4 KB pages)";
+        case Policy::TransparentHugePages: return "transparent huge pages";
+        case Policy::ExplicitHugePages: return "explicit huge pages";
+    }
+    return "unknown";
+}
+
+} // namespace Memory
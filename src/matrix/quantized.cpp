@@ -0,0 +1,336 @@
+#include "../../include/matrix/quantized.h"
+#include "../../include/matrix/cpu_features.h"
+#include "../../include/matrix/memory.h"
+#include "../../include/matrix/thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <utility>
+
+#if VIT_ISA_INTRINSICS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t PANEL = 16;                // Channels per packed panel
+constexpr size_t GROUP_BYTES = PANEL * 4;   // One group: 4 k of every channel
+constexpr size_t TILE_PANELS = 2;           // Panels per micro-tile
+constexpr size_t TILE_COLS = TILE_PANELS * PANEL;
+
+// Multiply-accumulates per parallel task
+constexpr size_t PARALLEL_MIN_MACS = size_t(1) << 16;
+
+template <typename T>
+struct Buffer {
+    T* ptr = nullptr;
+    size_t capacity = 0;
+
+    ~Buffer() { Memory::deallocate(ptr, capacity * sizeof(T)); }
+
+    T* reserve(size_t count) {
+        if (count > capacity) {
+            Memory::deallocate(ptr, capacity * sizeof(T));
+            ptr = nullptr;
+            capacity = 0;
+            size_t bytes = (count * sizeof(T) + 63) / 64 * 64;
+            ptr = static_cast<T*>(Memory::allocate(bytes));
+            capacity = bytes / sizeof(T);
+        }
+        return ptr;
+    }
+};
+
+// Quantized inputs of the calling thread, rows padded to whole groups
+thread_local Buffer<int8_t> quantized_rows;
+thread_local Buffer<float> row_scales;
+
+int8_t round_to_int8(float v) {
+    v = std::min(127.0f, std::max(-127.0f, v));
+    return static_cast<int8_t>(static_cast<int>(v + (v >= 0.0f ? 0.5f : -0.5f)));
+}
+
+// Quantizes k values of x into q (zero-padding to lda) with scale, or with
+// max |x| / 127 when scale is 0; returns the scale used
+template <typename T>
+float quantize_row(const T* x, size_t k, size_t lda, float scale, int8_t* q) {
+    if (scale == 0.0f) {
+        float max_abs = 0.0f;
+        for (size_t j = 0; j < k; ++j) {
+            max_abs = std::max(max_abs, std::abs(static_cast<float>(x[j])));
+        }
+        scale = max_abs / 127.0f;
+    }
+    if (scale == 0.0f) {
+        std::memset(q, 0, lda);
+        return 0.0f;
+    }
+    const float inverse = 1.0f / scale;
+    for (size_t j = 0; j < k; ++j) {
+        q[j] = round_to_int8(static_cast<float>(x[j]) * inverse);
+    }
+    std::memset(q + k, 0, lda - k);
+    return scale;
+}
+
+// A single-copy build with VNNI in its flags uses the VNNI tiles directly
+#if !VIT_MULTI_ISA && VIT_NATIVE_ISA == VIT_ISA_AVX512 && defined(__AVX512VNNI__)
+#define VIT_INT8_VNNI
+#endif
+#define VIT_ISA_SOURCE "quantized_kernels.inl"
+#include "isa_variants.inl"
+#undef VIT_INT8_VNNI
+
+#if VIT_MULTI_ISA
+// Same -Wall noise from the AVX-512 headers as in isa_variants.inl
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC push_options
+#pragma GCC target("avx512vnni,avx512f,avx512bw,avx512dq,avx512vl,avx2,fma,f16c,bmi,bmi2,lzcnt,popcnt")
+#define VIT_ISA_LEVEL VIT_ISA_AVX512
+#define VIT_INT8_VNNI
+namespace avx512_vnni {
+#include "quantized_kernels.inl"
+}
+#undef VIT_INT8_VNNI
+#undef VIT_ISA_LEVEL
+#pragma GCC pop_options
+#pragma GCC diagnostic pop
+
+// VIT_ISA_DISPATCH, taking the VNNI copy on Avx512 when the CPU has it
+#define INT8_DISPATCH(...) \
+    if (CpuFeatures::active_isa() == CpuFeatures::Isa::Avx512 && CpuFeatures::has_avx512_vnni()) { \
+        return avx512_vnni::__VA_ARGS__; \
+    } \
+    VIT_ISA_DISPATCH(__VA_ARGS__)
+#else
+#define INT8_DISPATCH(...) VIT_ISA_DISPATCH(__VA_ARGS__)
+#endif
+
+// result = a * packed through the copy of the active level
+template <typename T>
+void multiply_quantized(const int8_t* a, size_t lda, const float* a_scales, size_t m, const int8_t* packed,
+                        const int32_t* sums, const float* scales, size_t groups, size_t out, OutputViewT<T> result) {
+    INT8_DISPATCH(multiply<T>(a, lda, a_scales, m, packed, sums, scales, groups, out, result));
+}
+
+} // namespace
+
+namespace Quantization {
+
+template <typename T>
+void ActivationRange::observe(ConstMatrixViewT<T> x) {
+    if (!recording) {
+        return;
+    }
+    for (size_t i = 0; i < x.getRows(); ++i) {
+        const T* row = x.row_ptr(i);
+        for (size_t j = 0; j < x.getCols(); ++j) {
+            max_abs = std::max(max_abs, std::abs(static_cast<float>(row[j])));
+        }
+    }
+}
+
+template void ActivationRange::observe(ConstMatrixViewT<float>);
+template void ActivationRange::observe(ConstMatrixViewT<double>);
+
+template <typename T>
+void write_matrix(std::ostream& os, ConstMatrixViewT<T> m) {
+    const uint64_t shape[2] = {m.getRows(), m.getCols()};
+    os.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+    std::vector<float> row(m.getCols());
+    for (size_t i = 0; i < m.getRows(); ++i) {
+        std::copy(m.row_ptr(i), m.row_ptr(i) + m.getCols(), row.begin());
+        os.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(float));
+    }
+}
+
+template <typename T>
+void read_matrix(std::istream& is, MatrixViewT<T> dst) {
+    uint64_t shape[2];
+    is.read(reinterpret_cast<char*>(shape), sizeof(shape));
+    if (!is || shape[0] != dst.getRows() || shape[1] != dst.getCols()) {
+        throw std::runtime_error("Stored matrix does not match the expected shape");
+    }
+    std::vector<float> row(dst.getCols());
+    for (size_t i = 0; i < dst.getRows(); ++i) {
+        is.read(reinterpret_cast<char*>(row.data()), row.size() * sizeof(float));
+        std::copy(row.begin(), row.end(), dst.row_ptr(i));
+    }
+    if (!is) {
+        throw std::runtime_error("Truncated matrix");
+    }
+}
+
+template void write_matrix(std::ostream&, ConstMatrixViewT<float>);
+template void write_matrix(std::ostream&, ConstMatrixViewT<double>);
+template void read_matrix(std::istream&, MatrixViewT<float>);
+template void read_matrix(std::istream&, MatrixViewT<double>);
+
+const char* kernel_name() {
+    INT8_DISPATCH(name());
+}
+
+} // namespace Quantization
+
+QuantizedMatrix::QuantizedMatrix() : in(0), out(0), transposed(false), act_scale(0.0f) {}
+
+template <typename T>
+void QuantizedMatrix::assign(ConstMatrixViewT<T> w, bool transposed_source, float input_scale) {
+    const size_t k = transposed_source ? w.getCols() : w.getRows();
+    const size_t n = transposed_source ? w.getRows() : w.getCols();
+    auto weight = [&](size_t channel, size_t j) {
+        return static_cast<float>(transposed_source ? w(channel, j) : w(j, channel));
+    };
+
+    in = k;
+    out = n;
+    transposed = transposed_source;
+    act_scale = input_scale;
+    scales.assign(n, 0.0f);
+    std::vector<int8_t> by_channel(n * k);
+    for (size_t c = 0; c < n; ++c) {
+        float max_abs = 0.0f;
+        for (size_t j = 0; j < k; ++j) {
+            max_abs = std::max(max_abs, std::abs(weight(c, j)));
+        }
+        scales[c] = max_abs / 127.0f;
+        const float inverse = max_abs == 0.0f ? 0.0f : 127.0f / max_abs;
+        for (size_t j = 0; j < k; ++j) {
+            by_channel[c * k + j] = round_to_int8(weight(c, j) * inverse);
+        }
+    }
+    pack(by_channel);
+}
+
+void QuantizedMatrix::clear() {
+    in = 0;
+    out = 0;
+    act_scale = 0.0f;
+    scales.clear();
+    sums.clear();
+    packed.clear();
+}
+
+void QuantizedMatrix::pack(const std::vector<int8_t>& by_channel) {
+    const size_t panels = (out + PANEL - 1) / PANEL;
+    const size_t panel_stride = groups() * GROUP_BYTES;
+    packed.assign(panels * panel_stride, 0);
+    sums.assign(panels * PANEL, 0);
+    for (size_t c = 0; c < out; ++c) {
+        int8_t* panel = packed.data() + (c / PANEL) * panel_stride + (c % PANEL) * 4;
+        for (size_t j = 0; j < in; ++j) {
+            const int8_t value = by_channel[c * in + j];
+            panel[(j / 4) * GROUP_BYTES + j % 4] = value;
+            sums[c] += value;
+        }
+    }
+}
+
+std::vector<int8_t> QuantizedMatrix::unpack() const {
+    const size_t panel_stride = groups() * GROUP_BYTES;
+    std::vector<int8_t> by_channel(out * in);
+    for (size_t c = 0; c < out; ++c) {
+        const int8_t* panel = packed.data() + (c / PANEL) * panel_stride + (c % PANEL) * 4;
+        for (size_t j = 0; j < in; ++j) {
+            by_channel[c * in + j] = panel[(j / 4) * GROUP_BYTES + j % 4];
+        }
+    }
+    return by_channel;
+}
+
+template <typename T>
+void QuantizedMatrix::multiply(ConstMatrixViewT<T> x, OutputViewT<T> result) const {
+    if (x.getCols() != in) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (result.getRows() != x.getRows() || result.getCols() != out) {
+        throw std::invalid_argument("Output dimensions must be [x rows, out_features]");
+    }
+    const size_t m = x.getRows();
+    if (m == 0 || out == 0) {
+        return;
+    }
+
+    // Quantize the input rows
+    const size_t lda = groups() * 4;
+    int8_t* a = quantized_rows.reserve(m * lda);
+    float* a_scales = row_scales.reserve(m);
+    parallel_for_rows(m, in, size_t(1) << 14, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            a_scales[i] = quantize_row(x.row_ptr(i), in, lda, act_scale, a + i * lda);
+        }
+    });
+
+    multiply_quantized<T>(a, lda, a_scales, m, packed.data(), sums.data(), scales.data(), groups(), out, result);
+}
+
+template <typename T>
+void QuantizedMatrix::to_matrix(MatrixViewT<T> dst) const {
+    const size_t rows = transposed ? out : in;
+    const size_t cols = transposed ? in : out;
+    if (dst.getRows() != rows || dst.getCols() != cols) {
+        throw std::invalid_argument("Destination must have the shape of the quantized weight");
+    }
+    const std::vector<int8_t> by_channel = unpack();
+    for (size_t c = 0; c < out; ++c) {
+        for (size_t j = 0; j < in; ++j) {
+            const T value = static_cast<T>(by_channel[c * in + j] * scales[c]);
+            if (transposed) {
+                dst(c, j) = value;
+            } else {
+                dst(j, c) = value;
+            }
+        }
+    }
+}
+
+void QuantizedMatrix::write(std::ostream& os) const {
+    const uint64_t shape[2] = {in, out};
+    const uint8_t layout = transposed ? 1 : 0;
+    os.write(reinterpret_cast<const char*>(shape), sizeof(shape));
+    os.write(reinterpret_cast<const char*>(&layout), sizeof(layout));
+    os.write(reinterpret_cast<const char*>(&act_scale), sizeof(act_scale));
+    os.write(reinterpret_cast<const char*>(scales.data()), out * sizeof(float));
+    const std::vector<int8_t> by_channel = unpack();
+    os.write(reinterpret_cast<const char*>(by_channel.data()), by_channel.size());
+}
+
+void QuantizedMatrix::read(std::istream& is) {
+    uint64_t shape[2];
+    uint8_t layout;
+    float scale;
+    is.read(reinterpret_cast<char*>(shape), sizeof(shape));
+    is.read(reinterpret_cast<char*>(&layout), sizeof(layout));
+    is.read(reinterpret_cast<char*>(&scale), sizeof(scale));
+    if (!is || layout > 1 || shape[0] > (uint64_t(1) << 24) || shape[1] > (uint64_t(1) << 24)) {
+        throw std::runtime_error("Malformed quantized matrix");
+    }
+
+    std::vector<float> channel_scales(shape[1]);
+    std::vector<int8_t> by_channel(shape[0] * shape[1]);
+    is.read(reinterpret_cast<char*>(channel_scales.data()), channel_scales.size() * sizeof(float));
+    is.read(reinterpret_cast<char*>(by_channel.data()), by_channel.size());
+    if (!is) {
+        throw std::runtime_error("Truncated quantized matrix");
+    }
+
+    in = shape[0];
+    out = shape[1];
+    transposed = layout == 1;
+    act_scale = scale;
+    scales = std::move(channel_scales);
+    pack(by_channel);
+}
+
+template void QuantizedMatrix::assign(ConstMatrixViewT<float>, bool, float);
+template void QuantizedMatrix::assign(ConstMatrixViewT<double>, bool, float);
+template void QuantizedMatrix::multiply(ConstMatrixViewT<float>, OutputViewT<float>) const;
+template void QuantizedMatrix::multiply(ConstMatrixViewT<double>, OutputViewT<double>) const;
+template void QuantizedMatrix::to_matrix(MatrixViewT<float>) const;
+template void QuantizedMatrix::to_matrix(MatrixViewT<double>) const;
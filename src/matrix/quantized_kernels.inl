@@ -0,0 +1,264 @@
+// Int8 micro-tiles and the tiled product (see quantized.h) for one ISA
+// level. quantized.cpp includes it once per level through isa_variants.inl
+// and once more with VIT_INT8_VNNI defined (AVX-512 VNNI is not part of the
+// Avx512 level), so there is no include guard and every #if tests
+// VIT_ISA_LEVEL or VIT_INT8_VNNI.
+
+// Rows per micro-tile: vpdpbusd needs no temporaries, so its tile is taller
+#if defined(VIT_INT8_VNNI)
+constexpr size_t MR = 6;
+#else
+constexpr size_t MR = 4;
+#endif
+
+// ---------------------------------------------------------------------------
+// Micro-tiles: int32 sums of R quantized rows (stride lda) against P packed
+// panels (stride panel_stride) into c, TILE_COLS int32 per row
+// ---------------------------------------------------------------------------
+
+#if defined(VIT_INT8_VNNI)
+
+template <size_t R, size_t P>
+void int8_tile(const int8_t* a, size_t lda, const int8_t* b, size_t panel_stride, size_t groups,
+               const int32_t* sums, int32_t* c) {
+    __m512i acc[R][P];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            acc[r][p] = _mm512_setzero_si512();
+        }
+    }
+    // vpdpbusd multiplies unsigned by signed bytes: x + 128 as unsigned
+    const __m512i offset = _mm512_set1_epi8(static_cast<char>(0x80));
+    for (size_t g = 0; g < groups; ++g) {
+        __m512i w[P];
+        for (size_t p = 0; p < P; ++p) {
+            w[p] = _mm512_loadu_si512(b + p * panel_stride + g * GROUP_BYTES);
+        }
+        for (size_t r = 0; r < R; ++r) {
+            int32_t word;
+            std::memcpy(&word, a + r * lda + 4 * g, sizeof(word));
+            const __m512i x = _mm512_xor_si512(_mm512_set1_epi32(word), offset);
+            for (size_t p = 0; p < P; ++p) {
+                acc[r][p] = _mm512_dpbusd_epi32(acc[r][p], x, w[p]);
+            }
+        }
+    }
+    // Remove the offset's contribution, 128 * sum(w) per channel
+    for (size_t p = 0; p < P; ++p) {
+        const __m512i correction = _mm512_slli_epi32(_mm512_loadu_si512(sums + p * PANEL), 7);
+        for (size_t r = 0; r < R; ++r) {
+            _mm512_storeu_si512(c + r * TILE_COLS + p * PANEL, _mm512_sub_epi32(acc[r][p], correction));
+        }
+    }
+}
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX512
+
+template <size_t R, size_t P>
+void int8_tile(const int8_t* a, size_t lda, const int8_t* b, size_t panel_stride, size_t groups,
+               const int32_t*, int32_t* c) {
+    __m512i acc[R][P];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            acc[r][p] = _mm512_setzero_si512();
+        }
+    }
+    const __m512i ones = _mm512_set1_epi16(1);
+    const __m512i zero = _mm512_setzero_si512();
+    for (size_t g = 0; g < groups; ++g) {
+        __m512i w[P];
+        for (size_t p = 0; p < P; ++p) {
+            w[p] = _mm512_loadu_si512(b + p * panel_stride + g * GROUP_BYTES);
+        }
+        for (size_t r = 0; r < R; ++r) {
+            int32_t word;
+            std::memcpy(&word, a + r * lda + 4 * g, sizeof(word));
+            const __m512i x = _mm512_set1_epi32(word);
+            const __m512i magnitude = _mm512_abs_epi8(x);
+            const __mmask64 negative = _mm512_movepi8_mask(x);
+            for (size_t p = 0; p < P; ++p) {
+                // |x| * (sign(x) w) as on AVX2; AVX-512 has no vpsignb, so w
+                // is negated under the sign mask of x
+                const __m512i signed_w = _mm512_mask_sub_epi8(w[p], negative, zero, w[p]);
+                const __m512i pairs = _mm512_maddubs_epi16(magnitude, signed_w);
+                acc[r][p] = _mm512_add_epi32(acc[r][p], _mm512_madd_epi16(pairs, ones));
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            _mm512_storeu_si512(c + r * TILE_COLS + p * PANEL, acc[r][p]);
+        }
+    }
+}
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+template <size_t R, size_t P>
+void int8_tile(const int8_t* a, size_t lda, const int8_t* b, size_t panel_stride, size_t groups,
+               const int32_t*, int32_t* c) {
+    constexpr size_t H = 2 * P;     // 8-channel halves
+    __m256i acc[R][H];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t h = 0; h < H; ++h) {
+            acc[r][h] = _mm256_setzero_si256();
+        }
+    }
+    const __m256i ones = _mm256_set1_epi16(1);
+    for (size_t g = 0; g < groups; ++g) {
+        __m256i w[H];
+        for (size_t h = 0; h < H; ++h) {
+            w[h] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                b + (h / 2) * panel_stride + g * GROUP_BYTES + (h % 2) * 32));
+        }
+        for (size_t r = 0; r < R; ++r) {
+            int32_t word;
+            std::memcpy(&word, a + r * lda + 4 * g, sizeof(word));
+            const __m256i x = _mm256_set1_epi32(word);
+            const __m256i magnitude = _mm256_abs_epi8(x);
+            for (size_t h = 0; h < H; ++h) {
+                // |x| * (sign(x) w): pairs stay within 2 * 127 * 127
+                const __m256i pairs = _mm256_maddubs_epi16(magnitude, _mm256_sign_epi8(w[h], x));
+                acc[r][h] = _mm256_add_epi32(acc[r][h], _mm256_madd_epi16(pairs, ones));
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t h = 0; h < H; ++h) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(c + r * TILE_COLS + h * 8), acc[r][h]);
+        }
+    }
+}
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_SSE42
+
+// The AVX2 tile on 128-bit registers (pmaddubsw and psignb are SSSE3)
+template <size_t R, size_t P>
+void int8_tile(const int8_t* a, size_t lda, const int8_t* b, size_t panel_stride, size_t groups,
+               const int32_t*, int32_t* c) {
+    constexpr size_t Q = 4 * P;     // 4-channel quarters
+    __m128i acc[R][Q];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t q = 0; q < Q; ++q) {
+            acc[r][q] = _mm_setzero_si128();
+        }
+    }
+    const __m128i ones = _mm_set1_epi16(1);
+    for (size_t g = 0; g < groups; ++g) {
+        __m128i w[Q];
+        for (size_t q = 0; q < Q; ++q) {
+            w[q] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                b + (q / 4) * panel_stride + g * GROUP_BYTES + (q % 4) * 16));
+        }
+        for (size_t r = 0; r < R; ++r) {
+            int32_t word;
+            std::memcpy(&word, a + r * lda + 4 * g, sizeof(word));
+            const __m128i x = _mm_set1_epi32(word);
+            const __m128i magnitude = _mm_abs_epi8(x);
+            for (size_t q = 0; q < Q; ++q) {
+                const __m128i pairs = _mm_maddubs_epi16(magnitude, _mm_sign_epi8(w[q], x));
+                acc[r][q] = _mm_add_epi32(acc[r][q], _mm_madd_epi16(pairs, ones));
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t q = 0; q < Q; ++q) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(c + r * TILE_COLS + q * 4), acc[r][q]);
+        }
+    }
+}
+
+#else
+
+// Portable tile written for the auto-vectorizer: every accumulator of the
+// tile stays live across the groups, so each group's weights are loaded
+// once for all R rows, and the 64 byte products of a group (16 channels x
+// 4 k) become widening 16-bit multiplies (pmullw on SSE2)
+template <size_t R, size_t P>
+void int8_tile(const int8_t* a, size_t lda, const int8_t* b, size_t panel_stride, size_t groups,
+               const int32_t*, int32_t* c) {
+    int32_t acc[R][P][PANEL] = {};
+    for (size_t g = 0; g < groups; ++g) {
+        for (size_t r = 0; r < R; ++r) {
+            const int8_t* x = a + r * lda + 4 * g;
+            for (size_t p = 0; p < P; ++p) {
+                const int8_t* w = b + p * panel_stride + g * GROUP_BYTES;
+                for (size_t ch = 0; ch < PANEL; ++ch) {
+                    for (size_t j = 0; j < 4; ++j) {
+                        acc[r][p][ch] += int32_t(x[j]) * int32_t(w[ch * 4 + j]);
+                    }
+                }
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            std::memcpy(c + r * TILE_COLS + p * PANEL, acc[r][p], sizeof(acc[r][p]));
+        }
+    }
+}
+
+#endif
+
+using TileFunction = void (*)(const int8_t*, size_t, const int8_t*, size_t, size_t, const int32_t*, int32_t*);
+
+template <size_t... R>
+constexpr std::array<std::array<TileFunction, TILE_PANELS>, MR> make_tiles(std::index_sequence<R...>) {
+    return {{{{&int8_tile<R + 1, 1>, &int8_tile<R + 1, 2>}}...}};
+}
+
+// tiles[rows - 1][panels - 1]
+constexpr std::array<std::array<TileFunction, TILE_PANELS>, MR> tiles =
+    make_tiles(std::make_index_sequence<MR>());
+
+// result = (a * packed) scaled back per row and channel. a holds m quantized
+// rows of lda bytes with their scales; packed, sums and scales are the
+// QuantizedMatrix's out channels of groups * 4 k
+template <typename T>
+void multiply(const int8_t* a, size_t lda, const float* a_scales, size_t m, const int8_t* packed,
+              const int32_t* sums, const float* scales, size_t groups, size_t out, OutputViewT<T> result) {
+    // Micro-tiles of MR rows by TILE_COLS channels; consecutive tasks share
+    // their rows and sweep the packed weights
+    const size_t panels = (out + PANEL - 1) / PANEL;
+    const size_t panel_stride = groups * GROUP_BYTES;
+    const size_t row_tiles = (m + MR - 1) / MR;
+    const size_t col_tiles = (panels + TILE_PANELS - 1) / TILE_PANELS;
+    const size_t grain = std::max<size_t>(1, PARALLEL_MIN_MACS / (MR * TILE_COLS * std::max<size_t>(4 * groups, 1)));
+    parallel_for(row_tiles * col_tiles, grain, [&](size_t begin, size_t end) {
+        alignas(64) int32_t tile[MR * TILE_COLS];
+        for (size_t t = begin; t < end; ++t) {
+            const size_t i0 = (t / col_tiles) * MR;
+            const size_t p0 = (t % col_tiles) * TILE_PANELS;
+            const size_t rows = std::min(MR, m - i0);
+            const size_t tile_panels = std::min(TILE_PANELS, panels - p0);
+            tiles[rows - 1][tile_panels - 1](a + i0 * lda, lda, packed + p0 * panel_stride,
+                                             panel_stride, groups, sums + p0 * PANEL, tile);
+
+            // Scale back per row and channel
+            const size_t c0 = p0 * PANEL;
+            const size_t cols = std::min(tile_panels * PANEL, out - c0);
+            for (size_t r = 0; r < rows; ++r) {
+                const float row_scale = a_scales[i0 + r];
+                const int32_t* sums_row = tile + r * TILE_COLS;
+                T* dst = result.row_ptr(i0 + r) + c0;
+                for (size_t c = 0; c < cols; ++c) {
+                    dst[c] = static_cast<T>(static_cast<float>(sums_row[c]) * (row_scale * scales[c0 + c]));
+                }
+            }
+        }
+    });
+}
+
+const char* name() {
+#if defined(VIT_INT8_VNNI)
+    return "AVX-512 VNNI (vpdpbusd)";
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    return "AVX-512 (vpmaddubsw)";
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    return "AVX2 (vpmaddubsw)";
+#elif VIT_ISA_LEVEL >= VIT_ISA_SSE42
+    return "SSSE3 (pmaddubsw)";
+#else
+    return "scalar";
+#endif
+}
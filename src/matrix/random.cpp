@@ -0,0 +1,114 @@
+#include "../../include/matrix/random.h"
+#include "../../include/matrix/cpu_features.h"
+#include "../../include/matrix/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+
+#if VIT_ISA_INTRINSICS
+#include <immintrin.h>
+#endif
+
+namespace Random {
+
+namespace {
+
+// Philox4x32 round multipliers and Weyl key increments
+constexpr uint32_t PHILOX_M0 = 0xD2511F53u;
+constexpr uint32_t PHILOX_M1 = 0xCD9E8D57u;
+constexpr uint32_t PHILOX_W0 = 0x9E3779B9u;
+constexpr uint32_t PHILOX_W1 = 0xBB67AE85u;
+constexpr int PHILOX_ROUNDS = 10;
+
+// Blocks generated per call; each lane of the round loops is one block
+constexpr size_t BLOCKS = 16;
+constexpr size_t WORDS = 4 * BLOCKS;
+
+// Words converted per step of the typed fills
+constexpr size_t CHUNK = 256;
+// Elements per task of the parallel fills
+constexpr size_t PARALLEL_GRAIN = size_t(1) << 15;
+
+struct State {
+    std::atomic<uint64_t> seed;
+    std::atomic<uint64_t> next_stream{0};
+
+    State() : seed(initial_seed()) {}
+
+    static uint64_t initial_seed() {
+        if (const char* env = std::getenv("VIT_SEED")) {
+            return std::strtoull(env, nullptr, 0);
+        }
+        std::random_device device;
+        return (uint64_t(device()) << 32) | device();
+    }
+};
+
+State& state() {
+    static State instance;
+    return instance;
+}
+
+// One copy of the generator per ISA level: generic::bits, avx2::bits, ...
+#define VIT_ISA_SOURCE "random_kernels.inl"
+#include "isa_variants.inl"
+
+} // namespace
+
+void seed(uint64_t seed) {
+    state().seed.store(seed, std::memory_order_relaxed);
+    state().next_stream.store(0, std::memory_order_relaxed);
+}
+
+uint64_t get_seed() {
+    return state().seed.load(std::memory_order_relaxed);
+}
+
+Stream Stream::next() {
+    return Stream(state().next_stream.fetch_add(1, std::memory_order_relaxed));
+}
+
+void Stream::bits(uint64_t first, size_t count, uint32_t* dst) const {
+    VIT_ISA_DISPATCH(bits(get_seed(), id, first, count, dst));
+}
+
+void Stream::uniform(float* dst, size_t count, float lo, float hi, uint64_t first) const {
+    VIT_ISA_DISPATCH(fill_uniform(get_seed(), id, dst, count, lo, hi, first));
+}
+
+void Stream::uniform(double* dst, size_t count, double lo, double hi, uint64_t first) const {
+    VIT_ISA_DISPATCH(fill_uniform(get_seed(), id, dst, count, lo, hi, first));
+}
+
+void Stream::normal(float* dst, size_t count, float mean, float stddev, uint64_t first) const {
+    VIT_ISA_DISPATCH(fill_normal(get_seed(), id, dst, count, mean, stddev, first));
+}
+
+void Stream::normal(double* dst, size_t count, double mean, double stddev, uint64_t first) const {
+    VIT_ISA_DISPATCH(fill_normal(get_seed(), id, dst, count, mean, stddev, first));
+}
+
+template <typename T>
+void uniform(T* dst, size_t count, double lo, double hi) {
+    const Stream stream = Stream::next();
+    parallel_for(count, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+        stream.uniform(dst + begin, end - begin, static_cast<T>(lo), static_cast<T>(hi), begin);
+    });
+}
+
+template <typename T>
+void normal(T* dst, size_t count, double mean, double stddev) {
+    const Stream stream = Stream::next();
+    parallel_for(count, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+        stream.normal(dst + begin, end - begin, static_cast<T>(mean), static_cast<T>(stddev), begin);
+    });
+}
+
+template void uniform<float>(float*, size_t, double, double);
+template void uniform<double>(double*, size_t, double, double);
+template void normal<float>(float*, size_t, double, double);
+template void normal<double>(double*, size_t, double, double);
+
+} // namespace Random
@@ -0,0 +1,190 @@
+// Philox block generation and the typed fills (see random.h) for one ISA
+// level. random.cpp includes it once per level through isa_variants.inl, so
+// there is no include guard and every #if tests VIT_ISA_LEVEL. Every level
+// produces the same words; only the lane width differs.
+
+// 32-bit lane operations for the Philox rounds: one block per lane, so the
+// 16 blocks of a call take BLOCKS / WIDTH vectors per counter word
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+
+struct Lanes {
+    using V = __m512i;
+    static constexpr size_t WIDTH = 16;
+    static V load(const uint32_t* p) { return _mm512_loadu_si512(p); }
+    static void store(uint32_t* p, V v) { _mm512_storeu_si512(p, v); }
+    static V set1(uint32_t x) { return _mm512_set1_epi32(static_cast<int>(x)); }
+    static V bit_xor(V a, V b) { return _mm512_xor_si512(a, b); }
+    // Low and high halves of the 64-bit products a * m
+    static void mulhilo(V a, V m, V& lo, V& hi) {
+        lo = _mm512_mullo_epi32(a, m);
+        const V even = _mm512_srli_epi64(_mm512_mul_epu32(a, m), 32);
+        const V odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+        hi = _mm512_mask_blend_epi32(0xAAAA, even, odd);
+    }
+};
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+struct Lanes {
+    using V = __m256i;
+    static constexpr size_t WIDTH = 8;
+    static V load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void store(uint32_t* p, V v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static V set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+    static V bit_xor(V a, V b) { return _mm256_xor_si256(a, b); }
+    static void mulhilo(V a, V m, V& lo, V& hi) {
+        lo = _mm256_mullo_epi32(a, m);
+        const V even = _mm256_srli_epi64(_mm256_mul_epu32(a, m), 32);
+        const V odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+        hi = _mm256_blend_epi32(even, odd, 0xAA);
+    }
+};
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_SSE42
+
+// pmulld and pblendw are SSE4.1
+struct Lanes {
+    using V = __m128i;
+    static constexpr size_t WIDTH = 4;
+    static V load(const uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint32_t* p, V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V set1(uint32_t x) { return _mm_set1_epi32(static_cast<int>(x)); }
+    static V bit_xor(V a, V b) { return _mm_xor_si128(a, b); }
+    static void mulhilo(V a, V m, V& lo, V& hi) {
+        lo = _mm_mullo_epi32(a, m);
+        const V even = _mm_srli_epi64(_mm_mul_epu32(a, m), 32);
+        const V odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+        hi = _mm_blend_epi16(even, odd, 0xCC);
+    }
+};
+
+#else
+
+struct Lanes {
+    using V = uint32_t;
+    static constexpr size_t WIDTH = 1;
+    static V load(const uint32_t* p) { return *p; }
+    static void store(uint32_t* p, V v) { *p = v; }
+    static V set1(uint32_t x) { return x; }
+    static V bit_xor(V a, V b) { return a ^ b; }
+    static void mulhilo(V a, V m, V& lo, V& hi) {
+        const uint64_t product = uint64_t(a) * m;
+        lo = static_cast<uint32_t>(product);
+        hi = static_cast<uint32_t>(product >> 32);
+    }
+};
+
+#endif
+
+// Words [4 * block, 4 * block + WORDS) of stream id under key into out
+void philox_blocks(uint64_t key, uint64_t id, uint64_t block, uint32_t* out) {
+    using V = Lanes::V;
+    constexpr size_t VECTORS = BLOCKS / Lanes::WIDTH;
+
+    alignas(64) uint32_t c[4][BLOCKS];
+    for (size_t l = 0; l < BLOCKS; ++l) {
+        const uint64_t counter = block + l;
+        c[0][l] = static_cast<uint32_t>(counter);
+        c[1][l] = static_cast<uint32_t>(counter >> 32);
+        c[2][l] = static_cast<uint32_t>(id);
+        c[3][l] = static_cast<uint32_t>(id >> 32);
+    }
+
+    for (size_t v = 0; v < VECTORS; ++v) {
+        const size_t offset = v * Lanes::WIDTH;
+        V c0 = Lanes::load(c[0] + offset), c1 = Lanes::load(c[1] + offset);
+        V c2 = Lanes::load(c[2] + offset), c3 = Lanes::load(c[3] + offset);
+        const V m0 = Lanes::set1(PHILOX_M0), m1 = Lanes::set1(PHILOX_M1);
+        uint32_t k0 = static_cast<uint32_t>(key);
+        uint32_t k1 = static_cast<uint32_t>(key >> 32);
+        for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+            V lo0, hi0, lo1, hi1;
+            Lanes::mulhilo(c0, m0, lo0, hi0);
+            Lanes::mulhilo(c2, m1, lo1, hi1);
+            c0 = Lanes::bit_xor(Lanes::bit_xor(hi1, c1), Lanes::set1(k0));
+            c2 = Lanes::bit_xor(Lanes::bit_xor(hi0, c3), Lanes::set1(k1));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+        Lanes::store(c[0] + offset, c0);
+        Lanes::store(c[1] + offset, c1);
+        Lanes::store(c[2] + offset, c2);
+        Lanes::store(c[3] + offset, c3);
+    }
+
+    for (size_t l = 0; l < BLOCKS; ++l) {
+        out[4 * l] = c[0][l];
+        out[4 * l + 1] = c[1][l];
+        out[4 * l + 2] = c[2][l];
+        out[4 * l + 3] = c[3][l];
+    }
+}
+
+// Stream::bits of stream id under key
+void bits(uint64_t key, uint64_t id, uint64_t first, size_t count, uint32_t* dst) {
+    uint32_t words[WORDS];
+    uint64_t pos = first;
+    const uint64_t end = first + count;
+    while (pos < end) {
+        if (pos % 4 == 0 && end - pos >= WORDS) {
+            // Whole blocks straight into dst
+            philox_blocks(key, id, pos / 4, dst + (pos - first));
+            pos += WORDS;
+            continue;
+        }
+        // Generate the BLOCKS blocks starting at the block holding pos
+        const uint64_t base = pos / 4 * 4;
+        philox_blocks(key, id, base / 4, words);
+        const uint64_t stop = std::min<uint64_t>(end, base + WORDS);
+        for (uint64_t w = pos; w < stop; ++w) {
+            dst[w - first] = words[w - base];
+        }
+        pos = stop;
+    }
+}
+
+// Uniform on [0, 1) and on (0, 1] from one word (24 bits for float)
+inline float unit_open_above(uint32_t w, float) { return static_cast<float>(w >> 8) * 0x1p-24f; }
+inline double unit_open_above(uint32_t w, double) { return static_cast<double>(w) * 0x1p-32; }
+inline float unit_open_below(uint32_t w, float) { return static_cast<float>((w >> 8) + 1) * 0x1p-24f; }
+inline double unit_open_below(uint32_t w, double) { return (static_cast<double>(w) + 1.0) * 0x1p-32; }
+
+template <typename T>
+void fill_uniform(uint64_t key, uint64_t id, T* dst, size_t count, T lo, T hi, uint64_t first) {
+    const T scale = hi - lo;
+    uint32_t words[CHUNK];
+    for (size_t done = 0; done < count; done += CHUNK) {
+        const size_t n = std::min(CHUNK, count - done);
+        bits(key, id, first + done, n, words);
+        for (size_t i = 0; i < n; ++i) {
+            dst[done + i] = lo + scale * unit_open_above(words[i], T());
+        }
+    }
+}
+
+// Element i takes the cosine (i even) or sine (i odd) branch of the
+// Box-Muller pair built from words (i & ~1, i | 1)
+template <typename T>
+void fill_normal(uint64_t key, uint64_t id, T* dst, size_t count, T mean, T stddev, uint64_t first) {
+    constexpr T TWO_PI = static_cast<T>(6.283185307179586476925);
+    const uint64_t begin = first & ~uint64_t(1);
+    const uint64_t end = first + count;
+    uint32_t words[CHUNK];
+    for (uint64_t pos = begin; pos < end; pos += CHUNK) {
+        const size_t n = static_cast<size_t>(std::min<uint64_t>(CHUNK, (end - pos + 1) & ~uint64_t(1)));
+        bits(key, id, pos, n, words);
+        for (size_t i = 0; i < n; i += 2) {
+            const T radius = stddev * std::sqrt(T(-2) * std::log(unit_open_below(words[i], T())));
+            const T angle = TWO_PI * unit_open_above(words[i + 1], T());
+            const uint64_t element = pos + i;
+            if (element >= first) {
+                dst[element - first] = mean + radius * std::cos(angle);
+            }
+            if (element + 1 < end) {
+                dst[element + 1 - first] = mean + radius * std::sin(angle);
+            }
+        }
+    }
+}
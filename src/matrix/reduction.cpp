@@ -0,0 +1,45 @@
+#include "../../include/matrix/reduction.h"
+#include "../../include/matrix/cpu_features.h"
+#include <algorithm>
+#include <limits>
+
+namespace Reduction {
+
+namespace {
+
+// One copy of the kernels per ISA level: generic::sum, avx2::sum, ...
+#define VIT_ISA_SOURCE "reduction_kernels.inl"
+#include "isa_variants.inl"
+
+} // namespace
+
+template <typename T>
+T sum(const T* src, size_t count) {
+    VIT_ISA_DISPATCH(sum(src, count));
+}
+
+template <typename T>
+T sum_squared_deviation(const T* src, size_t count, T center) {
+    VIT_ISA_DISPATCH(sum_squared_deviation(src, count, center));
+}
+
+template <typename T>
+T max(const T* src, size_t count) {
+    VIT_ISA_DISPATCH(max(src, count));
+}
+
+template <typename T>
+size_t argmax(const T* src, size_t count) {
+    VIT_ISA_DISPATCH(argmax(src, count));
+}
+
+template float sum(const float*, size_t);
+template double sum(const double*, size_t);
+template float sum_squared_deviation(const float*, size_t, float);
+template double sum_squared_deviation(const double*, size_t, double);
+template float max(const float*, size_t);
+template double max(const double*, size_t);
+template size_t argmax(const float*, size_t);
+template size_t argmax(const double*, size_t);
+
+} // namespace Reduction
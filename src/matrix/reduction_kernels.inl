@@ -0,0 +1,111 @@
+// Pairwise sums and max/argmax (see reduction.h) for one ISA level.
+// reduction.cpp includes it once per level through isa_variants.inl, so
+// there is no include guard. The code is plain C++ written for the
+// auto-vectorizer; only the target options differ between the copies.
+
+// Independent accumulators of a block: 256 bytes, four 512-bit (or eight
+// 256-bit) registers, enough to hide the add latency. Each lane only ever
+// adds its own elements, so vectorizing them reorders nothing.
+template <typename T>
+constexpr size_t LANES = 256 / sizeof(T);
+
+// Sum of term(src[i]) over one block: lane accumulators, then a tree fold
+template <typename T, typename Term>
+T block_sum(const T* src, size_t count, Term term) {
+    constexpr size_t L = LANES<T>;
+    T acc[L] = {};
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t l = 0; l < L; ++l) {
+            acc[l] += term(src[i + l]);
+        }
+    }
+    for (size_t l = 0; i + l < count; ++l) {
+        acc[l] += term(src[i + l]);
+    }
+    for (size_t width = L / 2; width > 0; width /= 2) {
+        for (size_t l = 0; l < width; ++l) {
+            acc[l] += acc[l + width];
+        }
+    }
+    return acc[0];
+}
+
+// Recursive halving down to blocks; the split stays a multiple of the lane
+// count so every block but the last runs whole lane rows
+template <typename T, typename Term>
+T pairwise_sum(const T* src, size_t count, Term term) {
+    if (count <= PAIRWISE_BLOCK) {
+        return block_sum(src, count, term);
+    }
+    const size_t half = count / 2 / LANES<T> * LANES<T>;
+    return pairwise_sum(src, half, term) + pairwise_sum(src + half, count - half, term);
+}
+
+// Index of the first element equal to value (count if none): whole lane
+// rows are tested with a vectorized compare, the scalar loop only runs on
+// the row holding the match and the tail
+template <typename T>
+size_t find_first(const T* src, size_t count, T value) {
+    constexpr size_t L = LANES<T>;
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        int hits = 0;
+        for (size_t l = 0; l < L; ++l) {
+            hits += src[i + l] == value;
+        }
+        if (hits) {
+            break;
+        }
+    }
+    for (; i < count; ++i) {
+        if (src[i] == value) {
+            return i;
+        }
+    }
+    return count;
+}
+
+template <typename T>
+T sum(const T* src, size_t count) {
+    return pairwise_sum(src, count, [](T x) { return x; });
+}
+
+template <typename T>
+T sum_squared_deviation(const T* src, size_t count, T center) {
+    return pairwise_sum(src, count, [center](T x) {
+        const T d = x - center;
+        return d * d;
+    });
+}
+
+template <typename T>
+T max(const T* src, size_t count) {
+    constexpr size_t L = LANES<T>;
+    T acc[L];
+    std::fill(acc, acc + L, -std::numeric_limits<T>::infinity());
+    size_t i = 0;
+    for (; i + L <= count; i += L) {
+        for (size_t l = 0; l < L; ++l) {
+            // NaN compares false and leaves the lane unchanged
+            acc[l] = src[i + l] > acc[l] ? src[i + l] : acc[l];
+        }
+    }
+    for (size_t l = 0; i + l < count; ++l) {
+        acc[l] = src[i + l] > acc[l] ? src[i + l] : acc[l];
+    }
+    for (size_t width = L / 2; width > 0; width /= 2) {
+        for (size_t l = 0; l < width; ++l) {
+            acc[l] = acc[l + width] > acc[l] ? acc[l + width] : acc[l];
+        }
+    }
+    return acc[0];
+}
+
+template <typename T>
+size_t argmax(const T* src, size_t count) {
+    // Vectorized max, then the first element equal to it
+    const T largest = max(src, count);
+    const size_t index = find_first(src, count, largest);
+    return index < count ? index : 0;
+}
@@ -0,0 +1,203 @@
+#include "../../include/matrix/sparse.h"
+#include "../../include/matrix/cpu_features.h"
+#include "../../include/matrix/thread_pool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if VIT_ISA_INTRINSICS
+#include <immintrin.h>
+#endif
+
+namespace {
+
+constexpr size_t PANEL = 16;                // Channels per packed panel
+constexpr size_t GROUP_VALUES = PANEL * 2;  // One group: 2 kept weights of every channel
+constexpr size_t TILE_PANELS = 2;           // Panels per micro-tile
+constexpr size_t TILE_COLS = TILE_PANELS * PANEL;
+
+// Multiply-accumulates per parallel task
+constexpr size_t PARALLEL_MIN_MACS = size_t(1) << 16;
+
+// Positions (first < second) of the two largest |w| among 4; ties keep the
+// earlier position
+template <typename Get>
+std::pair<unsigned, unsigned> kept_pair(Get w) {
+    unsigned best = 0;
+    for (unsigned j = 1; j < 4; ++j) {
+        if (std::abs(w(j)) > std::abs(w(best))) {
+            best = j;
+        }
+    }
+    unsigned second = best == 0 ? 1 : 0;
+    for (unsigned j = 0; j < 4; ++j) {
+        if (j != best && std::abs(w(j)) > std::abs(w(second))) {
+            second = j;
+        }
+    }
+    return {std::min(best, second), std::max(best, second)};
+}
+
+#define VIT_ISA_SOURCE "sparse_kernels.inl"
+#include "isa_variants.inl"
+
+// result = x * W through the copy of the active level
+void multiply_sparse(ConstMatrixViewT<float> x, OutputViewT<float> result, const float* values,
+                     const uint8_t* indices, size_t groups, size_t out) {
+    VIT_ISA_DISPATCH(multiply(x, result, values, indices, groups, out));
+}
+
+} // namespace
+
+namespace Sparsity {
+
+template <typename T>
+void prune_2_4(MatrixViewT<T> w) {
+    if (w.getRows() % 4 != 0) {
+        throw std::invalid_argument("2:4 pruning needs a multiple of 4 rows");
+    }
+    for (size_t g = 0; g < w.getRows(); g += 4) {
+        for (size_t c = 0; c < w.getCols(); ++c) {
+            const auto kept = kept_pair([&](unsigned j) { return w(g + j, c); });
+            for (unsigned j = 0; j < 4; ++j) {
+                if (j != kept.first && j != kept.second) {
+                    w(g + j, c) = T(0);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+bool is_2_4_sparse(ConstMatrixViewT<T> w) {
+    if (w.getRows() % 4 != 0) {
+        return false;
+    }
+    for (size_t g = 0; g < w.getRows(); g += 4) {
+        for (size_t c = 0; c < w.getCols(); ++c) {
+            int nonzeros = 0;
+            for (size_t j = 0; j < 4; ++j) {
+                nonzeros += w(g + j, c) != T(0);
+            }
+            if (nonzeros > 2) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template void prune_2_4(MatrixViewT<float>);
+template void prune_2_4(MatrixViewT<double>);
+template bool is_2_4_sparse(ConstMatrixViewT<float>);
+template bool is_2_4_sparse(ConstMatrixViewT<double>);
+
+const char* kernel_name() {
+    VIT_ISA_DISPATCH(name());
+}
+
+} // namespace Sparsity
+
+SparseMatrix::SparseMatrix() : in(0), out(0) {}
+
+template <typename T>
+void SparseMatrix::assign(ConstMatrixViewT<T> w) {
+    if (w.getRows() % 4 != 0) {
+        throw std::invalid_argument("2:4 sparsity needs in_features divisible by 4");
+    }
+    in = w.getRows();
+    out = w.getCols();
+    const size_t panels = (out + PANEL - 1) / PANEL;
+    values.assign(panels * groups() * GROUP_VALUES, 0.0f);
+    indices.assign(panels * groups() * PANEL, 0);
+    for (size_t c = 0; c < out; ++c) {
+        const size_t panel = c / PANEL, ch = c % PANEL;
+        for (size_t g = 0; g < groups(); ++g) {
+            const auto kept = kept_pair([&](unsigned j) { return w(4 * g + j, c); });
+            float* group_values = values.data() + (panel * groups() + g) * GROUP_VALUES;
+            group_values[ch] = static_cast<float>(w(4 * g + kept.first, c));
+            group_values[PANEL + ch] = static_cast<float>(w(4 * g + kept.second, c));
+            indices[(panel * groups() + g) * PANEL + ch] = static_cast<uint8_t>(kept.first | kept.second << 2);
+        }
+    }
+}
+
+void SparseMatrix::clear() {
+    in = 0;
+    out = 0;
+    values.clear();
+    indices.clear();
+}
+
+template <typename T>
+void SparseMatrix::multiply(ConstMatrixViewT<T> x, OutputViewT<T> result) const {
+    if (x.getCols() != in) {
+        throw std::invalid_argument("Matrix dimensions incompatible for multiplication");
+    }
+    if (result.getRows() != x.getRows() || result.getCols() != out) {
+        throw std::invalid_argument("Output dimensions must be [x rows, out_features]");
+    }
+    const size_t m = x.getRows();
+    if (m == 0 || out == 0) {
+        return;
+    }
+
+    if constexpr (!std::is_same<T, float>::value) {
+        // Double precision reference: plain loops over the kept weights,
+        // accumulating in T
+        const size_t panels = (out + PANEL - 1) / PANEL;
+        const size_t value_stride = groups() * GROUP_VALUES;
+        const size_t index_stride = groups() * PANEL;
+        parallel_for_rows(m, in * out / 2, PARALLEL_MIN_MACS, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                const T* row = x.row_ptr(i);
+                for (size_t p = 0; p < panels; ++p) {
+                    T acc[PANEL] = {};
+                    for (size_t g = 0; g < groups(); ++g) {
+                        const T* group_x = row + 4 * g;
+                        const float* w = values.data() + p * value_stride + g * GROUP_VALUES;
+                        const uint8_t* select = indices.data() + p * index_stride + g * PANEL;
+                        for (size_t ch = 0; ch < PANEL; ++ch) {
+                            acc[ch] += group_x[select[ch] & 3] * T(w[ch]);
+                            acc[ch] += group_x[select[ch] >> 2] * T(w[PANEL + ch]);
+                        }
+                    }
+                    const size_t c0 = p * PANEL;
+                    std::copy(acc, acc + std::min(PANEL, out - c0), result.row_ptr(i) + c0);
+                }
+            }
+        });
+    } else {
+        multiply_sparse(x, result, values.data(), indices.data(), groups(), out);
+    }
+}
+
+template <typename T>
+void SparseMatrix::to_matrix(MatrixViewT<T> dst) const {
+    if (dst.getRows() != in || dst.getCols() != out) {
+        throw std::invalid_argument("Destination must have the shape of the sparse weight");
+    }
+    for (size_t j = 0; j < in; ++j) {
+        std::fill(dst.row_ptr(j), dst.row_ptr(j) + out, T(0));
+    }
+    for (size_t c = 0; c < out; ++c) {
+        const size_t panel = c / PANEL, ch = c % PANEL;
+        for (size_t g = 0; g < groups(); ++g) {
+            const float* group_values = values.data() + (panel * groups() + g) * GROUP_VALUES;
+            const uint8_t select = indices[(panel * groups() + g) * PANEL + ch];
+            dst(4 * g + (select & 3), c) = static_cast<T>(group_values[ch]);
+            dst(4 * g + (select >> 2), c) = static_cast<T>(group_values[PANEL + ch]);
+        }
+    }
+}
+
+template void SparseMatrix::assign(ConstMatrixViewT<float>);
+template void SparseMatrix::assign(ConstMatrixViewT<double>);
+template void SparseMatrix::multiply(ConstMatrixViewT<float>, OutputViewT<float>) const;
+template void SparseMatrix::multiply(ConstMatrixViewT<double>, OutputViewT<double>) const;
+template void SparseMatrix::to_matrix(MatrixViewT<float>) const;
+template void SparseMatrix::to_matrix(MatrixViewT<double>) const;
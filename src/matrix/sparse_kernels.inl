@@ -0,0 +1,229 @@
+// 2:4 sparse micro-tiles and the tiled float product (see sparse.h) for one
+// ISA level. sparse.cpp includes it once per level through
+// isa_variants.inl, so there is no include guard and every #if tests
+// VIT_ISA_LEVEL.
+
+// Rows per micro-tile
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+constexpr size_t MR = 6;
+#else
+constexpr size_t MR = 4;
+#endif
+
+// ---------------------------------------------------------------------------
+// Micro-tiles: R rows of x (stride lda) against P packed panels into c
+// (stride ldc)
+// ---------------------------------------------------------------------------
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+
+template <size_t R, size_t P>
+void sparse_tile(const float* a, size_t lda, const float* v, size_t value_stride, const uint8_t* idx,
+                 size_t index_stride, size_t groups, float* c, size_t ldc) {
+    __m512 acc[R][P];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            acc[r][p] = _mm512_setzero_ps();
+        }
+    }
+    for (size_t g = 0; g < groups; ++g) {
+        __m512 w0[P], w1[P];
+        __m512i select0[P], select1[P];
+        for (size_t p = 0; p < P; ++p) {
+            w0[p] = _mm512_loadu_ps(v + p * value_stride + g * GROUP_VALUES);
+            w1[p] = _mm512_loadu_ps(v + p * value_stride + g * GROUP_VALUES + PANEL);
+            // vpermilps reads bits 1:0 of each control element
+            select0[p] = _mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(idx + p * index_stride + g * PANEL)));
+            select1[p] = _mm512_srli_epi32(select0[p], 2);
+        }
+        for (size_t r = 0; r < R; ++r) {
+            // The group's 4 inputs in every 128-bit lane
+            const __m512 x = _mm512_broadcast_f32x4(_mm_loadu_ps(a + r * lda + 4 * g));
+            for (size_t p = 0; p < P; ++p) {
+                acc[r][p] = _mm512_fmadd_ps(_mm512_permutevar_ps(x, select0[p]), w0[p], acc[r][p]);
+                acc[r][p] = _mm512_fmadd_ps(_mm512_permutevar_ps(x, select1[p]), w1[p], acc[r][p]);
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            _mm512_storeu_ps(c + r * ldc + p * PANEL, acc[r][p]);
+        }
+    }
+}
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+template <size_t R, size_t P>
+void sparse_tile(const float* a, size_t lda, const float* v, size_t value_stride, const uint8_t* idx,
+                 size_t index_stride, size_t groups, float* c, size_t ldc) {
+    constexpr size_t H = 2 * P;     // 8-channel halves
+    __m256 acc[R][H];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t h = 0; h < H; ++h) {
+            acc[r][h] = _mm256_setzero_ps();
+        }
+    }
+    for (size_t g = 0; g < groups; ++g) {
+        __m256 w0[H], w1[H];
+        __m256i select0[H], select1[H];
+        for (size_t h = 0; h < H; ++h) {
+            const float* values = v + (h / 2) * value_stride + g * GROUP_VALUES + (h % 2) * 8;
+            w0[h] = _mm256_loadu_ps(values);
+            w1[h] = _mm256_loadu_ps(values + PANEL);
+            select0[h] = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+                reinterpret_cast<const __m128i*>(idx + (h / 2) * index_stride + g * PANEL + (h % 2) * 8)));
+            select1[h] = _mm256_srli_epi32(select0[h], 2);
+        }
+        for (size_t r = 0; r < R; ++r) {
+            const __m256 x = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + r * lda + 4 * g));
+            for (size_t h = 0; h < H; ++h) {
+                acc[r][h] = _mm256_fmadd_ps(_mm256_permutevar_ps(x, select0[h]), w0[h], acc[r][h]);
+                acc[r][h] = _mm256_fmadd_ps(_mm256_permutevar_ps(x, select1[h]), w1[h], acc[r][h]);
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t h = 0; h < H; ++h) {
+            _mm256_storeu_ps(c + r * ldc + h * 8, acc[r][h]);
+        }
+    }
+}
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_SSE42
+
+// The AVX2 tile on 128-bit registers, without vpermilps or FMA: pshufb
+// (SSSE3) picks each channel's inputs with byte controls (4 s + 0..3) built
+// once per group, then a multiply and an add
+template <size_t R, size_t P>
+void sparse_tile(const float* a, size_t lda, const float* v, size_t value_stride, const uint8_t* idx,
+                 size_t index_stride, size_t groups, float* c, size_t ldc) {
+    constexpr size_t Q = 4 * P;     // 4-channel quarters
+    __m128 acc[R][Q];
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t q = 0; q < Q; ++q) {
+            acc[r][q] = _mm_setzero_ps();
+        }
+    }
+    const __m128i low_bits = _mm_set1_epi32(3);
+    const __m128i spread = _mm_set1_epi32(0x04040404);
+    const __m128i bytes = _mm_set1_epi32(0x03020100);
+    for (size_t g = 0; g < groups; ++g) {
+        __m128 w0[Q], w1[Q];
+        __m128i select0[Q], select1[Q];
+        for (size_t q = 0; q < Q; ++q) {
+            const float* values = v + (q / 4) * value_stride + g * GROUP_VALUES + (q % 4) * 4;
+            w0[q] = _mm_loadu_ps(values);
+            w1[q] = _mm_loadu_ps(values + PANEL);
+            int32_t word;
+            std::memcpy(&word, idx + (q / 4) * index_stride + g * PANEL + (q % 4) * 4, sizeof(word));
+            const __m128i select = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(word));
+            select0[q] = _mm_add_epi8(_mm_mullo_epi32(_mm_and_si128(select, low_bits), spread), bytes);
+            select1[q] = _mm_add_epi8(_mm_mullo_epi32(_mm_srli_epi32(select, 2), spread), bytes);
+        }
+        for (size_t r = 0; r < R; ++r) {
+            const __m128i x = _mm_castps_si128(_mm_loadu_ps(a + r * lda + 4 * g));
+            for (size_t q = 0; q < Q; ++q) {
+                acc[r][q] = _mm_add_ps(acc[r][q], _mm_mul_ps(_mm_castsi128_ps(_mm_shuffle_epi8(x, select0[q])), w0[q]));
+                acc[r][q] = _mm_add_ps(acc[r][q], _mm_mul_ps(_mm_castsi128_ps(_mm_shuffle_epi8(x, select1[q])), w1[q]));
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t q = 0; q < Q; ++q) {
+            _mm_storeu_ps(c + r * ldc + q * 4, acc[r][q]);
+        }
+    }
+}
+
+#else
+
+// Portable tile: every accumulator of the tile stays live across the
+// groups, so each group's weights and metadata are read once for all R rows
+template <size_t R, size_t P>
+void sparse_tile(const float* a, size_t lda, const float* v, size_t value_stride, const uint8_t* idx,
+                 size_t index_stride, size_t groups, float* c, size_t ldc) {
+    float acc[R][P][PANEL] = {};
+    for (size_t g = 0; g < groups; ++g) {
+        for (size_t p = 0; p < P; ++p) {
+            const float* w = v + p * value_stride + g * GROUP_VALUES;
+            const uint8_t* select = idx + p * index_stride + g * PANEL;
+            for (size_t r = 0; r < R; ++r) {
+                const float* x = a + r * lda + 4 * g;
+                for (size_t ch = 0; ch < PANEL; ++ch) {
+                    acc[r][p][ch] += x[select[ch] & 3] * w[ch];
+                    acc[r][p][ch] += x[select[ch] >> 2] * w[PANEL + ch];
+                }
+            }
+        }
+    }
+    for (size_t r = 0; r < R; ++r) {
+        for (size_t p = 0; p < P; ++p) {
+            std::memcpy(c + r * ldc + p * PANEL, acc[r][p], sizeof(acc[r][p]));
+        }
+    }
+}
+
+#endif
+
+using TileFunction = void (*)(const float*, size_t, const float*, size_t, const uint8_t*, size_t, size_t, float*, size_t);
+
+template <size_t... R>
+constexpr std::array<std::array<TileFunction, TILE_PANELS>, MR> make_tiles(std::index_sequence<R...>) {
+    return {{{{&sparse_tile<R + 1, 1>, &sparse_tile<R + 1, 2>}}...}};
+}
+
+// tiles[rows - 1][panels - 1]
+constexpr std::array<std::array<TileFunction, TILE_PANELS>, MR> tiles =
+    make_tiles(std::make_index_sequence<MR>());
+
+// result = x * W for the packed values and indices of a SparseMatrix with
+// groups * 4 inputs and out channels
+void multiply(ConstMatrixViewT<float> x, OutputViewT<float> result, const float* values, const uint8_t* indices,
+              size_t groups, size_t out) {
+    const size_t m = x.getRows();
+    const size_t panels = (out + PANEL - 1) / PANEL;
+    const size_t value_stride = groups * GROUP_VALUES;
+    const size_t index_stride = groups * PANEL;
+    // Micro-tiles of MR rows by TILE_COLS channels; consecutive tasks share
+    // their rows and sweep the packed weights
+    const size_t row_tiles = (m + MR - 1) / MR;
+    const size_t col_tiles = (panels + TILE_PANELS - 1) / TILE_PANELS;
+    const size_t grain = std::max<size_t>(1, PARALLEL_MIN_MACS / (MR * TILE_COLS * std::max<size_t>(2 * groups, 1)));
+    parallel_for(row_tiles * col_tiles, grain, [&](size_t begin, size_t end) {
+        alignas(64) float tile[MR * TILE_COLS];
+        for (size_t t = begin; t < end; ++t) {
+            const size_t i0 = (t / col_tiles) * MR;
+            const size_t p0 = (t % col_tiles) * TILE_PANELS;
+            const size_t rows = std::min(MR, m - i0);
+            const size_t tile_panels = std::min(TILE_PANELS, panels - p0);
+            // Whole panels go straight to the output, a partial last panel
+            // through the tile buffer
+            const size_t c0 = p0 * PANEL;
+            const size_t cols = std::min(tile_panels * PANEL, out - c0);
+            const bool direct = cols == tile_panels * PANEL;
+            tiles[rows - 1][tile_panels - 1](x.row_ptr(i0), x.getStride(), values + p0 * value_stride,
+                                             value_stride, indices + p0 * index_stride, index_stride,
+                                             groups, direct ? result.row_ptr(i0) + c0 : tile,
+                                             direct ? result.getStride() : TILE_COLS);
+            if (!direct) {
+                for (size_t r = 0; r < rows; ++r) {
+                    std::memcpy(result.row_ptr(i0 + r) + c0, tile + r * TILE_COLS, cols * sizeof(float));
+                }
+            }
+        }
+    });
+}
+
+const char* name() {
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    return "AVX-512 (vpermilps + FMA)";
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    return "AVX2 (vpermilps + FMA)";
+#elif VIT_ISA_LEVEL >= VIT_ISA_SSE42
+    return "SSSE3 (pshufb)";
+#else
+    return "scalar";
+#endif
+}
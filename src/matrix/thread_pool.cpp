@@ -0,0 +1,231 @@
+#include "../../include/matrix/thread_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace {
+
+// Chunks handed out per thread; more than one leaves room for stealing
+constexpr size_t CHUNKS_PER_THREAD = 8;
+
+uint64_t pack(size_t lo, size_t hi) { return (static_cast<uint64_t>(lo) << 32) | static_cast<uint64_t>(hi); }
+size_t range_lo(uint64_t range) { return static_cast<size_t>(range >> 32); }
+size_t range_hi(uint64_t range) { return static_cast<size_t>(range & 0xffffffffu); }
+
+size_t default_threads() {
+    if (const char* env = std::getenv("VIT_NUM_THREADS")) {
+        long requested = std::strtol(env, nullptr, 10);
+        if (requested > 0) {
+            return static_cast<size_t>(requested);
+        }
+    }
+    return ThreadPool::physical_cores();
+}
+
+} // namespace
+
+thread_local bool ThreadPool::inside_region = false;
+
+ThreadPool::ThreadPool(size_t num_threads) {
+    start(num_threads);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool(default_threads());
+    return pool;
+}
+
+size_t ThreadPool::physical_cores() {
+    size_t logical = std::max(1u, std::thread::hardware_concurrency());
+#if defined(__linux__)
+    // Count distinct (package, core) pairs among the CPUs we may run on
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        std::set<std::pair<int, int>> cores;
+        size_t allowed = 0;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (!CPU_ISSET(cpu, &mask)) {
+                continue;
+            }
+            ++allowed;
+            const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            std::ifstream package_file(topology + "physical_package_id");
+            std::ifstream core_file(topology + "core_id");
+            int package = 0, core = cpu;
+            if (package_file >> package && core_file >> core) {
+                cores.insert({package, core});
+            } else {
+                cores.insert({-1, cpu});
+            }
+        }
+        if (!cores.empty()) {
+            return std::min(cores.size(), allowed);
+        }
+    }
+#endif
+    return logical;
+}
+
+void ThreadPool::start(size_t num_threads) {
+    num_threads = std::max<size_t>(1, num_threads);
+    slots = std::vector<Slot>(num_threads);
+    workers.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+        // The worker starts from the current generation so a job issued
+        // before it gets scheduled is not missed
+        workers.emplace_back(&ThreadPool::worker_loop, this, i, generation);
+    }
+}
+
+void ThreadPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    stopping = false;
+}
+
+void ThreadPool::resize(size_t num_threads) {
+    std::lock_guard<std::mutex> owner(job_mutex);
+    if (std::max<size_t>(1, num_threads) == size()) {
+        return;
+    }
+    stop();
+    start(num_threads);
+}
+
+void ThreadPool::worker_loop(size_t index, uint64_t seen) {
+    inside_region = true;
+    for (;;) {
+        bool participating;
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            participating = index < job.participants;
+        }
+        if (!participating) {
+            continue;
+        }
+
+        participate(index);
+        if (active.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(state_mutex);
+            finished.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(size_t count, size_t grain, void (*invoke)(void*, size_t, size_t), void* body) {
+    // Rounded down, so every chunk (count / num_chunks items or one more) holds at least grain
+    size_t num_chunks = count / grain;
+    if (workers.empty() || num_chunks < 2 || inside_region || !job_mutex.try_lock()) {
+        invoke(body, 0, count);
+        return;
+    }
+    std::lock_guard<std::mutex> owner(job_mutex, std::adopt_lock);
+
+    num_chunks = std::min(num_chunks, size() * CHUNKS_PER_THREAD);
+    const size_t participants = std::min(size(), num_chunks);
+    for (size_t p = 0; p < participants; ++p) {
+        slots[p].range.store(pack(p * num_chunks / participants, (p + 1) * num_chunks / participants),
+                             std::memory_order_relaxed);
+    }
+    failed.store(false, std::memory_order_relaxed);
+    error = nullptr;
+    active.store(participants - 1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        job = {invoke, body, count, num_chunks, participants};
+        ++generation;
+    }
+    wake.notify_all();
+
+    inside_region = true;
+    participate(0);
+    inside_region = false;
+
+    {
+        std::unique_lock<std::mutex> lock(state_mutex);
+        finished.wait(lock, [&] { return active.load(std::memory_order_acquire) == 0; });
+    }
+    if (error) {
+        std::exception_ptr thrown = std::exchange(error, nullptr);
+        std::rethrow_exception(thrown);
+    }
+}
+
+void ThreadPool::participate(size_t index) {
+    size_t chunk;
+    while (take_chunk(index, chunk)) {
+        run_chunk(chunk);
+    }
+}
+
+bool ThreadPool::take_chunk(size_t index, size_t& chunk) {
+    // Own run first, from the front
+    std::atomic<uint64_t>& own = slots[index].range;
+    uint64_t range = own.load(std::memory_order_acquire);
+    while (range_lo(range) < range_hi(range)) {
+        if (own.compare_exchange_weak(range, pack(range_lo(range) + 1, range_hi(range)),
+                                      std::memory_order_acq_rel)) {
+            chunk = range_lo(range);
+            return true;
+        }
+    }
+
+    // Then steal the back half of another thread's run
+    const size_t participants = job.participants;
+    for (size_t offset = 1; offset < participants; ++offset) {
+        std::atomic<uint64_t>& victim = slots[(index + offset) % participants].range;
+        range = victim.load(std::memory_order_acquire);
+        while (range_lo(range) < range_hi(range)) {
+            const size_t lo = range_lo(range);
+            const size_t hi = range_hi(range);
+            const size_t split = hi - (hi - lo + 1) / 2;
+            if (victim.compare_exchange_weak(range, pack(lo, split), std::memory_order_acq_rel)) {
+                // Run the first stolen chunk now and keep the rest as our own run
+                chunk = split;
+                own.store(pack(split + 1, hi), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run_chunk(size_t chunk) {
+    if (failed.load(std::memory_order_relaxed)) {
+        return;
+    }
+    const size_t begin = chunk * job.count / job.num_chunks;
+    const size_t end = (chunk + 1) * job.count / job.num_chunks;
+    try {
+        job.invoke(job.body, begin, end);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+        failed.store(true, std::memory_order_relaxed);
+    }
+}
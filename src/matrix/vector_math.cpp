@@ -0,0 +1,120 @@
+#include "../../include/matrix/vector_math.h"
+#include "../../include/matrix/cpu_features.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(VIT_EXACT_MATH) && VIT_ISA_INTRINSICS
+#include <immintrin.h>
+#endif
+
+namespace VectorMath {
+
+namespace {
+
+#if !defined(VIT_EXACT_MATH)
+
+// One copy of the polynomial kernels per ISA level: generic::exp, avx2::exp, ...
+#define VIT_ISA_SOURCE "vector_math_kernels.inl"
+#include "isa_variants.inl"
+
+#endif // !VIT_EXACT_MATH
+
+// libm reference path (double always, float with VIT_EXACT_MATH)
+template <typename T>
+void gelu_exact(const T* src, T* dst, size_t count) {
+    const T sqrt_2_pi = static_cast<T>(0.7978845608028654);
+    for (size_t i = 0; i < count; ++i) {
+        const T x = src[i];
+        dst[i] = T(0.5) * x * (T(1) + std::tanh(sqrt_2_pi * (x + T(0.044715) * x * x * x)));
+    }
+}
+
+template <typename T>
+T exp_sum_exact(const T* src, T* dst, size_t count, T shift) {
+    T total = T(0);
+    for (size_t i = 0; i < count; ++i) {
+        dst[i] = std::exp(src[i] - shift);
+        total += dst[i];
+    }
+    return total;
+}
+
+} // namespace
+
+#if defined(VIT_EXACT_MATH)
+
+void exp(const float* src, float* dst, size_t count) {
+    std::transform(src, src + count, dst, [](float x) { return std::exp(x); });
+}
+
+void tanh(const float* src, float* dst, size_t count) {
+    std::transform(src, src + count, dst, [](float x) { return std::tanh(x); });
+}
+
+void erf(const float* src, float* dst, size_t count) {
+    std::transform(src, src + count, dst, [](float x) { return std::erf(x); });
+}
+
+float exp_sum(const float* src, float* dst, size_t count, float shift) {
+    return exp_sum_exact(src, dst, count, shift);
+}
+
+void gelu(const float* src, float* dst, size_t count) {
+    gelu_exact(src, dst, count);
+}
+
+#else
+
+void exp(const float* src, float* dst, size_t count) {
+    VIT_ISA_DISPATCH(exp(src, dst, count));
+}
+
+void tanh(const float* src, float* dst, size_t count) {
+    VIT_ISA_DISPATCH(tanh(src, dst, count));
+}
+
+void erf(const float* src, float* dst, size_t count) {
+    VIT_ISA_DISPATCH(erf(src, dst, count));
+}
+
+float exp_sum(const float* src, float* dst, size_t count, float shift) {
+    VIT_ISA_DISPATCH(exp_sum(src, dst, count, shift));
+}
+
+void gelu(const float* src, float* dst, size_t count) {
+    VIT_ISA_DISPATCH(gelu(src, dst, count));
+}
+
+#endif
+
+void exp(const double* src, double* dst, size_t count) {
+    std::transform(src, src + count, dst, [](double x) { return std::exp(x); });
+}
+
+void tanh(const double* src, double* dst, size_t count) {
+    std::transform(src, src + count, dst, [](double x) { return std::tanh(x); });
+}
+
+void erf(const double* src, double* dst, size_t count) {
+    std::transform(src, src + count, dst, [](double x) { return std::erf(x); });
+}
+
+double exp_sum(const double* src, double* dst, size_t count, double shift) {
+    return exp_sum_exact(src, dst, count, shift);
+}
+
+void gelu(const double* src, double* dst, size_t count) {
+    gelu_exact(src, dst, count);
+}
+
+const char* kernel_name() {
+#if defined(VIT_EXACT_MATH)
+    return "libm (exact)";
+#else
+    VIT_ISA_DISPATCH(name());
+#endif
+}
+
+} // namespace VectorMath
@@ -0,0 +1,294 @@
+// Polynomial float kernels (see vector_math.h) for one ISA level.
+// vector_math.cpp includes it once per level through isa_variants.inl, so
+// there is no include guard and every #if tests VIT_ISA_LEVEL.
+
+// ---------------------------------------------------------------------------
+// Lane operations. Every kernel below is written once against this interface
+// and instantiated for the widest vector ISA of this level and for plain
+// float (the scalar fallback and the loop tails).
+// ---------------------------------------------------------------------------
+
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+
+struct Avx512 {
+    using V = __m512;
+    using M = __mmask16;
+    static constexpr size_t WIDTH = 16;
+    static V load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, V v) { _mm512_storeu_ps(p, v); }
+    static V set1(float x) { return _mm512_set1_ps(x); }
+    static V add(V a, V b) { return _mm512_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm512_div_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+    static V min(V a, V b) { return _mm512_min_ps(a, b); }
+    static V max(V a, V b) { return _mm512_max_ps(a, b); }
+    static V abs(V a) { return _mm512_abs_ps(a); }
+    static V copysign(V magnitude, V sign) {
+        const __m512i mask = _mm512_set1_epi32(0x80000000);
+        return _mm512_castsi512_ps(_mm512_ternarylogic_epi32(
+            _mm512_castps_si512(sign), _mm512_castps_si512(magnitude), mask, 0xE4));
+    }
+    static V round(V a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    // 2^n for integer-valued n in [-126, 127]
+    static V pow2(V n) {
+        const __m512i bits = _mm512_slli_epi32(_mm512_add_epi32(_mm512_cvtps_epi32(n), _mm512_set1_epi32(127)), 23);
+        return _mm512_castsi512_ps(bits);
+    }
+    static M less(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static M is_nan(V a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+    static V select(M m, V a, V b) { return _mm512_mask_blend_ps(m, b, a); }
+    static float reduce_add(V a) { return _mm512_reduce_add_ps(a); }
+};
+
+using Wide = Avx512;
+
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+
+struct Avx2 {
+    using V = __m256;
+    using M = __m256;
+    static constexpr size_t WIDTH = 8;
+    static V load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+    static V set1(float x) { return _mm256_set1_ps(x); }
+    static V add(V a, V b) { return _mm256_add_ps(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+    static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+    static V div(V a, V b) { return _mm256_div_ps(a, b); }
+    static V fmadd(V a, V b, V c) { return _mm256_fmadd_ps(a, b, c); }
+    static V min(V a, V b) { return _mm256_min_ps(a, b); }
+    static V max(V a, V b) { return _mm256_max_ps(a, b); }
+    static V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static V copysign(V magnitude, V sign) {
+        const V sign_bit = _mm256_set1_ps(-0.0f);
+        return _mm256_or_ps(_mm256_andnot_ps(sign_bit, magnitude), _mm256_and_ps(sign_bit, sign));
+    }
+    static V round(V a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static V pow2(V n) {
+        const __m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+        return _mm256_castsi256_ps(bits);
+    }
+    static M less(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static M is_nan(V a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+    static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+    static float reduce_add(V a) {
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+        return _mm_cvtss_f32(sum);
+    }
+};
+
+using Wide = Avx2;
+
+#endif
+
+struct Lane {
+    using V = float;
+    using M = bool;
+    static constexpr size_t WIDTH = 1;
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V set1(float x) { return x; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+    static V div(V a, V b) { return a / b; }
+    static V fmadd(V a, V b, V c) { return a * b + c; }
+    // Same operand order as minps/maxps: a NaN first operand yields b
+    static V min(V a, V b) { return a < b ? a : b; }
+    static V max(V a, V b) { return a > b ? a : b; }
+    static V abs(V a) { return std::fabs(a); }
+    static V copysign(V magnitude, V sign) { return std::copysign(magnitude, sign); }
+    static V round(V a) { return std::nearbyint(a); }
+    static V pow2(V n) {
+        const uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23;
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    static M less(V a, V b) { return a < b; }
+    static M is_nan(V a) { return a != a; }
+    static V select(M m, V a, V b) { return m ? a : b; }
+    static float reduce_add(V a) { return a; }
+};
+
+// ---------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------
+
+// exp: x = n ln2 + r with |r| <= ln2/2 (ln2 split in two so n ln2 is exact),
+// exp(r) from a degree-7 polynomial, then scaled by 2^n. The scale is
+// applied as two halves so n may run from -150 to 128 without leaving the
+// exponent range: results overflow to Inf and underflow through the
+// subnormals to 0 exactly where expf does.
+template <typename S>
+inline typename S::V exp_kernel(typename S::V x) {
+    using V = typename S::V;
+    const V clamped = S::min(S::max(x, S::set1(-104.0f)), S::set1(89.0f));
+    const V n = S::round(S::mul(clamped, S::set1(1.44269504088896341f)));
+    V r = S::fmadd(n, S::set1(-0.693359375f), clamped);
+    r = S::fmadd(n, S::set1(2.12194440e-4f), r);
+
+    V p = S::set1(1.9875691500e-4f);
+    p = S::fmadd(p, r, S::set1(1.3981999507e-3f));
+    p = S::fmadd(p, r, S::set1(8.3334519073e-3f));
+    p = S::fmadd(p, r, S::set1(4.1665795894e-2f));
+    p = S::fmadd(p, r, S::set1(1.6666665459e-1f));
+    p = S::fmadd(p, r, S::set1(5.0000001201e-1f));
+    const V y = S::fmadd(S::mul(p, r), r, S::add(r, S::set1(1.0f)));
+
+    const V half_n = S::round(S::mul(n, S::set1(0.5f)));
+    const V result = S::mul(S::mul(y, S::pow2(half_n)), S::pow2(S::sub(n, half_n)));
+    return S::select(S::is_nan(x), x, result);
+}
+
+// tanh: odd polynomial near 0 (where 1 - 2 / (e^2x + 1) would cancel), the
+// exp identity elsewhere; |x| is capped at 9, where tanh rounds to 1
+template <typename S>
+inline typename S::V tanh_kernel(typename S::V x) {
+    using V = typename S::V;
+    const V a = S::abs(x);
+
+    const V z = S::mul(x, x);
+    V p = S::set1(-5.70498872745e-3f);
+    p = S::fmadd(p, z, S::set1(2.06390887954e-2f));
+    p = S::fmadd(p, z, S::set1(-5.37397155531e-2f));
+    p = S::fmadd(p, z, S::set1(1.33314422036e-1f));
+    p = S::fmadd(p, z, S::set1(-3.33332819422e-1f));
+    const V small = S::fmadd(S::mul(p, z), x, x);
+
+    const V e = exp_kernel<S>(S::mul(S::set1(2.0f), S::min(a, S::set1(9.0f))));
+    const V large = S::sub(S::set1(1.0f), S::div(S::set1(2.0f), S::add(e, S::set1(1.0f))));
+
+    const V result = S::select(S::less(a, S::set1(0.625f)), small, S::copysign(large, x));
+    return S::select(S::is_nan(x), x, result);
+}
+
+// erf: odd polynomial for |x| < 1; above, erf = 1 - erfc with
+// erfc(x) = exp(-x^2) / x * P(1 / x^2) on [1, 2) and [2, 4). |x| is capped
+// at 4, where erf rounds to 1.
+template <typename S>
+inline typename S::V erf_kernel(typename S::V x) {
+    using V = typename S::V;
+    const V a = S::min(S::abs(x), S::set1(4.0f));
+
+    const V z = S::mul(x, x);
+    V t = S::set1(7.853861353153693e-5f);
+    t = S::fmadd(t, z, S::set1(-8.010193625184903e-4f));
+    t = S::fmadd(t, z, S::set1(5.188327685732524e-3f));
+    t = S::fmadd(t, z, S::set1(-2.685381193529856e-2f));
+    t = S::fmadd(t, z, S::set1(1.128358514861418e-1f));
+    t = S::fmadd(t, z, S::set1(-3.761262582423300e-1f));
+    t = S::fmadd(t, z, S::set1(1.128379165726710e+0f));
+    const V small = S::mul(x, t);
+
+    const V q = S::div(S::set1(1.0f), a);
+    const V y = S::mul(q, q);
+    V p = S::set1(2.326819970068386e-2f);
+    p = S::fmadd(p, y, S::set1(-1.387039388740657e-1f));
+    p = S::fmadd(p, y, S::set1(3.687424674597105e-1f));
+    p = S::fmadd(p, y, S::set1(-5.824733027278666e-1f));
+    p = S::fmadd(p, y, S::set1(6.210004621745983e-1f));
+    p = S::fmadd(p, y, S::set1(-4.944515323274145e-1f));
+    p = S::fmadd(p, y, S::set1(3.404879937665872e-1f));
+    p = S::fmadd(p, y, S::set1(-2.741127028184656e-1f));
+    p = S::fmadd(p, y, S::set1(5.638259427386472e-1f));
+    V r = S::set1(-1.047766399936249e+1f);
+    r = S::fmadd(r, y, S::set1(1.297719955372516e+1f));
+    r = S::fmadd(r, y, S::set1(-7.495518717768503e+0f));
+    r = S::fmadd(r, y, S::set1(2.921019019210786e+0f));
+    r = S::fmadd(r, y, S::set1(-1.015265279202700e+0f));
+    r = S::fmadd(r, y, S::set1(4.218463358204948e-1f));
+    r = S::fmadd(r, y, S::set1(-2.820767439740514e-1f));
+    r = S::fmadd(r, y, S::set1(5.641895067754075e-1f));
+    const V tail = S::select(S::less(a, S::set1(2.0f)), p, r);
+    const V erfc = S::mul(S::mul(exp_kernel<S>(S::mul(a, S::mul(a, S::set1(-1.0f)))), q), tail);
+    const V large = S::copysign(S::sub(S::set1(1.0f), erfc), x);
+
+    const V result = S::select(S::less(S::abs(x), S::set1(1.0f)), small, large);
+    return S::select(S::is_nan(x), x, result);
+}
+
+// GELU as x / (1 + exp(-2u)), u = sqrt(2/pi) (x + 0.044715 x^3): equal to
+// 0.5 x (1 + tanh(u)), but 1 + tanh(u) would cancel for negative x
+template <typename S>
+inline typename S::V gelu_kernel(typename S::V x) {
+    using V = typename S::V;
+    const V x3 = S::mul(S::mul(x, x), x);
+    const V minus_2u = S::mul(S::set1(-1.5957691216057308f), S::fmadd(S::set1(0.044715f), x3, x));
+    return S::div(x, S::add(S::set1(1.0f), exp_kernel<S>(minus_2u)));
+}
+
+// Applies kernel over the array: full vectors first, then the tail lane by lane
+template <template <typename> class Kernel>
+void apply(const float* src, float* dst, size_t count) {
+    size_t i = 0;
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    for (; i + Wide::WIDTH <= count; i += Wide::WIDTH) {
+        Wide::store(dst + i, Kernel<Wide>::run(Wide::load(src + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = Kernel<Lane>::run(src[i]);
+    }
+}
+
+template <typename S> struct Exp { static typename S::V run(typename S::V x) { return exp_kernel<S>(x); } };
+template <typename S> struct Tanh { static typename S::V run(typename S::V x) { return tanh_kernel<S>(x); } };
+template <typename S> struct Erf { static typename S::V run(typename S::V x) { return erf_kernel<S>(x); } };
+template <typename S> struct Gelu { static typename S::V run(typename S::V x) { return gelu_kernel<S>(x); } };
+
+// ---------------------------------------------------------------------------
+// Entry points (the float functions of vector_math.h)
+// ---------------------------------------------------------------------------
+
+void exp(const float* src, float* dst, size_t count) {
+    apply<Exp>(src, dst, count);
+}
+
+void tanh(const float* src, float* dst, size_t count) {
+    apply<Tanh>(src, dst, count);
+}
+
+void erf(const float* src, float* dst, size_t count) {
+    apply<Erf>(src, dst, count);
+}
+
+float exp_sum(const float* src, float* dst, size_t count, float shift) {
+    size_t i = 0;
+    float total = 0.0f;
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    const Wide::V vshift = Wide::set1(shift);
+    Wide::V vtotal = Wide::set1(0.0f);
+    for (; i + Wide::WIDTH <= count; i += Wide::WIDTH) {
+        const Wide::V e = exp_kernel<Wide>(Wide::sub(Wide::load(src + i), vshift));
+        Wide::store(dst + i, e);
+        vtotal = Wide::add(vtotal, e);
+    }
+    total = Wide::reduce_add(vtotal);
+#endif
+    for (; i < count; ++i) {
+        dst[i] = exp_kernel<Lane>(src[i] - shift);
+        total += dst[i];
+    }
+    return total;
+}
+
+void gelu(const float* src, float* dst, size_t count) {
+    apply<Gelu>(src, dst, count);
+}
+
+const char* name() {
+#if VIT_ISA_LEVEL >= VIT_ISA_AVX512
+    return "avx512 polynomial";
+#elif VIT_ISA_LEVEL >= VIT_ISA_AVX2
+    return "avx2-fma polynomial";
+#elif VIT_ISA_LEVEL >= VIT_ISA_SSE42
+    return "sse4.2 polynomial";
+#else
+    return "scalar polynomial";
+#endif
+}
@@ -0,0 +1,85 @@
+#include "../../include/matrix/workspace.h"
+#include "../../include/matrix/memory.h"
+#include <algorithm>
+
+Workspace::Workspace(size_t initial_bytes) : current(0), offset(0), peak_bytes(0) {
+    if (initial_bytes > 0) {
+        add_block(initial_bytes);
+    }
+}
+
+Workspace::~Workspace() {
+    free_blocks();
+}
+
+void Workspace::add_block(size_t bytes) {
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    char* data = static_cast<char*>(Memory::allocate(bytes));
+    blocks.push_back({data, bytes});
+}
+
+void Workspace::free_blocks() {
+    for (const Block& block : blocks) {
+        Memory::deallocate(block.data, block.size);
+    }
+    blocks.clear();
+    current = 0;
+    offset = 0;
+}
+
+void* Workspace::allocate(size_t bytes) {
+    bytes = (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    if (bytes == 0) {
+        bytes = ALIGNMENT;
+    }
+
+    // Move on to a later (free) block, or append one, when this one is full
+    while (current >= blocks.size() || offset + bytes > blocks[current].size) {
+        if (current + 1 < blocks.size()) {
+            ++current;
+            offset = 0;
+            continue;
+        }
+        // Grow geometrically so warm-up needs only a few blocks
+        add_block(std::max(bytes, capacity()));
+        current = blocks.size() - 1;
+        offset = 0;
+    }
+
+    void* result = blocks[current].data + offset;
+    offset += bytes;
+    peak_bytes = std::max(peak_bytes, in_use());
+    return result;
+}
+
+void Workspace::release(Marker marker) {
+    current = marker.block;
+    offset = marker.offset;
+
+    // Fully released: merge the warm-up blocks into one of the peak size
+    if (current == 0 && offset == 0 && blocks.size() > 1) {
+        free_blocks();
+        add_block(peak_bytes);
+    }
+}
+
+size_t Workspace::capacity() const {
+    size_t total = 0;
+    for (const Block& block : blocks) {
+        total += block.size;
+    }
+    return total;
+}
+
+size_t Workspace::in_use() const {
+    size_t total = offset;
+    for (size_t i = 0; i < current && i < blocks.size(); ++i) {
+        total += blocks[i].size;
+    }
+    return total;
+}
+
+Workspace& Workspace::local() {
+    thread_local Workspace workspace;
+    return workspace;
+}
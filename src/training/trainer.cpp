@@ -14,7 +14,7 @@ SimpleClassifier::SimpleClassifier(size_t input_dim, size_t embed_dim, size_t nu
     classifier_bias = Matrix::zeros(1, num_classes);
 }
 
-Matrix SimpleClassifier::forward(const Matrix& input) {
+Matrix SimpleClassifier::forward(ConstMatrixView input) {
     // Project input to embedding dimension
     Matrix projected = MatrixOps::matmul(input, input_projection);
     Matrix transformer_output = transformer.forward(projected);
@@ -41,7 +41,7 @@ Matrix SimpleClassifier::forward(const Matrix& input) {
 double SimpleClassifier::compute_loss(const Matrix& predictions, const std::vector<int>& labels) {
     double loss = 0.0;
     for (size_t i = 0; i < labels.size(); ++i) {
-        loss -= std::log(std::max(predictions(i, labels[i]), 1e-15));
+        loss -= std::log(std::max<double>(predictions(i, labels[i]), 1e-15));
     }
     return loss / labels.size();
 }
@@ -62,7 +62,7 @@ double SimpleClassifier::compute_accuracy(const Matrix& predictions, const std::
     return static_cast<double>(correct) / test_labels.size();
 }
 
-void SimpleClassifier::train_step(const Matrix& batch_images, const std::vector<int>& batch_labels, double learning_rate) {
+void SimpleClassifier::train_step(ConstMatrixView batch_images, const std::vector<int>& batch_labels, double learning_rate) {
     Matrix predictions = forward(batch_images);
     
     // Compute gradients for classifier layer
@@ -118,16 +118,10 @@ void Trainer::train_model(SimpleClassifier& model,
             int start_idx = batch * batch_size;
             int end_idx = std::min(start_idx + batch_size, static_cast<int>(train_images.getRows()));
             
-            // Create batch
-            Matrix batch_images(end_idx - start_idx, train_images.getCols());
-            std::vector<int> batch_labels;
-            
-            for (int i = start_idx; i < end_idx; ++i) {
-                for (size_t j = 0; j < train_images.getCols(); ++j) {
-                    batch_images(i - start_idx, j) = train_images(i, j);
-                }
-                batch_labels.push_back(train_labels[i]);
-            }
+            // Create batch (zero-copy row range of the training set)
+            ConstMatrixView batch_images = train_images.row_range(start_idx, end_idx - start_idx);
+            std::vector<int> batch_labels(train_labels.begin() + start_idx,
+                                          train_labels.begin() + end_idx);
             
             // Forward pass and loss
             Matrix predictions = model.forward(batch_images);
@@ -141,15 +135,9 @@ void Trainer::train_model(SimpleClassifier& model,
         }
         
         // Test accuracy
-        Matrix test_batch(std::min(100, static_cast<int>(test_images.getRows())), test_images.getCols());
-        std::vector<int> test_batch_labels;
-        
-        for (int i = 0; i < std::min(100, static_cast<int>(test_images.getRows())); ++i) {
-            for (size_t j = 0; j < test_images.getCols(); ++j) {
-                test_batch(i, j) = test_images(i, j);
-            }
-            test_batch_labels.push_back(test_labels[i]);
-        }
+        int test_count = std::min(100, static_cast<int>(test_images.getRows()));
+        ConstMatrixView test_batch = test_images.row_range(0, test_count);
+        std::vector<int> test_batch_labels(test_labels.begin(), test_labels.begin() + test_count);
         
         Matrix test_predictions = model.forward(test_batch);
         double accuracy = model.compute_accuracy(test_predictions, test_batch_labels);
@@ -2,6 +2,7 @@
 #include "../../include/transformer/layer_norm.h"
 #include "../../include/matrix/activation_functions.h"
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/quantized.h"
 #include "../../include/utils/file_io.h"
 #include <iostream>
 #include <stdexcept>
@@ -24,13 +25,24 @@ void LayerNorm::initialize(int features, double eps) {
 }
 
 Matrix LayerNorm::forward(const Matrix& input) {
+    Matrix output;
+    forward(input, output);
+    return output;
+}
+
+void LayerNorm::forward(ConstMatrixView input, Matrix& output) {
+    output.resize_uninitialized(input.getRows(), input.getCols());
+    forward(input, output.view());
+}
+
+void LayerNorm::forward(ConstMatrixView input, MatrixView output) {
     if (input.getCols() != features) {
         throw std::runtime_error("LayerNorm input feature dimension mismatch. Expected: " + 
                                 std::to_string(features) + ", Got: " + std::to_string(input.getCols()));
     }
     
     // Use the existing layerNorm function from activation_functions
-    return ActivationFunctions::layerNorm(input, gamma, beta, epsilon, 1);
+    ActivationFunctions::layerNorm_into(output, input, gamma, beta, epsilon, 1);
 }
 
 void LayerNorm::load_weights(const std::string& base_path, int layer_idx, const std::string& norm_type) {
@@ -55,11 +67,11 @@ void LayerNorm::load_weights(const std::string& base_path, int layer_idx, const
         
         // Ensure they are row vectors
         if (weight_matrix.getRows() > 1) {
-            // If loaded as column vector, transpose
-            weight_matrix = MatrixOps::transpose(weight_matrix);
+            // If loaded as column vector, reinterpret the same storage as a row
+            weight_matrix.reshape(1, weight_matrix.size());
         }
         if (bias_matrix.getRows() > 1) {
-            bias_matrix = MatrixOps::transpose(bias_matrix);
+            bias_matrix.reshape(1, bias_matrix.size());
         }
         
         // Set the dimensions
@@ -74,4 +86,14 @@ void LayerNorm::load_weights(const std::string& base_path, int layer_idx, const
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to load LayerNorm weights: " + std::string(e.what()));
     }
-}
\ No newline at end of file
+}
+
+void LayerNorm::write(std::ostream& os) const {
+    Quantization::write_matrix(os, ConstMatrixView(gamma));
+    Quantization::write_matrix(os, ConstMatrixView(beta));
+}
+
+void LayerNorm::read(std::istream& is) {
+    Quantization::read_matrix(is, gamma.view());
+    Quantization::read_matrix(is, beta.view());
+}
@@ -1,4 +1,5 @@
 #include "../../include/transformer/loss_functions.h"
+#include "../../include/matrix/activation_functions.h"
 #include <cmath>
 #include <algorithm>
 
@@ -8,7 +9,7 @@ double LossFunctions::cross_entropy_loss(const Matrix& logits, const std::vector
     
     for (int i = 0; i < logits.getRows(); i++) {
         int true_label = labels[i];
-        double prob = std::max(probs(i, true_label), 1e-15); // Avoid log(0)
+        double prob = std::max<double>(probs(i, true_label), 1e-15); // Avoid log(0)
         total_loss -= log(prob);
     }
     
@@ -16,29 +17,9 @@ double LossFunctions::cross_entropy_loss(const Matrix& logits, const std::vector
 }
 
 Matrix LossFunctions::softmax(const Matrix& logits) {
+    // Same row-wise kernel as the attention softmax (SIMD exp, fused sum)
     Matrix result(logits.getRows(), logits.getCols());
-    
-    for (int i = 0; i < logits.getRows(); i++) {
-        // Find max for numerical stability
-        double max_val = logits(i, 0);
-        for (int j = 1; j < logits.getCols(); j++) {
-            max_val = std::max(max_val, logits(i, j));
-        }
-        
-        // Compute exp and sum
-        double sum_exp = 0.0;
-        for (int j = 0; j < logits.getCols(); j++) {
-            double exp_val = exp(logits(i, j) - max_val);
-            result(i, j) = exp_val;
-            sum_exp += exp_val;
-        }
-        
-        // Normalize
-        for (int j = 0; j < logits.getCols(); j++) {
-            result(i, j) /= sum_exp;
-        }
-    }
-    
+    ActivationFunctions::softmax_into(result, logits, 1);
     return result;
 }
 
@@ -60,19 +41,19 @@ Matrix LossFunctions::cross_entropy_gradient(const Matrix& logits, const std::ve
     Matrix grad(logits.getRows(), logits.getCols());
     
     for (int i = 0; i < logits.getRows(); i++) {
+        const Scalar* prob_row = probs.row_ptr(i);
+        Scalar* grad_row = grad.row_ptr(i);
         for (int j = 0; j < logits.getCols(); j++) {
-            grad(i, j) = probs(i, j);
-            if (j == labels[i]) {
-                grad(i, j) -= 1.0;
-            }
+            grad_row[j] = prob_row[j];
         }
+        grad_row[labels[i]] -= 1.0;
     }
     
     // Average over batch
-    for (int i = 0; i < grad.getRows(); i++) {
-        for (int j = 0; j < grad.getCols(); j++) {
-            grad(i, j) /= logits.getRows();
-        }
+    Scalar* g = grad.data();
+    Scalar inv_batch = 1.0 / logits.getRows();
+    for (size_t i = 0; i < grad.size(); i++) {
+        g[i] *= inv_batch;
     }
     
     return grad;
@@ -1,14 +1,14 @@
 #include "../../include/transformer/mlp.h"
 #include "../../include/matrix/matrix_ops.h"
-#include "../../include/matrix/activation_functions.h"
 #include <cmath>
+#include <stdexcept>
 
 /*
-g++ -std=c++17 -I. test_code/03_test_mlp.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/activation_functions.h.cpp src/transformer/mlp.cpp -o test_mlp && ./test_mlp
+g++ -std=c++17 -I. test_code/03_test_mlp.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/workspace.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp src/matrix/activation_functions.h.cpp src/transformer/mlp.cpp -o test_mlp && ./test_mlp
  */
 
 MLP::MLP(size_t input_dim, size_t hidden_dim) 
-    : input_dim(input_dim), hidden_dim(hidden_dim) {
+    : input_dim(input_dim), hidden_dim(hidden_dim), weight_storage(StorageType::Float32) {
     initialize_weights();
 }
 
@@ -22,31 +22,131 @@ void MLP::initialize_weights() {
     
     W2 = Matrix::random(hidden_dim, input_dim) * scale2;
     b2 = Matrix::zeros(1, input_dim);
+    W1_sparse.clear();
+    W2_sparse.clear();
+    set_weight_storage(weight_storage);
 }
 
-Matrix MLP::forward(const Matrix& input) {
-    // First linear layer: input -> hidden
-    Matrix hidden = MatrixOps::matmul(input, W1);
+void MLP::set_weight_storage(StorageType type) {
+    weight_storage = type;
+    W1_half.clear();
+    W2_half.clear();
+    W1_int8.clear();
+    W2_int8.clear();
+    if (type == StorageType::Float32) {
+        return;
+    }
     
-    // Add bias (broadcast)
-    for (size_t i = 0; i < hidden.getRows(); ++i) {
-        for (size_t j = 0; j < hidden.getCols(); ++j) {
-            hidden(i, j) += b1(0, j);
-        }
+    if (type == StorageType::Int8) {
+        W1_int8.assign(ConstMatrixView(W1), false, input_range.scale());
+        W2_int8.assign(ConstMatrixView(W2), false, hidden_range.scale());
+        return;
     }
     
-    // GELU activation
-    hidden = ActivationFunctions::gelu(hidden);
+    W1_half.assign(W1, type);
+    W2_half.assign(W2, type);
+}
+
+void MLP::set_calibration(bool recording) {
+    if (recording) {
+        input_range.start();
+        hidden_range.start();
+    } else {
+        input_range.stop();
+        hidden_range.stop();
+    }
+}
+
+void MLP::set_sparse(bool enabled) {
+    W1_sparse.clear();
+    W2_sparse.clear();
+    if (!enabled) {
+        return;
+    }
     
-    // Second linear layer: hidden -> output
-    Matrix output = MatrixOps::matmul(hidden, W2);
+    Sparsity::prune_2_4(W1.view());
+    Sparsity::prune_2_4(W2.view());
+    W1_sparse.assign(ConstMatrixView(W1));
+    W2_sparse.assign(ConstMatrixView(W2));
+    // Rebuild the 16-bit or int8 copies from the pruned weights
+    set_weight_storage(weight_storage);
+}
+
+void MLP::write(std::ostream& os) const {
+    if (weight_storage != StorageType::Int8) {
+        throw std::logic_error("Only int8 weights are written");
+    }
+    W1_int8.write(os);
+    Quantization::write_matrix(os, ConstMatrixView(b1));
+    W2_int8.write(os);
+    Quantization::write_matrix(os, ConstMatrixView(b2));
+}
+
+void MLP::read(std::istream& is) {
+    W1_int8.read(is);
+    Quantization::read_matrix(is, b1.view());
+    W2_int8.read(is);
+    Quantization::read_matrix(is, b2.view());
+    if (W1_int8.in_features() != input_dim || W1_int8.out_features() != hidden_dim || W1_int8.is_transposed() ||
+        W2_int8.in_features() != hidden_dim || W2_int8.out_features() != input_dim || W2_int8.is_transposed()) {
+        throw std::runtime_error("Stored MLP weights do not match the layer dimensions");
+    }
+    W1_int8.to_matrix(W1.view());
+    W2_int8.to_matrix(W2.view());
+    weight_storage = StorageType::Int8;
+    W1_half.clear();
+    W2_half.clear();
+    W1_sparse.clear();
+    W2_sparse.clear();
+    // Re-quantizing the dequantized weights reproduces these scales
+    input_range.max_abs = W1_int8.input_scale() * 127.0f;
+    hidden_range.max_abs = W2_int8.input_scale() * 127.0f;
+}
+
+Matrix MLP::forward(const Matrix& input) {
+    Matrix output;
+    forward(input, output);
+    return output;
+}
+
+void MLP::forward(ConstMatrixView input, Matrix& output) {
+    output.resize_uninitialized(input.getRows(), input_dim);
+    forward(input, output.view(), Workspace::local());
+}
+
+void MLP::forward(ConstMatrixView input, MatrixView output, Workspace& workspace, ConstMatrixView residual) {
+    Workspace::Scope scope(workspace);
     
-    // Add bias (broadcast)
-    for (size_t i = 0; i < output.getRows(); ++i) {
-        for (size_t j = 0; j < output.getCols(); ++j) {
-            output(i, j) += b2(0, j);
-        }
+    // First linear layer: input -> hidden, with the bias and GELU applied as
+    // the GEMM writes each tile (a separate pass after the int8/sparse kernels)
+    MatrixView hidden = workspace.matrix<Scalar>(input.getRows(), hidden_dim);
+    const Gemm::Epilogue<Scalar> hidden_epilogue = MatrixOps::make_epilogue(ConstMatrixView(b1), Gemm::Activation::Gelu);
+    input_range.observe(input);
+    if (!W1_int8.empty()) {
+        W1_int8.multiply(input, hidden);
+        MatrixOps::apply_epilogue(hidden, hidden_epilogue);
+    } else if (!W1_half.empty()) {
+        MatrixOps::gemm(1.0, input, false, W1_half, false, 0.0, hidden, hidden_epilogue);
+    } else if (!W1_sparse.empty()) {
+        W1_sparse.multiply(input, hidden);
+        MatrixOps::apply_epilogue(hidden, hidden_epilogue);
+    } else {
+        MatrixOps::gemm(1.0, input, false, W1, false, 0.0, hidden, hidden_epilogue);
     }
     
-    return output;
+    // Second linear layer: hidden -> output, plus bias and residual
+    const Gemm::Epilogue<Scalar> output_epilogue =
+        MatrixOps::make_epilogue(ConstMatrixView(b2), Gemm::Activation::None, residual);
+    hidden_range.observe(ConstMatrixView(hidden));
+    if (!W2_int8.empty()) {
+        W2_int8.multiply(ConstMatrixView(hidden), output);
+        MatrixOps::apply_epilogue(output, output_epilogue);
+    } else if (!W2_half.empty()) {
+        MatrixOps::gemm(1.0, hidden, false, W2_half, false, 0.0, output, output_epilogue);
+    } else if (!W2_sparse.empty()) {
+        W2_sparse.multiply(ConstMatrixView(hidden), output);
+        MatrixOps::apply_epilogue(output, output_epilogue);
+    } else {
+        MatrixOps::gemm(1.0, hidden, false, W2, false, 0.0, output, output_epilogue);
+    }
 }
\ No newline at end of file
@@ -1,61 +1,134 @@
 #include "../../include/transformer/patch_embedding.h"
 #include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/thread_pool.h"
 #include <cmath>
+#include <algorithm>
+#include <stdexcept>
 
 PatchEmbedding::PatchEmbedding(int patch_size, int embed_dim) 
     : patch_size(patch_size), embed_dim(embed_dim) {
     int patch_dim = patch_size * patch_size;
-    projection_weight = Matrix(embed_dim, patch_dim);
-    projection_bias = Matrix(embed_dim, 1);
-    
     // Xavier initialization
     double std = sqrt(2.0 / (patch_dim + embed_dim));
-    for (int i = 0; i < embed_dim; i++) {
-        for (int j = 0; j < patch_dim; j++) {
-            projection_weight(i, j) = ((double)rand() / RAND_MAX - 0.5) * 2 * std;
-        }
-        projection_bias(i, 0) = 0.0;
-    }
+    projection_weight = Matrix::random(embed_dim, patch_dim, -std, std);
+    projection_bias = Matrix(embed_dim, 1);
 }
 
 Matrix PatchEmbedding::forward(const Matrix& images) {
+    Matrix embeddings;
+    forward(images, embeddings);
+    return embeddings;
+}
+
+void PatchEmbedding::forward(const Matrix& images, Matrix& embeddings) {
     int batch_size = images.getRows();
     int img_size = (int)sqrt(images.getCols());
     int num_patches = get_num_patches(img_size);
     
-    Matrix patches(batch_size * num_patches, patch_size * patch_size);
-    
-    // Extract patches
-    int patch_idx = 0;
-    for (int b = 0; b < batch_size; b++) {
-        for (int i = 0; i < img_size; i += patch_size) {
-            for (int j = 0; j < img_size; j += patch_size) {
-                for (int pi = 0; pi < patch_size; pi++) {
-                    for (int pj = 0; pj < patch_size; pj++) {
-                        int img_row = i + pi;
-                        int img_col = j + pj;
-                        if (img_row < img_size && img_col < img_size) {
-                            patches(patch_idx, pi * patch_size + pj) = 
-                                images(b, img_row * img_size + img_col);
-                        }
-                    }
-                }
-                patch_idx++;
-            }
+    // Images are independent, so the batch is split across the thread pool
+    patches.resize_uninitialized(batch_size * num_patches, patch_size * patch_size);
+    parallel_for_rows(batch_size, images.getCols(), 1 << 15, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; b++) {
+            extract_patches(images.row_ptr(b), img_size, patches.view().row_range(b * num_patches, num_patches));
         }
+    });
+    project(embeddings);
+}
+
+void PatchEmbedding::forward(const std::vector<Matrix>& images, Matrix& embeddings) {
+    // Patches of image b start at row first_patch[b]
+    first_patch.resize(images.size() + 1);
+    first_patch[0] = 0;
+    for (size_t b = 0; b < images.size(); b++) {
+        first_patch[b + 1] = first_patch[b] + get_num_patches(image_side(images[b]));
     }
     
-    // Project patches to embedding dimension
-    Matrix embeddings = MatrixOps::matmul(patches, MatrixOps::transpose(projection_weight));
-    
-    // Add bias
-    for (int i = 0; i < embeddings.getRows(); i++) {
-        for (int j = 0; j < embeddings.getCols(); j++) {
-            embeddings(i, j) += projection_bias(j, 0);
+    patches.resize_uninitialized(first_patch.back(), patch_size * patch_size);
+    parallel_for(images.size(), 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; b++) {
+            extract_patches(images[b].data(), image_side(images[b]),
+                            patches.view().row_range(first_patch[b], first_patch[b + 1] - first_patch[b]));
         }
+    });
+    project(embeddings);
+}
+
+int PatchEmbedding::image_side(const Matrix& image) {
+    int side = (int)std::lround(std::sqrt(double(image.size())));
+    if (size_t(side) * side != image.size()) {
+        throw std::invalid_argument("Images must be square");
     }
-    
-    return embeddings;
+    return side;
+}
+
+void PatchEmbedding::extract_patches(const Scalar* image, int img_size, MatrixView dst) const {
+    // One contiguous patch row segment at a time, full patches only (the
+    // grid get_num_patches counts)
+    int grid = img_size / patch_size;
+    for (int i = 0; i < grid; i++) {
+        for (int j = 0; j < grid; j++) {
+            Scalar* patch = dst.row_ptr(i * grid + j);
+            for (int pi = 0; pi < patch_size; pi++) {
+                const Scalar* src = image + (i * patch_size + pi) * img_size + j * patch_size;
+                std::copy(src, src + patch_size, patch + pi * patch_size);
+            }
+        }
+    }
+}
+
+void PatchEmbedding::project(Matrix& embeddings) {
+    // Project patches to embedding dimension (projection_weight is [embed_dim, patch_dim]),
+    // adding the bias (stored as a column vector, so it is contiguous) in the GEMM epilogue
+    embeddings.resize_uninitialized(patches.getRows(), embed_dim);
+    patch_range.observe(ConstMatrixView(patches));
+    const Gemm::Epilogue<Scalar> epilogue = MatrixOps::make_epilogue(ConstMatrixView(projection_bias.data(), 1, embed_dim));
+    if (!projection_weight_int8.empty()) {
+        projection_weight_int8.multiply(ConstMatrixView(patches), embeddings);
+        MatrixOps::apply_epilogue(embeddings.view(), epilogue);
+    } else if (!projection_weight_half.empty()) {
+        MatrixOps::gemm(1.0, patches, false, projection_weight_half, true, 0.0, embeddings, epilogue);
+    } else {
+        MatrixOps::gemm(1.0, patches, false, projection_weight, true, 0.0, embeddings, epilogue);
+    }
+}
+
+void PatchEmbedding::set_weight_storage(StorageType type) {
+    projection_weight_half.clear();
+    projection_weight_int8.clear();
+    if (type == StorageType::Int8) {
+        projection_weight_int8.assign(ConstMatrixView(projection_weight), true, patch_range.scale());
+    } else if (type != StorageType::Float32) {
+        projection_weight_half.assign(projection_weight, type);
+    }
+}
+
+void PatchEmbedding::set_calibration(bool recording) {
+    if (recording) {
+        patch_range.start();
+    } else {
+        patch_range.stop();
+    }
+}
+
+void PatchEmbedding::write(std::ostream& os) const {
+    if (projection_weight_int8.empty()) {
+        throw std::logic_error("Only int8 weights are written");
+    }
+    projection_weight_int8.write(os);
+    Quantization::write_matrix(os, ConstMatrixView(projection_bias));
+}
+
+void PatchEmbedding::read(std::istream& is) {
+    projection_weight_int8.read(is);
+    Quantization::read_matrix(is, projection_bias.view());
+    if (projection_weight_int8.out_features() != projection_weight.getRows() ||
+        projection_weight_int8.in_features() != projection_weight.getCols() ||
+        !projection_weight_int8.is_transposed()) {
+        throw std::runtime_error("Stored patch projection does not match the layer dimensions");
+    }
+    projection_weight_int8.to_matrix(projection_weight.view());
+    projection_weight_half.clear();
+    patch_range.max_abs = projection_weight_int8.input_scale() * 127.0f;
 }
 
 int PatchEmbedding::get_num_patches(int img_size) const {
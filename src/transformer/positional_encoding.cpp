@@ -1,29 +1,54 @@
 #include "../../include/transformer/positional_encoding.h"
+#include "../../include/matrix/quantized.h"
 #include <cmath>
+#include <stdexcept>
 
 PositionalEncoding::PositionalEncoding(int max_seq_len, int embed_dim) 
     : max_seq_len(max_seq_len), embed_dim(embed_dim) {
-    pos_embedding = Matrix(max_seq_len, embed_dim);
-    
     // Learnable positional embeddings (random initialization)
     double std = 0.02;
-    for (int i = 0; i < max_seq_len; i++) {
-        for (int j = 0; j < embed_dim; j++) {
-            pos_embedding(i, j) = ((double)rand() / RAND_MAX - 0.5) * 2 * std;
-        }
-    }
+    pos_embedding = Matrix::random(max_seq_len, embed_dim, -std, std);
 }
 
 Matrix PositionalEncoding::forward(const Matrix& x) {
     Matrix result = x;
+    forward_inplace(result);
+    return result;
+}
+
+void PositionalEncoding::forward_inplace(MatrixView x) const {
     int seq_len = x.getRows();
     
     // Add positional embeddings
     for (int i = 0; i < seq_len && i < max_seq_len; i++) {
+        Scalar* row = x.row_ptr(i);
+        const Scalar* pos = pos_embedding.row_ptr(i);
         for (int j = 0; j < x.getCols(); j++) {
-            result(i, j) += pos_embedding(i, j);
+            row[j] += pos[j];
         }
     }
+}
+
+void PositionalEncoding::forward_inplace(MatrixView x, int grid, int full_grid) const {
+    if (grid > full_grid || 1 + full_grid * full_grid > max_seq_len || x.getRows() != size_t(1 + grid * grid)) {
+        throw std::invalid_argument("Patch grid does not fit the positional embeddings");
+    }
     
-    return result;
-}
\ No newline at end of file
+    // CLS keeps embedding 0; patch (r, c) takes the one of (r, c) on the full grid
+    for (int i = 0; i < 1 + grid * grid; i++) {
+        int position = i == 0 ? 0 : 1 + ((i - 1) / grid) * full_grid + (i - 1) % grid;
+        Scalar* row = x.row_ptr(i);
+        const Scalar* pos = pos_embedding.row_ptr(position);
+        for (int j = 0; j < x.getCols(); j++) {
+            row[j] += pos[j];
+        }
+    }
+}
+
+void PositionalEncoding::write(std::ostream& os) const {
+    Quantization::write_matrix(os, ConstMatrixView(pos_embedding));
+}
+
+void PositionalEncoding::read(std::istream& is) {
+    Quantization::read_matrix(is, pos_embedding.view());
+}
@@ -0,0 +1,127 @@
+#include "../../include/transformer/token_merging.h"
+#include "../../include/matrix/matrix_ops.h"
+#include "../../include/matrix/reduction.h"
+#include "../../include/matrix/thread_pool.h"
+#include "../../include/matrix/workspace.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace TokenMerging {
+
+size_t merged_length(size_t length, size_t r) {
+    return length - std::min(r, length == 0 ? 0 : (length - 1) / 2);
+}
+
+void merge(ConstPackedBatchView tokens, ConstMatrixView keys, const Scalar* sizes, size_t r,
+           PackedBatchView merged, Scalar* merged_sizes) {
+    const size_t key_dim = keys.getCols();
+    const size_t cols = tokens.getCols();
+    if (merged.getBatch() != tokens.getBatch() || merged.getCols() != cols ||
+        keys.getRows() != tokens.total_rows()) {
+        throw std::invalid_argument("Token merging buffers do not match the tokens");
+    }
+    for (size_t b = 0; b < tokens.getBatch(); ++b) {
+        if (merged.length(b) != merged_length(tokens.length(b), r)) {
+            throw std::invalid_argument("Merged sequence length does not match merged_length(length, r)");
+        }
+    }
+
+    parallel_for(tokens.getBatch(), 1, [&](size_t first, size_t last) {
+        Workspace& local = Workspace::local();
+        for (size_t b = first; b < last; ++b) {
+            Workspace::Scope scope(local);
+            const size_t n = tokens.length(b);
+            const size_t row = tokens.offset(b);
+            const size_t count = n - merged.length(b);
+            ConstMatrixView x = tokens[b];
+            MatrixView out = merged[b];
+            const Scalar* size = sizes + row;
+            Scalar* out_size = merged_sizes + merged.offset(b);
+            if (count == 0) {
+                MatrixOps::copy(out, x);
+                std::copy(size, size + n, out_size);
+                continue;
+            }
+
+            // Unit-length keys of the A (even) and B (odd) tokens, so one GEMM
+            // gives every A x B cosine similarity
+            const size_t num_a = (n + 1) / 2, num_b = n / 2;
+            MatrixView a_keys = local.matrix<Scalar>(num_a, key_dim);
+            MatrixView b_keys = local.matrix<Scalar>(num_b, key_dim);
+            for (size_t i = 0; i < n; ++i) {
+                const Scalar* k = keys.row_ptr(row + i);
+                Scalar* dst = i % 2 == 0 ? a_keys.row_ptr(i / 2) : b_keys.row_ptr(i / 2);
+                Scalar norm = 0;
+                for (size_t j = 0; j < key_dim; ++j) {
+                    norm += k[j] * k[j];
+                }
+                const Scalar inv_norm = Scalar(1) / std::max(std::sqrt(norm), Scalar(1e-6));
+                for (size_t j = 0; j < key_dim; ++j) {
+                    dst[j] = k[j] * inv_norm;
+                }
+            }
+            MatrixView similarity = local.matrix<Scalar>(num_a, num_b);
+            MatrixOps::gemm(1.0, ConstMatrixView(a_keys), false, ConstMatrixView(b_keys), true, 0.0, similarity);
+
+            // Each A token's best B partner; the count most similar A tokens
+            // (CLS, A token 0, excluded) merge, ties to the earlier token
+            size_t* partner = static_cast<size_t*>(local.allocate(num_a * sizeof(size_t)));
+            Scalar* best = static_cast<Scalar*>(local.allocate(num_a * sizeof(Scalar)));
+            size_t* order = static_cast<size_t*>(local.allocate(num_a * sizeof(size_t)));
+            bool* is_merged = static_cast<bool*>(local.allocate(num_a * sizeof(bool)));
+            for (size_t a = 0; a < num_a; ++a) {
+                partner[a] = Reduction::argmax(similarity.row_ptr(a), num_b);
+                best[a] = similarity(a, partner[a]);
+                order[a] = a;
+                is_merged[a] = false;
+            }
+            std::partial_sort(order + 1, order + 1 + count, order + num_a, [&](size_t i, size_t j) {
+                return best[i] > best[j] || (best[i] == best[j] && i < j);
+            });
+
+            // B tokens after the kept A tokens, as size-weighted sums of
+            // themselves and the A tokens merged into them, then averaged
+            const size_t kept = num_a - count;
+            for (size_t j = 0; j < num_b; ++j) {
+                const Scalar s = size[2 * j + 1];
+                const Scalar* src = x.row_ptr(2 * j + 1);
+                Scalar* dst = out.row_ptr(kept + j);
+                for (size_t c = 0; c < cols; ++c) {
+                    dst[c] = s * src[c];
+                }
+                out_size[kept + j] = s;
+            }
+            for (size_t t = 1; t <= count; ++t) {
+                const size_t a = order[t];
+                const Scalar s = size[2 * a];
+                const Scalar* src = x.row_ptr(2 * a);
+                Scalar* dst = out.row_ptr(kept + partner[a]);
+                for (size_t c = 0; c < cols; ++c) {
+                    dst[c] += s * src[c];
+                }
+                out_size[kept + partner[a]] += s;
+                is_merged[a] = true;
+            }
+            for (size_t j = 0; j < num_b; ++j) {
+                const Scalar inv_size = Scalar(1) / out_size[kept + j];
+                Scalar* dst = out.row_ptr(kept + j);
+                for (size_t c = 0; c < cols; ++c) {
+                    dst[c] *= inv_size;
+                }
+            }
+
+            // Kept A tokens in their original order, CLS first
+            size_t next = 0;
+            for (size_t a = 0; a < num_a; ++a) {
+                if (!is_merged[a]) {
+                    std::memcpy(out.row_ptr(next), x.row_ptr(2 * a), cols * sizeof(Scalar));
+                    out_size[next++] = size[2 * a];
+                }
+            }
+        }
+    });
+}
+
+} // namespace TokenMerging
@@ -6,19 +6,96 @@ TransformerBlock::TransformerBlock(size_t embed_dim, size_t num_heads, size_t ml
 }
 
 Matrix TransformerBlock::forward(const Matrix& input) {
-    // First residual block: LayerNorm -> Attention -> Add
-    Matrix normed1 = norm1.forward(input);
-    Matrix attn_out = attention.forward(normed1);
-    
-    // Residual connection
-    Matrix residual1 = MatrixOps::add(input, attn_out);
-    
-    // Second residual block: LayerNorm -> MLP -> Add  
-    Matrix normed2 = norm2.forward(residual1);
-    Matrix mlp_out = mlp.forward(normed2);
+    Matrix output;
+    forward(input, output);
+    return output;
+}
+
+void TransformerBlock::forward(ConstMatrixView input, Matrix& output) {
+    output.resize_uninitialized(input.getRows(), input.getCols());
+    forward(input, output.view(), Workspace::local());
+}
+
+void TransformerBlock::forward(ConstMatrixView input, MatrixView output, Workspace& workspace) {
+    forward(ConstTensor3View(input, input.getRows()), Tensor3View(output, output.getRows()), workspace);
+}
+
+void TransformerBlock::forward(ConstTensor3View input, Tensor3View output, Workspace& workspace) {
+    Workspace::Scope scope(workspace);
+    size_t* offsets = static_cast<size_t*>(workspace.allocate((input.getBatch() + 1) * sizeof(size_t)));
+    ConstPackedBatchView packed(input, offsets);
+    forward(packed, PackedBatchView(output.flat(), offsets, input.getBatch()), workspace);
+}
+
+void TransformerBlock::forward(ConstPackedBatchView input, PackedBatchView output, Workspace& workspace,
+                               const Scalar* key_bias, MatrixView keys) {
+    Workspace::Scope scope(workspace);
+    ConstMatrixView tokens = input.flat();
+    MatrixView normed_tokens = workspace.matrix<Scalar>(tokens.getRows(), tokens.getCols());
+    MatrixView residual_tokens = workspace.matrix<Scalar>(tokens.getRows(), tokens.getCols());
+    PackedBatchView normed(normed_tokens, input.offsets(), input.getBatch());
+    PackedBatchView residual(residual_tokens, input.offsets(), input.getBatch());
     
-    // Residual connection
-    Matrix output = MatrixOps::add(residual1, mlp_out);
+    // First residual block: LayerNorm -> Attention -> Add, the input added by
+    // the output projection's GEMM epilogue
+    norm1.forward(tokens, normed.flat());
+    attention.forward(normed, residual, workspace, tokens, key_bias, keys);
     
-    return output;
-}
\ No newline at end of file
+    // Second residual block: LayerNorm -> MLP -> Add, likewise in the second
+    // MLP GEMM
+    norm2.forward(residual.flat(), normed.flat());
+    mlp.forward(normed.flat(), output.flat(), workspace, residual.flat());
+}
+
+void TransformerBlock::forward(const HalfMatrix& input, HalfMatrix& output, Workspace& workspace) {
+    forward(input, input.getRows(), output, workspace);
+}
+
+void TransformerBlock::forward(const HalfMatrix& input, size_t seq_len, HalfMatrix& output, Workspace& workspace) {
+    Workspace::Scope scope(workspace);
+    size_t batch = seq_len == 0 ? 0 : input.getRows() / seq_len;
+    size_t* offsets = static_cast<size_t*>(workspace.allocate((batch + 1) * sizeof(size_t)));
+    for (size_t b = 0; b <= batch; ++b) {
+        offsets[b] = b * seq_len;
+    }
+    forward(input, offsets, batch, output, workspace);
+}
+
+void TransformerBlock::forward(const HalfMatrix& input, const size_t* offsets, size_t batch, HalfMatrix& output,
+                               Workspace& workspace, const Scalar* key_bias, MatrixView keys) {
+    Workspace::Scope scope(workspace);
+    MatrixView widened = workspace.matrix<Scalar>(input.getRows(), input.getCols());
+    MatrixView block_out = workspace.matrix<Scalar>(input.getRows(), input.getCols());
+    input.to_matrix(widened);
+    forward(ConstPackedBatchView(widened, offsets, batch), PackedBatchView(block_out, offsets, batch), workspace,
+            key_bias, keys);
+    output.assign(ConstMatrixView(block_out), input.getType());
+}
+
+void TransformerBlock::set_weight_storage(StorageType type) {
+    attention.set_weight_storage(type);
+    mlp.set_weight_storage(type);
+}
+
+void TransformerBlock::set_calibration(bool recording) {
+    attention.set_calibration(recording);
+    mlp.set_calibration(recording);
+}
+
+void TransformerBlock::set_sparse_mlp(bool enabled) {
+    mlp.set_sparse(enabled);
+}
+
+void TransformerBlock::write(std::ostream& os) const {
+    norm1.write(os);
+    attention.write(os);
+    norm2.write(os);
+    mlp.write(os);
+}
+
+void TransformerBlock::read(std::istream& is) {
+    norm1.read(is);
+    attention.read(is);
+    norm2.read(is);
+    mlp.read(is);
+}
@@ -1,16 +1,33 @@
 #include "../../include/transformer/vision_transformer.h"
 #include "../../include/transformer/loss_functions.h"
+#include "../../include/transformer/token_merging.h"
 #include "../../include/matrix/matrix_ops.h"
 #include "../../include/matrix/activation_functions.h"
+#include "../../include/matrix/thread_pool.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Quantized model file header: magic, format version, model dimensions
+// (version 2 stores the attention Q/K/V weights packed, see multi_head_attention.h)
+constexpr char QUANTIZED_MAGIC[4] = {'V', 'I', 'T', 'Q'};
+constexpr uint32_t QUANTIZED_VERSION = 2;
+
+} // namespace
 
 VisionTransformer::VisionTransformer(int img_size, int patch_size, int embed_dim, 
                                    int num_heads, int mlp_dim, int num_layers, int num_classes,
                                    double dropout, bool cuda)
     : patch_embed(patch_size, embed_dim),
       pos_encoding(patch_embed.get_num_patches(img_size) + 1, embed_dim),
-      embed_dim(embed_dim), num_classes(num_classes), num_layers(num_layers),
-      dropout_rate(dropout), use_cuda(cuda) {
+      grid_size(img_size / patch_size), embed_dim(embed_dim), head_dim(embed_dim / num_heads),
+      num_classes(num_classes), num_layers(num_layers),
+      dropout_rate(dropout), use_cuda(cuda), storage_type(StorageType::Float32) {
     
     // Initialize transformer blocks
     for (int i = 0; i < num_layers; i++) {
@@ -22,97 +39,312 @@ VisionTransformer::VisionTransformer(int img_size, int patch_size, int embed_dim
 
 void VisionTransformer::initWeights() {
     // Better initialization - Xavier/Glorot for CLS token
-    cls_token = Matrix(1, embed_dim);
     double std_cls = sqrt(2.0 / embed_dim);
-    for (int j = 0; j < embed_dim; j++) {
-        cls_token(0, j) = ((double)rand() / RAND_MAX - 0.5) * 2 * std_cls;
-    }
+    cls_token = Matrix::random(1, embed_dim, -std_cls, std_cls);
     
     // He initialization for classification head
-    classification_head_weight = Matrix(num_classes, embed_dim);
+    double std_head = sqrt(2.0 / embed_dim);
+    classification_head_weight = Matrix::random(num_classes, embed_dim, -std_head, std_head);
     classification_head_bias = Matrix(num_classes, 1);
+}
+
+void VisionTransformer::set_storage_type(StorageType type) {
+    storage_type = type;
+    patch_embed.set_weight_storage(type);
+    for (auto& block : transformer_blocks) {
+        block.set_weight_storage(type);
+    }
+    if (type == StorageType::Int8) {
+        classification_head_int8.assign(ConstMatrixView(classification_head_weight), true, head_range.scale());
+    } else {
+        classification_head_int8.clear();
+    }
+}
+
+void VisionTransformer::set_sparse_mlp(bool enabled) {
+    for (auto& block : transformer_blocks) {
+        block.set_sparse_mlp(enabled);
+    }
+}
+
+void VisionTransformer::set_token_merging(const std::vector<size_t>& r) {
+    merged_per_layer = r;
+}
+
+void VisionTransformer::calibrate(const Matrix& images, size_t batch_size) {
+    StorageType type = storage_type;
+    set_storage_type(StorageType::Float32);
+    patch_embed.set_calibration(true);
+    for (auto& block : transformer_blocks) {
+        block.set_calibration(true);
+    }
+    head_range.start();
     
-    double std_head = sqrt(2.0 / embed_dim);
-    for (int i = 0; i < num_classes; i++) {
-        for (int j = 0; j < embed_dim; j++) {
-            classification_head_weight(i, j) = ((double)rand() / RAND_MAX - 0.5) * 2 * std_head;
-        }
-        classification_head_bias(i, 0) = 0.0;
+    Matrix batch, logits;
+    for (size_t first = 0; first < images.getRows(); first += batch_size) {
+        size_t rows = std::min(batch_size, images.getRows() - first);
+        batch = Matrix(images.row_range(first, rows));
+        forward(batch, logits, false);
     }
+    
+    patch_embed.set_calibration(false);
+    for (auto& block : transformer_blocks) {
+        block.set_calibration(false);
+    }
+    head_range.stop();
+    set_storage_type(type);
+}
+
+void VisionTransformer::save_quantized(const std::string& path) const {
+    if (storage_type != StorageType::Int8) {
+        throw std::runtime_error("save_quantized requires StorageType::Int8");
+    }
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    
+    const uint32_t header[4] = {QUANTIZED_VERSION, uint32_t(embed_dim), uint32_t(num_classes), uint32_t(num_layers)};
+    file.write(QUANTIZED_MAGIC, sizeof(QUANTIZED_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    patch_embed.write(file);
+    pos_encoding.write(file);
+    Quantization::write_matrix(file, ConstMatrixView(cls_token));
+    for (const auto& block : transformer_blocks) {
+        block.write(file);
+    }
+    classification_head_int8.write(file);
+    Quantization::write_matrix(file, ConstMatrixView(classification_head_bias));
+    if (!file) {
+        throw std::runtime_error("Failed writing " + path);
+    }
+}
+
+void VisionTransformer::load_quantized(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    
+    char magic[4];
+    uint32_t header[4];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!file || std::memcmp(magic, QUANTIZED_MAGIC, sizeof(magic)) != 0 || header[0] != QUANTIZED_VERSION) {
+        throw std::runtime_error(path + " is not a quantized model file");
+    }
+    if (header[1] != uint32_t(embed_dim) || header[2] != uint32_t(num_classes) || header[3] != uint32_t(num_layers)) {
+        throw std::runtime_error(path + " was saved from a model with other dimensions");
+    }
+    
+    patch_embed.read(file);
+    pos_encoding.read(file);
+    Quantization::read_matrix(file, cls_token.view());
+    for (auto& block : transformer_blocks) {
+        block.read(file);
+    }
+    classification_head_int8.read(file);
+    Quantization::read_matrix(file, classification_head_bias.view());
+    if (classification_head_int8.out_features() != size_t(num_classes) ||
+        classification_head_int8.in_features() != size_t(embed_dim) || !classification_head_int8.is_transposed()) {
+        throw std::runtime_error(path + " was saved from a model with other dimensions");
+    }
+    classification_head_int8.to_matrix(classification_head_weight.view());
+    head_range.max_abs = classification_head_int8.input_scale() * 127.0f;
+    storage_type = StorageType::Int8;
 }
 
 Matrix VisionTransformer::forward(const Matrix& images, bool training) {
+    Matrix logits;
+    forward(images, logits, training);
+    return logits;
+}
+
+void VisionTransformer::forward(const Matrix& images, Matrix& logits, bool training) {
+    forward(images, logits, Workspace::local(), training);
+}
+
+// No layer depends on training yet (the model has no dropout, see setTraining)
+void VisionTransformer::forward(const Matrix& images, Matrix& logits, Workspace& workspace, bool /*training*/) {
+    Workspace::Scope scope(workspace);
     int batch_size = images.getRows();
     
     // Patch embedding
-    Matrix patch_embeddings = patch_embed.forward(images);
+    patch_embed.forward(images, patch_embeddings);
     int num_patches = patch_embeddings.getRows() / batch_size;
+    int seq_len = num_patches + 1;
+    
+    // All sequences stacked: [batch_size, num_patches + 1, embed_dim]
+    Tensor3View sequences = workspace.tensor3<Scalar>(batch_size, seq_len, embed_dim);
     
-    // Reshape to [batch_size, num_patches, embed_dim]
-    Matrix batch_embeddings(num_patches, embed_dim);
-    Matrix sequence(num_patches + 1, embed_dim);
-    Matrix logits(batch_size, num_classes);
-    
-    for (int b = 0; b < batch_size; b++) {
-        // Extract patches for this batch
-        for (int p = 0; p < num_patches; p++) {
-            for (int d = 0; d < embed_dim; d++) {
-                batch_embeddings(p, d) = patch_embeddings(b * num_patches + p, d);
-            }
+    // Samples are independent and each writes only its own sequence
+    parallel_for_rows(batch_size, seq_len * embed_dim, 1 << 15, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; b++) {
+            MatrixView sequence = sequences[b];
+            
+            // Prepend CLS token, then copy this sample's patches straight in
+            MatrixOps::copy(sequence.row_range(0, 1), cls_token);
+            MatrixOps::copy(sequence.row_range(1, num_patches),
+                            patch_embeddings.row_range(b * num_patches, num_patches));
+            
+            // Add positional encoding
+            pos_encoding.forward_inplace(sequence);
         }
-        
-        // Prepend CLS token
-        for (int d = 0; d < embed_dim; d++) {
-            sequence(0, d) = cls_token(0, d);
+    });
+    
+    // Pass the whole batch through the transformer blocks
+    size_t* offsets = static_cast<size_t*>(workspace.allocate((batch_size + 1) * sizeof(size_t)));
+    PackedBatchView result = run_blocks(PackedBatchView(sequences, offsets), workspace);
+    
+    // Classification head on the CLS tokens (row 0 of every sequence, read
+    // in place; merging shortens all sequences alike)
+    classify(Tensor3View(result.flat(), result.length(0)).row_of_each(0), logits);
+}
+
+void VisionTransformer::forward(const std::vector<Matrix>& images, Matrix& logits, Workspace& workspace) {
+    Workspace::Scope scope(workspace);
+    size_t batch_size = images.size();
+    
+    // Sequence b is CLS plus the patches of image b, at rows
+    // [sequence_offsets[b], sequence_offsets[b + 1]) of the packed batch
+    sequence_offsets.resize(batch_size + 1);
+    sequence_offsets[0] = 0;
+    for (size_t b = 0; b < batch_size; b++) {
+        int grid = PatchEmbedding::image_side(images[b]) / patch_embed.get_patch_size();
+        if (grid < 1 || grid > grid_size) {
+            throw std::invalid_argument("Image side must be between patch_size and img_size");
         }
-        for (int p = 0; p < num_patches; p++) {
-            for (int d = 0; d < embed_dim; d++) {
-                sequence(p + 1, d) = batch_embeddings(p, d);
-            }
+        sequence_offsets[b + 1] = sequence_offsets[b] + 1 + grid * grid;
+    }
+    patch_embed.forward(images, patch_embeddings);
+    
+    PackedBatchView sequences(workspace.matrix<Scalar>(sequence_offsets[batch_size], embed_dim),
+                              sequence_offsets.data(), batch_size);
+    parallel_for(batch_size, 1, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; b++) {
+            // CLS, this image's patches, then the positional embeddings of
+            // their places on the full grid
+            MatrixView sequence = sequences[b];
+            size_t num_patches = sequence.getRows() - 1;
+            MatrixOps::copy(sequence.row_range(0, 1), cls_token);
+            MatrixOps::copy(sequence.row_range(1, num_patches),
+                            patch_embeddings.row_range(sequence_offsets[b] - b, num_patches));
+            pos_encoding.forward_inplace(sequence, (int)std::lround(std::sqrt(double(num_patches))), grid_size);
         }
-        
-        // Add positional encoding
-        sequence = pos_encoding.forward(sequence);
-        
-        // Pass through transformer blocks
-        for (int i = 0; i < num_layers; i++) {
-            sequence = transformer_blocks[i].forward(sequence);
+    });
+    
+    PackedBatchView result = run_blocks(sequences, workspace);
+    
+    // The CLS rows sit at the sequence offsets, gathered for the head
+    MatrixView cls = workspace.matrix<Scalar>(batch_size, embed_dim);
+    for (size_t b = 0; b < batch_size; b++) {
+        MatrixOps::copy(cls.row_range(b, 1), result.flat().row_range(result.offset(b), 1));
+    }
+    classify(cls, logits);
+}
+
+PackedBatchView VisionTransformer::run_blocks(PackedBatchView sequences, Workspace& workspace) {
+    const size_t batch = sequences.getBatch();
+    const size_t capacity = sequences.total_rows();
+    const bool half = storage_type == StorageType::BFloat16 || storage_type == StorageType::Float16;
+    const bool merging = std::any_of(merged_per_layer.begin(), merged_per_layer.end(),
+                                     [](size_t r) { return r > 0; });
+    
+    // Scalar activations ping-pong between sequences' buffer and a second
+    // one (the 16-bit path keeps them in stream/next and needs the second
+    // buffer only as the target of merges); sequences views the current one
+    MatrixView buffers[2] = {sequences.flat(), MatrixView()};
+    if (!half || merging) {
+        buffers[1] = workspace.matrix<Scalar>(capacity, embed_dim);
+    }
+    size_t current = 0;
+    
+    // Token merging state: how many original patches each token stands for,
+    // its log (the attention key bias once tokens have merged) and the keys
+    // of the block before each merge
+    Scalar* sizes = nullptr;
+    Scalar* merged_sizes = nullptr;
+    Scalar* log_sizes = nullptr;
+    const Scalar* key_bias = nullptr;
+    MatrixView keys;
+    if (merging) {
+        sizes = static_cast<Scalar*>(workspace.allocate(capacity * sizeof(Scalar)));
+        merged_sizes = static_cast<Scalar*>(workspace.allocate(capacity * sizeof(Scalar)));
+        log_sizes = static_cast<Scalar*>(workspace.allocate(capacity * sizeof(Scalar)));
+        std::fill(sizes, sizes + capacity, Scalar(1));
+        keys = workspace.matrix<Scalar>(capacity, head_dim);
+    }
+    
+    if (half) {
+        stream.assign(ConstMatrixView(sequences.flat()), storage_type);
+    }
+    for (int i = 0; i < num_layers; i++) {
+        size_t r = size_t(i) < merged_per_layer.size() ? merged_per_layer[i] : 0;
+        size_t tokens = sequences.total_rows();
+        MatrixView layer_keys = r > 0 ? keys.row_range(0, tokens) : MatrixView();
+        if (half) {
+            transformer_blocks[i].forward(stream, sequences.offsets(), batch, next, workspace, key_bias, layer_keys);
+            std::swap(stream, next);
+        } else {
+            PackedBatchView block_out(buffers[1 - current].row_range(0, tokens), sequences.offsets(), batch);
+            transformer_blocks[i].forward(sequences, block_out, workspace, key_bias, layer_keys);
+            sequences = block_out;
+            current = 1 - current;
         }
-        
-        // Classification head (use CLS token)
-        Matrix cls_output(1, embed_dim);
-        for (int d = 0; d < embed_dim; d++) {
-            cls_output(0, d) = sequence(0, d);
+        if (r == 0) {
+            continue;
         }
         
-        Matrix batch_logits = MatrixOps::matmul(cls_output, MatrixOps::transpose(classification_head_weight));
-        
-        // Add bias and store
-        for (int c = 0; c < num_classes; c++) {
-            logits(b, c) = batch_logits(0, c) + classification_head_bias(c, 0);
+        // Merge into the other buffer; the offsets of the shorter sequences
+        // live in workspace like the buffers
+        if (half) {
+            stream.to_matrix(sequences.flat());
+        }
+        size_t* merged_offsets = static_cast<size_t*>(workspace.allocate((batch + 1) * sizeof(size_t)));
+        merged_offsets[0] = 0;
+        for (size_t b = 0; b < batch; b++) {
+            merged_offsets[b + 1] = merged_offsets[b] + TokenMerging::merged_length(sequences.length(b), r);
+        }
+        PackedBatchView merged(buffers[1 - current].row_range(0, merged_offsets[batch]), merged_offsets, batch);
+        TokenMerging::merge(sequences, layer_keys, sizes, r, merged, merged_sizes);
+        std::swap(sizes, merged_sizes);
+        for (size_t t = 0; t < merged.total_rows(); t++) {
+            log_sizes[t] = std::log(sizes[t]);
+        }
+        key_bias = log_sizes;
+        sequences = merged;
+        current = 1 - current;
+        if (half) {
+            stream.assign(ConstMatrixView(sequences.flat()), storage_type);
         }
     }
-    
-    return logits;
+    if (half) {
+        stream.to_matrix(sequences.flat());
+    }
+    return sequences;
+}
+
+void VisionTransformer::classify(ConstMatrixView cls, Matrix& logits) {
+    // classification_head_weight is [num_classes, embed_dim], read transposed
+    // in place, and the bias is added in the GEMM epilogue
+    logits.resize_uninitialized(cls.getRows(), num_classes);
+    head_range.observe(cls);
+    const Gemm::Epilogue<Scalar> epilogue =
+        MatrixOps::make_epilogue(ConstMatrixView(classification_head_bias.data(), 1, num_classes));
+    if (!classification_head_int8.empty()) {
+        classification_head_int8.multiply(cls, logits);
+        MatrixOps::apply_epilogue(logits.view(), epilogue);
+    } else {
+        MatrixOps::gemm(1.0, cls, false, classification_head_weight, true, 0.0, logits, epilogue);
+    }
 }
 
 Matrix VisionTransformer::get_predictions(const Matrix& logits) {
     Matrix predictions(logits.getRows(), 1);
-    
-    for (int i = 0; i < logits.getRows(); i++) {
-        int max_idx = 0;
-        double max_val = logits(i, 0);
-        
-        for (int j = 1; j < logits.getCols(); j++) {
-            if (logits(i, j) > max_val) {
-                max_val = logits(i, j);
-                max_idx = j;
-            }
-        }
-        
-        predictions(i, 0) = max_idx;
+    std::vector<size_t> classes = MatrixOps::argmaxAxis(logits, 1);
+    for (size_t i = 0; i < classes.size(); i++) {
+        predictions(i, 0) = classes[i];
     }
-    
     return predictions;
 }
 
@@ -1,29 +1,36 @@
 #include "../../include/utils/data_augmentation.h"
-#include <random>
+#include "../../include/matrix/random.h"
+#include "../../include/matrix/thread_pool.h"
+#include <algorithm>
 #include <cmath>
 
 Matrix DataAugmentation::addNoise(const Matrix& image, double noise_level) {
-    Matrix result = image;
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<> noise(0.0, noise_level);
-    
-    for (int i = 0; i < result.getRows(); i++) {
-        for (int j = 0; j < result.getCols(); j++) {
-            result(i, j) = std::max(0.0, std::min(1.0, result(i, j) + noise(gen)));
+    // Pixel (i, j) takes element i * cols + j of one counter-based stream, so
+    // rows are noised in parallel with the same result on any thread count
+    Matrix result(image.getRows(), image.getCols());
+    const Random::Stream stream = Random::Stream::next();
+    const size_t cols = image.getCols();
+    parallel_for_rows(image.getRows(), cols, 1 << 14, [&](size_t first, size_t last) {
+        constexpr size_t CHUNK = 256;
+        Scalar noise[CHUNK];
+        for (size_t i = first; i < last; ++i) {
+            const Scalar* src = image.row_ptr(i);
+            Scalar* dst = result.row_ptr(i);
+            for (size_t j0 = 0; j0 < cols; j0 += CHUNK) {
+                const size_t n = std::min(CHUNK, cols - j0);
+                stream.normal(noise, n, Scalar(0), static_cast<Scalar>(noise_level), uint64_t(i) * cols + j0);
+                for (size_t j = 0; j < n; ++j) {
+                    dst[j0 + j] = std::max(Scalar(0), std::min(Scalar(1), src[j0 + j] + noise[j]));
+                }
+            }
         }
-    }
+    });
     return result;
 }
 
 Matrix DataAugmentation::normalize(const Matrix& image, double mean, double std) {
-    Matrix result = image;
-    for (int i = 0; i < result.getRows(); i++) {
-        for (int j = 0; j < result.getCols(); j++) {
-            result(i, j) = (result(i, j) - mean) / std;
-        }
-    }
-    return result;
+    // One fused pass (see matrix_expr.h)
+    return (lazy(image) - mean) / std;
 }
 
 Matrix DataAugmentation::randomCrop(const Matrix& image, int crop_size) {
@@ -4,7 +4,7 @@
 
 
 /*
-g++ -std=c++17 -I. tests/01_test_transformer_layer.cpp src/matrix/matrix.cpp src/matrix/matrix_ops.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/utils/file_io.cpp -o test_transformer && ./test_transformer
+g++ -std=c++17 -I. tests/01_test_transformer_layer.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/workspace.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/utils/file_io.cpp -o test_transformer && ./test_transformer
 
 */
 
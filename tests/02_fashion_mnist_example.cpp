@@ -12,7 +12,7 @@ std::vector<std::string> fashion_labels = {
 
 
 /*
- g++ -std=c++17 -I. tests/02_fashion_mnist_example.cpp src/matrix/matrix.cpp src/utils/file_io.cpp -o fashion_test && ./fashion_test
+ g++ -std=c++17 -I. tests/02_fashion_mnist_example.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/cpu_features.cpp src/matrix/thread_pool.cpp src/utils/file_io.cpp -o fashion_test && ./fashion_test
 */
 
 
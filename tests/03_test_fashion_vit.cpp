@@ -11,7 +11,7 @@ std::vector<std::string> fashion_labels = {
 };
 
 /*
- g++ -std=c++17 -I. tests/03_test_fashion_vit.cpp src/matrix/matrix.cpp src/utils/file_io.cpp -o fashion_test_vit && ./fashion_test_vit
+ g++ -std=c++17 -I. tests/03_test_fashion_vit.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/cpu_features.cpp src/matrix/thread_pool.cpp src/utils/file_io.cpp -o fashion_test_vit && ./fashion_test_vit
 */
 int main() {
     try {
@@ -4,6 +4,7 @@
 #include "../include/training/lr_scheduler.h"
 #include "../include/utils/data_augmentation.h"
 #include "../include/utils/file_io.h"
+#include "../include/matrix/memory.h"
 #include <iostream>
 #include <vector>
 #include <random>
@@ -35,6 +36,10 @@ int main() {
     std::vector<int> train_labels = FileIO::load_mnist_labels("data/train-labels-idx1-ubyte/train-labels-idx1-ubyte");
     Matrix test_images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
     std::vector<int> test_labels = FileIO::load_mnist_labels("data/t10k-labels-idx1-ubyte/t10k-labels-idx1-ubyte");
+    std::cout << "Large buffers: "
+              << Memory::allocations(Memory::Policy::ExplicitHugePages) << " on explicit huge pages, "
+              << Memory::allocations(Memory::Policy::TransparentHugePages) << " on transparent huge pages, "
+              << Memory::allocations(Memory::Policy::Mapped) << " on 4 KB pages" << std::endl;
     
     // Normalize data
     for (int i = 0; i < train_images.getRows(); i++) {
@@ -0,0 +1,118 @@
+#include "../include/matrix/vector_math.h"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/09_vector_math_benchmark.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp -o vector_math_benchmark && ./vector_math_benchmark
+*/
+
+// Distance from got to the exact (double) value in units of the float
+// spacing at max(|exact|, floor)
+static double ulp_error(float got, double exact, float floor = 0.0f) {
+    if (std::isnan(exact)) {
+        return std::isnan(got) ? 0.0 : INFINITY;
+    }
+    const float rounded = static_cast<float>(exact);
+    if (std::isinf(rounded)) {
+        return got == rounded ? 0.0 : INFINITY;
+    }
+    const float magnitude = std::max(std::abs(rounded), floor);
+    const double ulp = static_cast<double>(std::nextafter(magnitude, INFINITY)) - magnitude;
+    return std::abs(static_cast<double>(got) - exact) / ulp;
+}
+
+// Every 64th float in [lo, hi]
+static std::vector<float> sample_inputs(float lo, float hi) {
+    std::vector<float> inputs;
+    for (float x = lo; x <= hi;) {
+        inputs.push_back(x);
+        for (int step = 0; step < 64; ++step) {
+            x = std::nextafter(x, INFINITY);
+        }
+    }
+    return inputs;
+}
+
+template <typename Kernel, typename Reference, typename Libm>
+static bool run_benchmark(const char* name, float lo, float hi, double max_ulp,
+                          Kernel kernel, Reference reference, Libm libm, bool ulp_of_input = false) {
+    std::vector<float> inputs = sample_inputs(lo, hi);
+    std::vector<float> outputs(inputs.size());
+
+    // Validate against libm evaluated in double
+    kernel(inputs.data(), outputs.data(), inputs.size());
+    double worst = 0.0;
+    float worst_x = 0.0f;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        double err = ulp_error(outputs[i], reference(static_cast<double>(inputs[i])),
+                               ulp_of_input ? std::abs(inputs[i]) : 0.0f);
+        if (err > worst) {
+            worst = err;
+            worst_x = inputs[i];
+        }
+    }
+    bool ok = worst <= max_ulp;
+
+    // Time a 512-wide row (the MLP hidden layer) of activations in [-10, 10]
+    // against the float libm loop
+    std::vector<float> row(512), out(512);
+    for (size_t j = 0; j < row.size(); ++j) {
+        row[j] = -10.0f + 20.0f * j / row.size();
+    }
+    const int reps = 200000;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        kernel(row.data(), out.data(), row.size());
+    }
+    double simd_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        std::transform(row.begin(), row.end(), out.begin(), libm);
+    }
+    double libm_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << " [" << lo << ", " << hi << "]: max " << worst
+              << (ulp_of_input ? " ULP of |x| at " : " ULP at ") << worst_x
+              << " (bound " << max_ulp << ")" << (ok ? " ✓" : " ✗") << ", "
+              << simd_ns / (reps * row.size()) << " ns/elem vs libm "
+              << libm_ns / (reps * row.size()) << " ns/elem" << std::endl;
+    return ok;
+}
+
+int main() {
+    std::cout << "=== VECTOR MATH BENCHMARK ===" << std::endl;
+    std::cout << "Kernels: " << VectorMath::kernel_name() << std::endl;
+
+    bool all_ok = run_benchmark("exp", -110.0f, 90.0f, 1.5,
+        [](const float* s, float* d, size_t n) { VectorMath::exp(s, d, n); },
+        [](double x) { return std::exp(x); }, [](float x) { return std::exp(x); });
+    all_ok = run_benchmark("tanh", -20.0f, 20.0f, 1.5,
+        [](const float* s, float* d, size_t n) { VectorMath::tanh(s, d, n); },
+        [](double x) { return std::tanh(x); }, [](float x) { return std::tanh(x); }) && all_ok;
+    all_ok = run_benchmark("erf", -10.0f, 10.0f, 3.0,
+        [](const float* s, float* d, size_t n) { VectorMath::erf(s, d, n); },
+        [](double x) { return std::erf(x); }, [](float x) { return std::erf(x); }) && all_ok;
+    // GELU is x * sigmoid(2u); the sigmoid's relative error grows with |u|
+    // where it is tiny, so GELU is held to ULPs of |x|
+    all_ok = run_benchmark("gelu", -10.0f, 10.0f, 2.0,
+        [](const float* s, float* d, size_t n) { VectorMath::gelu(s, d, n); },
+        // 0.5 x (1 + tanh(u)) written as x / (1 + exp(-2u)) so the reference
+        // does not cancel for negative x
+        [](double x) { return x / (1.0 + std::exp(-1.5957691216057308 * (x + 0.044715 * x * x * x))); },
+        [](float x) { return 0.5f * x * (1.0f + std::tanh(0.7978845608f * (x + 0.044715f * x * x * x))); },
+        true) && all_ok;
+
+#ifdef VIT_EXACT_MATH
+    // The bounds describe the polynomial kernels; libm is only reported
+    all_ok = true;
+#endif
+    if (!all_ok) {
+        std::cout << "❌ Vector math error exceeds its documented bound" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Vector math benchmark completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "../include/matrix/random.h"
+#include "../include/matrix/thread_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/10_random_benchmark.cpp src/matrix/random.cpp src/matrix/cpu_features.cpp src/matrix/thread_pool.cpp -o random_benchmark && ./random_benchmark
+*/
+
+static bool check(const char* name, bool ok) {
+    std::cout << (ok ? "✓ " : "✗ ") << name << std::endl;
+    return ok;
+}
+
+// Philox4x32-10 known answer (Random123 kat_vectors): key 0, counter 0
+static bool known_answer() {
+    Random::seed(0);
+    uint32_t words[4];
+    Random::Stream(0).bits(0, 4, words);
+    return words[0] == 0x6627e8d5u && words[1] == 0xe169c58du &&
+           words[2] == 0xbc57ac4cu && words[3] == 0x9b00dbd8u;
+}
+
+// Element i is the same whether drawn alone, in an unaligned range or by a
+// parallel fill on any number of threads
+static bool reproducible() {
+    const size_t n = 1 << 20;
+    bool ok = true;
+
+    Random::seed(1234);
+    std::vector<float> reference(n);
+    Random::uniform(reference.data(), n, -1.0, 1.0);
+    std::vector<float> normals(n);
+    Random::normal(normals.data(), n, 0.0, 1.0);
+
+    for (size_t threads : {size_t(1), size_t(3), size_t(4)}) {
+        ThreadPool::set_num_threads(threads);
+        Random::seed(1234);
+        std::vector<float> u(n), z(n);
+        Random::uniform(u.data(), n, -1.0, 1.0);
+        Random::normal(z.data(), n, 0.0, 1.0);
+        ok = ok && u == reference && z == normals;
+    }
+
+    // Odd offsets: normals come in Box-Muller pairs
+    const Random::Stream stream(1);
+    std::vector<float> slice(1001);
+    stream.normal(slice.data(), slice.size(), 0.0f, 1.0f, 12345);
+    ok = ok && std::equal(slice.begin(), slice.end(), normals.begin() + 12345);
+
+    // Another seed gives other numbers
+    Random::seed(1235);
+    std::vector<float> other(n);
+    Random::uniform(other.data(), n, -1.0, 1.0);
+    return ok && other != reference;
+}
+
+// Sample mean and variance against the distribution's
+static bool moments() {
+    const size_t n = 1 << 22;
+    std::vector<double> u(n), z(n);
+    Random::uniform(u.data(), n, 0.0, 1.0);
+    Random::normal(z.data(), n, 2.0, 3.0);
+
+    auto stats = [](const std::vector<double>& v, double& mean, double& var) {
+        mean = 0.0;
+        for (double x : v) mean += x;
+        mean /= v.size();
+        var = 0.0;
+        for (double x : v) var += (x - mean) * (x - mean);
+        var /= v.size();
+    };
+    double um, uv, zm, zv;
+    stats(u, um, uv);
+    stats(z, zm, zv);
+    std::cout << "  uniform[0,1): mean " << um << ", var " << uv
+              << "   normal(2,3): mean " << zm << ", var " << zv << std::endl;
+    // Five standard errors
+    const double se = 5.0 / std::sqrt(static_cast<double>(n));
+    return std::abs(um - 0.5) < se * std::sqrt(1.0 / 12.0) && std::abs(uv - 1.0 / 12.0) < se * 0.075 &&
+           std::abs(zm - 2.0) < se * 3.0 && std::abs(zv - 9.0) < se * 9.0 * std::sqrt(2.0);
+}
+
+template <typename Fill>
+static double throughput(size_t n, Fill fill) {
+    std::vector<float> buffer(n);
+    fill(buffer.data(), n);
+    auto start = std::chrono::high_resolution_clock::now();
+    const int reps = 10;
+    for (int r = 0; r < reps; ++r) {
+        fill(buffer.data(), n);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    return reps * n * sizeof(float) / seconds / 1e9;
+}
+
+int main() {
+    std::cout << "=== RANDOM BENCHMARK ===" << std::endl;
+
+    bool all_ok = check("Philox4x32-10 known-answer vector", known_answer());
+    all_ok = check("Same seed, same numbers on 1/3/4 threads", reproducible()) && all_ok;
+    all_ok = check("Uniform and normal moments", moments()) && all_ok;
+
+    ThreadPool::set_num_threads(ThreadPool::physical_cores());
+    const size_t n = size_t(1) << 24;
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+
+    std::cout << "\nFill of " << n << " floats (GB/s, " << ThreadPool::num_threads() << " threads):" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  mt19937 uniform:  " << throughput(n, [&](float* d, size_t c) {
+        for (size_t i = 0; i < c; ++i) d[i] = uniform(gen);
+    }) << std::endl;
+    std::cout << "  Philox uniform:   " << throughput(n, [](float* d, size_t c) {
+        Random::uniform(d, c, -1.0, 1.0);
+    }) << std::endl;
+    std::cout << "  mt19937 normal:   " << throughput(n, [&](float* d, size_t c) {
+        for (size_t i = 0; i < c; ++i) d[i] = normal(gen);
+    }) << std::endl;
+    std::cout << "  Philox normal:    " << throughput(n, [](float* d, size_t c) {
+        Random::normal(d, c, 0.0, 1.0);
+    }) << std::endl;
+
+    if (!all_ok) {
+        std::cout << "❌ Random generator check failed" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Random benchmark completed!" << std::endl;
+    return 0;
+}
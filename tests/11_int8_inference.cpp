@@ -0,0 +1,176 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/matrix/quantized.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/random.h"
+#include "../include/matrix/thread_pool.h"
+#include "../include/utils/file_io.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/11_int8_inference.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/workspace.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/patch_embedding.cpp src/transformer/positional_encoding.cpp src/transformer/token_merging.cpp src/transformer/vision_transformer.cpp src/transformer/loss_functions.cpp src/utils/file_io.cpp -o int8_inference && ./int8_inference
+*/
+
+// Fashion-MNIST test set normalized as in training, or uniform noise in the
+// same range when the files are not there
+static Matrix load_test_images(std::vector<int>& labels, size_t count) {
+    try {
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        labels = FileIO::load_mnist_labels("data/t10k-labels-idx1-ubyte/t10k-labels-idx1-ubyte");
+        count = std::min<size_t>(count, images.getRows());
+        Matrix normalized(images.row_range(0, count));
+        for (size_t i = 0; i < normalized.size(); i++) {
+            normalized.data()[i] = (normalized.data()[i] - 0.5) / 0.5;
+        }
+        labels.resize(count);
+        std::cout << "Fashion-MNIST test set: " << count << " images" << std::endl;
+        return normalized;
+    } catch (const std::exception&) {
+        std::cout << "Fashion-MNIST not found under data/, using random images" << std::endl;
+        labels.clear();
+        return Matrix::random(count, 28 * 28, -1.0, 1.0);
+    }
+}
+
+static double accuracy(const Matrix& logits, const std::vector<int>& labels) {
+    size_t correct = 0;
+    for (size_t i = 0; i < labels.size(); i++) {
+        const Scalar* row = logits.row_ptr(i);
+        correct += std::max_element(row, row + logits.getCols()) - row == labels[i];
+    }
+    return 100.0 * correct / labels.size();
+}
+
+static Matrix run(VisionTransformer& vit, const Matrix& images, size_t batch_size) {
+    Matrix all(images.getRows(), 10), batch, logits;
+    for (size_t first = 0; first < images.getRows(); first += batch_size) {
+        size_t rows = std::min(batch_size, images.getRows() - first);
+        batch = Matrix(images.row_range(first, rows));
+        vit.forward(batch, logits, false);
+        MatrixOps::copy(all.row_range(first, rows), logits);
+    }
+    return all;
+}
+
+// Milliseconds per forward of one batch
+static double time_forward(VisionTransformer& vit, const Matrix& batch) {
+    Matrix logits;
+    for (int i = 0; i < 3; i++) {
+        vit.forward(batch, logits, false);
+    }
+    const int reps = 20;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) {
+        vit.forward(batch, logits, false);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+// One linear layer of the MLP ([tokens, 128] x [128, 512]) in fp32 and int8
+static void linear_benchmark() {
+    const size_t m = 64 * 17, k = 128, n = 512;
+    Matrix x = Matrix::random(m, k, -1.0, 1.0), w = Matrix::random(k, n, -1.0, 1.0), out(m, n);
+    QuantizedMatrix q;
+    q.assign(ConstMatrixView(w), false);
+
+    auto time = [&](auto&& f) {
+        f();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < 50; i++) {
+            f();
+        }
+        return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / 50;
+    };
+    double fp32 = time([&] { MatrixOps::matmul_into(out, x, w); });
+    double int8 = time([&] { q.multiply(ConstMatrixView(x), out); });
+    std::cout << "Linear " << m << "x" << k << "x" << n << ": fp32 " << fp32 << " ms, int8 " << int8
+              << " ms (" << fp32 / int8 << "x)" << std::endl;
+}
+
+int main() {
+    std::cout << "=== INT8 INFERENCE ===" << std::endl;
+    std::cout << "Kernels: " << Quantization::kernel_name() << std::endl;
+    Random::seed(2024);
+
+    // Same architecture as tests/07_optimized_training.cpp
+    VisionTransformer vit(28, 7, 128, 8, 512, 4, 10, 0.0);
+    std::vector<int> labels;
+    const size_t calibration_count = 512;
+    Matrix images = load_test_images(labels, 2048 + calibration_count);
+    Matrix calibration(images.row_range(0, calibration_count));
+    Matrix evaluation(images.row_range(calibration_count, images.getRows() - calibration_count));
+    std::vector<int> eval_labels;
+    if (!labels.empty()) {
+        eval_labels.assign(labels.begin() + calibration_count, labels.end());
+    }
+
+    // fp32 reference
+    Matrix reference = run(vit, evaluation, 64);
+
+    // Calibrate on a held-out sample, then quantize
+    vit.calibrate(calibration, 64);
+    vit.set_storage_type(StorageType::Int8);
+    Matrix quantized = run(vit, evaluation, 64);
+
+    size_t agree = 0;
+    double max_error = 0.0, max_logit = 0.0;
+    for (size_t i = 0; i < evaluation.getRows(); i++) {
+        const Scalar* r = reference.row_ptr(i);
+        const Scalar* q = quantized.row_ptr(i);
+        agree += std::max_element(r, r + 10) - r == std::max_element(q, q + 10) - q;
+        for (int c = 0; c < 10; c++) {
+            max_error = std::max(max_error, std::abs(double(r[c] - q[c])));
+            max_logit = std::max(max_logit, std::abs(double(r[c])));
+        }
+    }
+    double agreement = 100.0 * agree / evaluation.getRows();
+    double relative_error = max_error / max_logit;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\nTop-1 agreement int8 vs fp32: " << agreement << "% (" << evaluation.getRows() << " images)" << std::endl;
+    std::cout << std::setprecision(4) << "Max logit error: " << max_error << " (" << 100.0 * relative_error
+              << "% of max |logit|)" << std::endl;
+    if (!eval_labels.empty()) {
+        std::cout << std::setprecision(2) << "Accuracy fp32: " << accuracy(reference, eval_labels)
+                  << "%, int8: " << accuracy(quantized, eval_labels) << "%" << std::endl;
+    }
+
+    // Quantized model file round trip
+    const char* path = "vit_int8.bin";
+    vit.save_quantized(path);
+    VisionTransformer loaded(28, 7, 128, 8, 512, 4, 10, 0.0);
+    loaded.load_quantized(path);
+    Matrix reloaded = run(loaded, evaluation, 64);
+    // The file keeps fp32 parameters: exact in a float build; in a double one
+    // the rounding can move activations across an int8 step, so the reload
+    // only has to stay within the quantization error itself
+    const double file_tolerance = std::is_same<Scalar, float>::value ? 0.0 : max_error;
+    bool identical = std::equal(reloaded.data(), reloaded.data() + reloaded.size(), quantized.data(),
+                                [&](Scalar a, Scalar b) { return std::abs(double(a - b)) <= file_tolerance; });
+    std::remove(path);
+    std::cout << (identical ? "✓" : "✗") << " Quantized model file reproduces the int8 logits" << std::endl;
+
+    // Throughput, batch of 64
+    std::cout << "\nThroughput (batch 64, " << ThreadPool::num_threads() << " threads):" << std::endl;
+    Matrix batch(evaluation.row_range(0, 64));
+    vit.set_storage_type(StorageType::Float32);
+    double fp32_ms = time_forward(vit, batch);
+    vit.set_storage_type(StorageType::Int8);
+    double int8_ms = time_forward(vit, batch);
+    std::cout << std::setprecision(2) << "  fp32: " << fp32_ms << " ms (" << 64000.0 / fp32_ms << " img/s)" << std::endl;
+    std::cout << "  int8: " << int8_ms << " ms (" << 64000.0 / int8_ms << " img/s), "
+              << fp32_ms / int8_ms << "x" << std::endl;
+    linear_benchmark();
+
+    if (!identical || agreement < 95.0) {
+        std::cout << "❌ Int8 inference deviates from fp32" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Int8 inference completed!" << std::endl;
+    return 0;
+}
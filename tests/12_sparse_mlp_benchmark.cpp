@@ -0,0 +1,157 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/transformer/mlp.h"
+#include "../include/matrix/sparse.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/random.h"
+#include "../include/matrix/thread_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/12_sparse_mlp_benchmark.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/workspace.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/patch_embedding.cpp src/transformer/positional_encoding.cpp src/transformer/token_merging.cpp src/transformer/vision_transformer.cpp src/transformer/loss_functions.cpp src/utils/file_io.cpp -o sparse_mlp_benchmark && ./sparse_mlp_benchmark
+*/
+
+static bool check(const char* name, bool ok) {
+    std::cout << (ok ? "✓ " : "✗ ") << name << std::endl;
+    return ok;
+}
+
+static double max_relative_error(const Matrix& a, const Matrix& b) {
+    double error = 0.0, scale = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        error = std::max(error, std::abs(double(a.data()[i] - b.data()[i])));
+        scale = std::max(scale, std::abs(double(b.data()[i])));
+    }
+    return error / scale;
+}
+
+template <typename F>
+static double time_ms(F&& f, int reps = 30) {
+    f();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+// Half of every group of 4 is zero and the survivors are the largest
+static bool pruning_pattern() {
+    Matrix w = Matrix::random(128, 96, -1.0, 1.0);
+    Matrix pruned(w);
+    Sparsity::prune_2_4(pruned.view());
+    size_t zeros = 0;
+    bool largest = true;
+    for (size_t g = 0; g < w.getRows(); g += 4) {
+        for (size_t c = 0; c < w.getCols(); c++) {
+            Scalar smallest_kept = 2.0, largest_dropped = 0.0;
+            for (size_t j = 0; j < 4; j++) {
+                if (pruned(g + j, c) == 0.0) {
+                    zeros++;
+                    largest_dropped = std::max(largest_dropped, std::abs(w(g + j, c)));
+                } else {
+                    smallest_kept = std::min(smallest_kept, std::abs(w(g + j, c)));
+                }
+            }
+            largest = largest && largest_dropped <= smallest_kept;
+        }
+    }
+    return Sparsity::is_2_4_sparse(ConstMatrixView(pruned)) && !Sparsity::is_2_4_sparse(ConstMatrixView(w)) &&
+           zeros == w.size() / 2 && largest;
+}
+
+// Sparse product against the dense product with the pruned weights, on
+// shapes that leave partial row tiles and panels
+static bool sparse_matches_dense() {
+    bool ok = true;
+    for (size_t m : {1, 7, 100}) {
+        for (size_t n : {5, 40, 128}) {
+            Matrix x = Matrix::random(m, 64, -1.0, 1.0), w = Matrix::random(64, n, -1.0, 1.0);
+            SparseMatrix sparse;
+            sparse.assign(ConstMatrixView(w));
+            Sparsity::prune_2_4(w.view());
+
+            Matrix stored(64, n), dense(m, n), result(m, n);
+            sparse.to_matrix(stored.view());
+            MatrixOps::matmul_into(dense, x, w);
+            sparse.multiply(ConstMatrixView(x), result);
+            // Kept weights are stored as float
+            ok = ok && max_relative_error(stored, w) < 1e-7 && max_relative_error(result, dense) < 1e-5;
+        }
+    }
+    return ok;
+}
+
+// MLP::forward with the sparse kernels against the dense kernels on the
+// same pruned weights
+static bool mlp_matches_dense() {
+    MLP mlp(128, 512);
+    Matrix x = Matrix::random(64, 128, -1.0, 1.0), sparse_out, dense_out;
+    mlp.set_sparse(true);
+    mlp.forward(ConstMatrixView(x), sparse_out);
+    mlp.set_sparse(false);
+    mlp.forward(ConstMatrixView(x), dense_out);
+    return max_relative_error(sparse_out, dense_out) < 1e-5;
+}
+
+int main() {
+    std::cout << "=== 2:4 SPARSE MLP BENCHMARK ===" << std::endl;
+    std::cout << "Kernel: " << Sparsity::kernel_name() << std::endl;
+    Random::seed(2024);
+
+    bool all_ok = check("Magnitude pruning keeps the 2 largest of every 4", pruning_pattern());
+    all_ok = check("Sparse GEMM matches dense GEMM on pruned weights", sparse_matches_dense()) && all_ok;
+    all_ok = check("Sparse MLP forward matches dense forward", mlp_matches_dense()) && all_ok;
+
+    // Same architecture as tests/07_optimized_training.cpp, batch of 64
+    // images (64 x 17 tokens through each MLP)
+    const size_t embed_dim = 128, mlp_dim = 512, tokens = 64 * 17;
+    std::cout << "\nBatch 64 (" << tokens << " tokens), " << ThreadPool::num_threads() << " threads:" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    struct Layer { const char* name; size_t k, n; };
+    for (const Layer& layer : {Layer{"W1", embed_dim, mlp_dim}, Layer{"W2", mlp_dim, embed_dim}}) {
+        Matrix x = Matrix::random(tokens, layer.k, -1.0, 1.0), w = Matrix::random(layer.k, layer.n, -1.0, 1.0);
+        Matrix out(tokens, layer.n);
+        SparseMatrix sparse;
+        sparse.assign(ConstMatrixView(w));
+        Sparsity::prune_2_4(w.view());
+        double dense_ms = time_ms([&] { MatrixOps::matmul_into(out, x, w); });
+        double sparse_ms = time_ms([&] { sparse.multiply(ConstMatrixView(x), out); });
+        std::cout << "  " << layer.name << " [" << layer.k << " x " << layer.n << "]: dense " << dense_ms
+                  << " ms, sparse " << sparse_ms << " ms (" << dense_ms / sparse_ms << "x), weights "
+                  << layer.k * layer.n * sizeof(float) << " -> " << sparse.bytes() << " bytes" << std::endl;
+    }
+
+    {
+        MLP mlp(embed_dim, mlp_dim);
+        Matrix x = Matrix::random(tokens, embed_dim, -1.0, 1.0), out;
+        mlp.set_sparse(true);
+        double sparse_ms = time_ms([&] { mlp.forward(ConstMatrixView(x), out); });
+        mlp.set_sparse(false);
+        double dense_ms = time_ms([&] { mlp.forward(ConstMatrixView(x), out); });
+        std::cout << "  MLP forward: dense " << dense_ms << " ms, sparse " << sparse_ms << " ms ("
+                  << dense_ms / sparse_ms << "x)" << std::endl;
+    }
+
+    {
+        VisionTransformer vit(28, 7, embed_dim, 8, mlp_dim, 4, 10, 0.0);
+        Matrix images = Matrix::random(64, 28 * 28, -1.0, 1.0), logits;
+        auto forward = [&] { vit.forward(images, logits, false); };
+        double dense_ms = time_ms(forward, 10);
+        vit.set_sparse_mlp(true);
+        double sparse_ms = time_ms(forward, 10);
+        std::cout << "  ViT forward: dense " << dense_ms << " ms, 2:4 MLP " << sparse_ms << " ms ("
+                  << dense_ms / sparse_ms << "x)" << std::endl;
+    }
+
+    if (!all_ok) {
+        std::cout << "❌ Sparse MLP check failed" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Sparse MLP benchmark completed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/reduction.h"
+#include "../include/matrix/random.h"
+#include "../include/matrix/thread_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/13_reduction_benchmark.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp -o reduction_benchmark && ./reduction_benchmark
+*/
+
+static bool check(const char* name, bool ok) {
+    std::cout << (ok ? "✓ " : "✗ ") << name << std::endl;
+    return ok;
+}
+
+template <typename F>
+static double time_ms(F&& f, int reps) {
+    f();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+// Column (axis 0) or row (axis 1) statistics accumulated in long double
+struct Reference {
+    std::vector<long double> sum, var, max;
+    std::vector<size_t> argmax;
+};
+
+static Reference reference(const Matrix& m, int axis) {
+    const size_t outer = axis == 0 ? m.getCols() : m.getRows();
+    const size_t inner = axis == 0 ? m.getRows() : m.getCols();
+    auto at = [&](size_t o, size_t i) -> long double { return axis == 0 ? m(i, o) : m(o, i); };
+    Reference r;
+    for (size_t o = 0; o < outer; o++) {
+        long double total = 0.0L, best = -INFINITY;
+        size_t best_index = 0;
+        for (size_t i = 0; i < inner; i++) {
+            total += at(o, i);
+            if (at(o, i) > best) {
+                best = at(o, i);
+                best_index = i;
+            }
+        }
+        long double mean = total / inner, squares = 0.0L;
+        for (size_t i = 0; i < inner; i++) {
+            squares += (at(o, i) - mean) * (at(o, i) - mean);
+        }
+        r.sum.push_back(total);
+        r.var.push_back(squares / inner);
+        r.max.push_back(best);
+        r.argmax.push_back(best_index);
+    }
+    return r;
+}
+
+static double max_relative_error(const Matrix& result, const std::vector<long double>& expected) {
+    long double error = 0.0L, scale = 0.0L;
+    for (size_t i = 0; i < expected.size(); i++) {
+        error = std::max(error, std::abs(result.data()[i] - expected[i]));
+        scale = std::max(scale, std::abs(expected[i]));
+    }
+    return double(error / scale);
+}
+
+// Every reduction on both axes against the long double reference. The
+// values sit around an offset of 1000 with a small spread, which is where a
+// naive float sum and a one-pass sum-of-squares variance lose digits.
+static bool matches_reference(size_t rows, size_t cols) {
+    Matrix m = Matrix::random(rows, cols, 999.0, 1001.0);
+    bool ok = true;
+    for (int axis : {0, 1}) {
+        Reference r = reference(m, axis);
+        Matrix sums = MatrixOps::sumAxis(m, axis);
+        Matrix means = MatrixOps::meanAxis(m, axis);
+        Matrix vars = MatrixOps::varAxis(m, axis);
+        Matrix maxima = MatrixOps::maxAxis(m, axis);
+        std::vector<size_t> argmax = MatrixOps::argmaxAxis(m, axis);
+        const double eps = std::numeric_limits<Scalar>::epsilon();
+        std::vector<long double> mean(r.sum);
+        for (long double& x : mean) {
+            x /= axis == 0 ? rows : cols;
+        }
+        ok = ok && max_relative_error(sums, r.sum) < 8 * eps && max_relative_error(means, mean) < 8 * eps &&
+             max_relative_error(vars, r.var) < 1e4 * eps && max_relative_error(maxima, r.max) == 0.0 &&
+             argmax == r.argmax;
+    }
+    long double total = 0.0L;
+    for (size_t i = 0; i < m.size(); i++) {
+        total += m.data()[i];
+    }
+    return ok && std::abs(MatrixOps::sum(m) - total) / total < 8 * std::numeric_limits<Scalar>::epsilon();
+}
+
+// NaN are skipped by max/argmax; ties keep the first index
+static bool nan_and_ties() {
+    Matrix m(3, 4, 1.0);
+    m(0, 1) = NAN;
+    m(1, 2) = 5.0;
+    m(2, 2) = 5.0;
+    std::vector<size_t> rows = MatrixOps::argmaxAxis(m, 1), cols = MatrixOps::argmaxAxis(m, 0);
+    Matrix row_max = MatrixOps::maxAxis(m, 1);
+    return rows == std::vector<size_t>{0, 2, 2} && cols == std::vector<size_t>{0, 1, 1, 0} &&
+           row_max(0, 0) == 1.0 && row_max(1, 0) == 5.0;
+}
+
+int main() {
+    std::cout << "=== AXIS REDUCTION BENCHMARK ===" << std::endl;
+    Random::seed(2024);
+
+    bool all_ok = check("Small matrix matches the long double reference", matches_reference(17, 128));
+    all_ok = check("Tall matrix (row blocks) matches the reference", matches_reference(20000, 64)) && all_ok;
+    all_ok = check("Wide matrix matches the reference", matches_reference(3, 50000)) && all_ok;
+    all_ok = check("max/argmax skip NaN and keep the first of ties", nan_and_ties()) && all_ok;
+
+    // Accuracy of a naive loop against the pairwise sum on a long row
+    {
+        Matrix row = Matrix::random(1, 1 << 24, 0.0, 1.0);
+        long double exact = 0.0L;
+        Scalar naive = 0.0;
+        for (size_t i = 0; i < row.size(); i++) {
+            exact += row.data()[i];
+            naive += row.data()[i];
+        }
+        Scalar pairwise = Reduction::sum(row.data(), row.size());
+        std::cout << std::scientific << std::setprecision(2) << "\nSum of 16M values in [0, 1): naive loop error "
+                  << double(std::abs(naive - exact) / exact) << ", pairwise " << double(std::abs(pairwise - exact) / exact)
+                  << std::endl;
+    }
+
+    // Bandwidth on the dataset shape (60000 Fashion-MNIST images)
+    std::cout << std::fixed << std::setprecision(2) << "\n60000 x 784, " << ThreadPool::num_threads() << " threads:" << std::endl;
+    Matrix data = Matrix::random(60000, 784, 0.0, 1.0);
+    Matrix column_mean(1, 784), column_var(1, 784), row_sum(60000, 1);
+    const double gigabytes = data.size() * sizeof(Scalar) / 1e9;
+    struct Case { const char* name; double ms; };
+    Case cases[] = {
+        {"sumAxis 0", time_ms([&] { MatrixOps::sumAxis_into(column_mean.view(), data, 0); }, 10)},
+        {"sumAxis 1", time_ms([&] { MatrixOps::sumAxis_into(row_sum.view(), data, 1); }, 10)},
+        {"meanVarAxis 0", time_ms([&] { MatrixOps::meanVarAxis_into(column_mean.view(), column_var.view(), data, 0); }, 10)},
+        {"maxAxis 0", time_ms([&] { MatrixOps::maxAxis_into(column_mean.view(), data, 0); }, 10)},
+        {"argmaxAxis 1", time_ms([&] { MatrixOps::argmaxAxis(data, 1); }, 10)},
+    };
+    for (const Case& c : cases) {
+        std::cout << "  " << c.name << ": " << c.ms << " ms (" << gigabytes / (c.ms / 1e3) << " GB/s)" << std::endl;
+    }
+
+    if (!all_ok) {
+        std::cout << "❌ Reductions deviate from the reference" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Reduction benchmark completed!" << std::endl;
+    return 0;
+}
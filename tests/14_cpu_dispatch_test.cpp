@@ -0,0 +1,219 @@
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/cpu_features.h"
+#include "../include/matrix/gemm.h"
+#include "../include/matrix/vector_math.h"
+#include "../include/matrix/reduction.h"
+#include "../include/matrix/quantized.h"
+#include "../include/matrix/sparse.h"
+#include "../include/matrix/random.h"
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/*
+Built without -march so the binary is portable; the kernels pick their ISA at startup:
+g++ -std=c++17 -I. -O3 -pthread tests/14_cpu_dispatch_test.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp -o cpu_dispatch_test && ./cpu_dispatch_test
+*/
+
+using CpuFeatures::Isa;
+
+static bool check(const char* name, bool ok) {
+    std::cout << (ok ? "  ✓ " : "  ✗ ") << name << std::endl;
+    return ok;
+}
+
+template <typename F>
+static double time_ms(F&& f, int reps) {
+    f();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+static double gelu_reference(double x) {
+    return 0.5 * x * (1.0 + std::tanh(0.7978845608028654 * (x + 0.044715 * x * x * x)));
+}
+
+// c = GELU(a b + bias) + residual against a double reference; largest absolute error
+static double gemm_error(size_t m, size_t n, size_t k) {
+    Matrix a = Matrix::random(m, k, -1.0, 1.0), b = Matrix::random(k, n, -1.0, 1.0);
+    Matrix bias = Matrix::random(1, n, -1.0, 1.0), residual = Matrix::random(m, n, -1.0, 1.0);
+    Matrix c(m, n);
+    MatrixOps::gemm(1.0, a, false, b, false, 0.0, c, MatrixOps::make_epilogue(bias, Gemm::Activation::Gelu, residual));
+    double error = 0.0;
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double total = bias(0, j);
+            for (size_t p = 0; p < k; p++) {
+                total += static_cast<double>(a(i, p)) * b(p, j);
+            }
+            error = std::max(error, std::abs(c(i, j) - (gelu_reference(total) + residual(i, j))));
+        }
+    }
+    return error;
+}
+
+// Many 17 x 16 products (the lane-interleaved batched path) against a double reference
+static double batched_error(size_t batch) {
+    const size_t m = 17, n = 16, k = 16;
+    Matrix a = Matrix::random(m, k * batch, -1.0, 1.0), b = Matrix::random(k, n * batch, -1.0, 1.0);
+    Matrix c(m, n * batch);
+    // Problem q is the q-th column slice of a, b and c (like the attention heads)
+    MatrixOps::batched_gemm(1.0, a.view().col_range(0, k), k, false, b.view().col_range(0, n), n, false, 0.0,
+                            c.view().col_range(0, n), n, batch);
+    double error = 0.0;
+    for (size_t q = 0; q < batch; q++) {
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                double total = 0.0;
+                for (size_t p = 0; p < k; p++) {
+                    total += static_cast<double>(a(i, q * k + p)) * b(p, q * n + j);
+                }
+                error = std::max(error, std::abs(c(i, q * n + j) - total));
+            }
+        }
+    }
+    return error;
+}
+
+// Int8 product of odd shapes (partial groups, panels and tiles)
+static Matrix int8_product(const QuantizedMatrix& q, const Matrix& x) {
+    Matrix out(x.getRows(), q.out_features());
+    q.multiply(ConstMatrixView(x), out);
+    return out;
+}
+
+// 2:4 sparse product of odd shapes against the dense GEMM on the pruned
+// weights; largest absolute error
+static double sparse_error(const SparseMatrix& w, const Matrix& x) {
+    Matrix pruned(w.in_features(), w.out_features()), dense(x.getRows(), w.out_features());
+    Matrix out(x.getRows(), w.out_features());
+    w.to_matrix(MatrixView(pruned));
+    MatrixOps::matmul_into(dense, x, pruned);
+    w.multiply(ConstMatrixView(x), out);
+    double error = 0.0;
+    for (size_t i = 0; i < out.size(); i++) {
+        error = std::max(error, std::abs(double(out.data()[i]) - dense.data()[i]));
+    }
+    return error;
+}
+
+// Float exp and GELU against libm, relative to max(|exact|, |x|) in units of float epsilon
+static double vector_math_error() {
+    std::vector<float> x(20001), y(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        x[i] = -10.0f + 20.0f * i / (x.size() - 1);
+    }
+    double error = 0.0;
+    VectorMath::exp(x.data(), y.data(), x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        const double exact = std::exp(double(x[i]));
+        error = std::max(error, std::abs(y[i] - exact) / exact);
+    }
+    VectorMath::gelu(x.data(), y.data(), x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        const double exact = gelu_reference(x[i]);
+        error = std::max(error, std::abs(y[i] - exact) / std::max(std::abs(exact), std::abs(double(x[i]))));
+    }
+    return error / std::numeric_limits<float>::epsilon();
+}
+
+// Pairwise sum, max and argmax of an odd-length array against long double
+static bool reductions_match() {
+    Matrix row = Matrix::random(1, 100003, 999.0, 1001.0);
+    row(0, 54321) = 2000.0;
+    long double exact = 0.0L;
+    for (size_t i = 0; i < row.size(); i++) {
+        exact += row.data()[i];
+    }
+    const Scalar total = Reduction::sum(row.data(), row.size());
+    return std::abs(total - exact) / exact < 8 * std::numeric_limits<Scalar>::epsilon() &&
+           Reduction::max(row.data(), row.size()) == Scalar(2000.0) &&
+           Reduction::argmax(row.data(), row.size()) == 54321;
+}
+
+int main() {
+    std::cout << "=== RUNTIME ISA DISPATCH TEST ===" << std::endl;
+    Random::seed(2024);
+    const Isa detected = CpuFeatures::detected_isa();
+    std::cout << "Detected: " << CpuFeatures::isa_name(detected)
+              << ", active at startup: " << CpuFeatures::isa_name(CpuFeatures::active_isa()) << std::endl;
+
+    const double gemm_tolerance = std::is_same<Scalar, float>::value ? 1e-4 : 1e-12;
+    const Matrix a = Matrix::random(544, 128, -1.0, 1.0), b = Matrix::random(128, 512, -1.0, 1.0);
+    Matrix c(544, 512);
+    std::vector<float> activations(1 << 20, 0.5f);
+    const Matrix data = Matrix::random(1, 1 << 24, 0.0, 1.0);
+
+    // Every int8 path accumulates the same int32 sums: results match the
+    // generic kernel exactly
+    const Matrix int8_input = Matrix::random(67, 133, -1.0, 1.0);
+    QuantizedMatrix int8_weight;
+    int8_weight.assign(ConstMatrixView(Matrix::random(133, 45, -1.0, 1.0)), false);
+    const Matrix sparse_input = Matrix::random(67, 132, -1.0, 1.0);
+    SparseMatrix sparse_weight;
+    sparse_weight.assign(ConstMatrixView(Matrix::random(132, 45, -1.0, 1.0)));
+    CpuFeatures::set_isa(Isa::Generic);
+    const Matrix int8_reference = int8_product(int8_weight, int8_input);
+    // Philox words from an unaligned start, so partial blocks are covered too
+    const Random::Stream stream(7);
+    std::vector<uint32_t> words_reference(1001), words(1001);
+    stream.bits(3, words.size(), words_reference.data());
+
+    bool all_ok = true;
+    for (Isa isa : {Isa::Generic, Isa::Sse42, Isa::Avx2, Isa::Avx512}) {
+        if (!VIT_MULTI_ISA && isa != detected) {
+            std::cout << "\n[" << CpuFeatures::isa_name(isa) << "] not compiled in (single-copy build), skipped" << std::endl;
+            continue;
+        }
+        if (static_cast<int>(isa) > static_cast<int>(detected)) {
+            std::cout << "\n[" << CpuFeatures::isa_name(isa) << "] not supported by this CPU, skipped" << std::endl;
+            continue;
+        }
+        const bool selected = CpuFeatures::set_isa(isa) == isa;
+        std::cout << "\n[" << CpuFeatures::isa_name(isa) << "] GEMM " << Gemm::kernel_name() << ", "
+                  << VectorMath::kernel_name() << ", int8 " << Quantization::kernel_name()
+                  << ", 2:4 " << Sparsity::kernel_name() << std::endl;
+        all_ok = check("set_isa selects the requested level", selected) && all_ok;
+
+        all_ok = check("GEMM + epilogue matches the reference (544x512x128, 67x45x33)",
+                       gemm_error(544, 512, 128) < 128 * gemm_tolerance && gemm_error(67, 45, 33) < 33 * gemm_tolerance) && all_ok;
+        all_ok = check("Batched 17x16 products match the reference", batched_error(37) < 16 * gemm_tolerance) && all_ok;
+        all_ok = check("exp/GELU within 4 float epsilon of libm", vector_math_error() < 4.0) && all_ok;
+        all_ok = check("Pairwise sum, max and argmax match", reductions_match()) && all_ok;
+        const Matrix int8_result = int8_product(int8_weight, int8_input);
+        all_ok = check("Int8 product matches the generic kernel exactly",
+                       std::equal(int8_result.data(), int8_result.data() + int8_result.size(), int8_reference.data())) &&
+                 all_ok;
+
+        stream.bits(3, words.size(), words.data());
+        all_ok = check("Philox words match the generic kernel", words == words_reference) && all_ok;
+        all_ok = check("2:4 sparse product matches the dense GEMM (67x45x132)",
+                       sparse_error(sparse_weight, sparse_input) < 132 * gemm_tolerance) && all_ok;
+
+        const double gemm_ms = time_ms([&] { MatrixOps::matmul_into(c, a, b); }, 20);
+        const double gelu_ms = time_ms([&] { VectorMath::gelu(activations.data(), activations.data(), activations.size()); }, 20);
+        const double sum_ms = time_ms([&] { Reduction::sum(data.data(), data.size()); }, 5);
+        std::cout << std::fixed << std::setprecision(2)
+                  << "  GEMM 544x512x128: " << 2.0 * 544 * 512 * 128 / (gemm_ms * 1e6) << " GFLOPS"
+                  << ", GELU: " << gelu_ms * 1e6 / activations.size() << " ns/elem"
+                  << ", sum: " << data.size() * sizeof(Scalar) / (sum_ms * 1e6) << " GB/s" << std::endl;
+    }
+
+    // Requests above the CPU's level are capped
+    all_ok = check("set_isa never goes above the detected level", CpuFeatures::set_isa(Isa::Avx512) == detected) && all_ok;
+
+    if (!all_ok) {
+        std::cout << "❌ Some ISA paths deviate from the reference" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Every ISA path supported by this CPU passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,217 @@
+#include "../include/transformer/multi_head_attention.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/activation_functions.h"
+#include "../include/matrix/random.h"
+#include "../include/matrix/workspace.h"
+#include "../include/matrix/thread_pool.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/15_flash_attention_benchmark.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/workspace.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp -o flash_attention_benchmark && ./flash_attention_benchmark
+*/
+
+static bool check(const std::string& name, bool ok) {
+    std::cout << (ok ? "  ✓ " : "  ✗ ") << name << std::endl;
+    return ok;
+}
+
+template <typename F>
+static double time_ms(F&& f, int reps);
+
+// Best of 3 rounds of a and b, alternating so neither always runs first
+template <typename A, typename B>
+static void best_ms(A&& a, B&& b, int reps, double& a_ms, double& b_ms) {
+    a_ms = b_ms = INFINITY;
+    for (int round = 0; round < 3; round++) {
+        a_ms = std::min(a_ms, time_ms(a, reps));
+        b_ms = std::min(b_ms, time_ms(b, reps));
+    }
+}
+
+template <typename F>
+static double time_ms(F&& f, int reps) {
+    f();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) {
+        f();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+// softmax(q k^T / sqrt(d)) v in double, one row of scores at a time
+static Matrix reference_attention(const Matrix& q, const Matrix& k, const Matrix& v) {
+    const size_t n = q.getRows(), m = k.getRows(), d = q.getCols();
+    Matrix out(n, v.getCols());
+    std::vector<double> row(m);
+    for (size_t i = 0; i < n; i++) {
+        double max_score = -INFINITY, sum = 0.0;
+        for (size_t j = 0; j < m; j++) {
+            double s = 0.0;
+            for (size_t p = 0; p < d; p++) {
+                s += double(q(i, p)) * k(j, p);
+            }
+            row[j] = s / std::sqrt(double(d));
+            max_score = std::max(max_score, row[j]);
+        }
+        for (size_t j = 0; j < m; j++) {
+            row[j] = std::exp(row[j] - max_score);
+            sum += row[j];
+        }
+        for (size_t c = 0; c < v.getCols(); c++) {
+            double total = 0.0;
+            for (size_t j = 0; j < m; j++) {
+                total += row[j] * v(j, c);
+            }
+            out(i, c) = total / sum;
+        }
+    }
+    return out;
+}
+
+static double max_error(const Matrix& a, const Matrix& b) {
+    double error = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        error = std::max(error, std::abs(double(a.data()[i]) - b.data()[i]));
+    }
+    return error;
+}
+
+int main() {
+    std::cout << "=== FUSED (FLASH-STYLE) ATTENTION BENCHMARK ===" << std::endl;
+    Random::seed(7);
+    const double tolerance = std::is_same<Scalar, float>::value ? 1e-5 : 1e-13;
+    const size_t head_dim = 16;
+    MultiHeadAttention attention(head_dim, 1);
+    bool all_ok = true;
+    size_t tile_scratch = 0;
+
+    // 50 tokens: patch 4 on 28x28 (+ CLS); 197/577: 224x224 with patch 16/8 (+ CLS)
+    for (size_t seq_len : {50, 65, 197, 577}) {
+        std::cout << "\n[seq_len " << seq_len << ", head_dim " << head_dim << "]" << std::endl;
+        // Large logits make later tiles raise the running max of many rows
+        Matrix q = Matrix::random(seq_len, head_dim, -3.0, 3.0);
+        Matrix k = Matrix::random(seq_len, head_dim, -3.0, 3.0);
+        Matrix v = Matrix::random(seq_len, head_dim, -1.0, 1.0);
+        Matrix fused(seq_len, head_dim), materialized(seq_len, head_dim);
+
+        Workspace fused_ws, materialized_ws;
+        auto run_fused = [&] { attention.scaled_dot_product_attention(q, k, v, fused.view(), fused_ws); };
+        // What the attention core did before: full scores, softmax, second GEMM
+        auto run_materialized = [&] {
+            Workspace::Scope scope(materialized_ws);
+            MatrixView scores = materialized_ws.matrix<Scalar>(seq_len, seq_len);
+            MatrixOps::gemm(1.0 / std::sqrt(double(head_dim)), q, false, k, true, 0.0, scores);
+            ActivationFunctions::softmax_inplace(scores);
+            MatrixOps::matmul_into(materialized.view(), ConstMatrixView(scores), v);
+        };
+
+        const int reps = seq_len > 200 ? 50 : 500;
+        double fused_ms, materialized_ms;
+        best_ms(run_fused, run_materialized, reps, fused_ms, materialized_ms);
+
+        const Matrix expected = reference_attention(q, k, v);
+        all_ok = check("Fused output matches the double reference", max_error(fused, expected) < tolerance) && all_ok;
+        // One score tile whatever the length
+        tile_scratch = tile_scratch ? tile_scratch : fused_ws.peak();
+        all_ok = check("Scratch does not grow with seq_len", fused_ws.peak() == tile_scratch) && all_ok;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  fused: " << fused_ms << " ms, " << fused_ws.peak() / 1024.0 << " KB scratch" << std::endl
+                  << "  materialized: " << materialized_ms << " ms, " << materialized_ws.peak() / 1024.0 << " KB scratch"
+                  << " (fused speed-up " << materialized_ms / fused_ms << "x)" << std::endl;
+    }
+
+    // The forward of a whole batch against one sequence at a time
+    {
+        const size_t batch = 3, seq_len = 70, embed_dim = 64, num_heads = 4;
+        MultiHeadAttention mha(embed_dim, num_heads);
+        Matrix input = Matrix::random(batch * seq_len, embed_dim, -1.0, 1.0);
+        Matrix output(batch * seq_len, embed_dim);
+        mha.forward(ConstTensor3View(input, seq_len), Tensor3View(output.view(), seq_len), Workspace::local());
+
+        std::cout << "\n[forward, batch " << batch << " x " << num_heads << " heads]" << std::endl;
+        bool batch_ok = true;
+        for (size_t b = 0; b < batch; b++) {
+            Matrix single(seq_len, embed_dim);
+            mha.forward(input.row_range(b * seq_len, seq_len), single.view(), Workspace::local());
+            batch_ok = batch_ok && max_error(single, Matrix(output.row_range(b * seq_len, seq_len))) < tolerance;
+        }
+        all_ok = check("Batched forward matches one sequence at a time", batch_ok) && all_ok;
+    }
+
+    // (sample, head, query block) tasks: the same output with one thread and
+    // with several, and the speed-up on 8 heads x batch 32
+    {
+        const size_t batch = 32, seq_len = 197, embed_dim = 128, num_heads = 8;
+        const size_t default_threads = ThreadPool::num_threads();
+        const size_t threads = std::max<size_t>(4, default_threads);
+        MultiHeadAttention mha(embed_dim, num_heads);
+        Matrix input = Matrix::random(batch * seq_len, embed_dim, -1.0, 1.0);
+        Matrix serial(batch * seq_len, embed_dim), parallel(batch * seq_len, embed_dim);
+        auto run = [&](Matrix& output) {
+            mha.forward(ConstTensor3View(input, seq_len), Tensor3View(output.view(), seq_len), Workspace::local());
+        };
+
+        ThreadPool::set_num_threads(1);
+        const double serial_ms = time_ms([&] { run(serial); }, 5);
+        ThreadPool::set_num_threads(threads);
+        const double parallel_ms = time_ms([&] { run(parallel); }, 5);
+        ThreadPool::set_num_threads(default_threads);
+
+        std::cout << "\n[forward, batch " << batch << " x " << num_heads << " heads, " << seq_len << " tokens]" << std::endl;
+        all_ok = check("Same output with 1 and " + std::to_string(threads) + " threads",
+                       max_error(serial, parallel) < tolerance) && all_ok;
+        std::cout << std::fixed << std::setprecision(3) << "  1 thread: " << serial_ms << " ms, " << threads
+                  << " threads: " << parallel_ms << " ms (" << serial_ms / parallel_ms << "x)" << std::endl;
+    }
+
+    // Q/K/V projection: one GEMM against the packed head-major weights (as
+    // MultiHeadAttention stores them) against three embed_dim-wide products
+    {
+        const size_t tokens = 32 * 50, embed_dim = 128, num_heads = 8, head_dim = embed_dim / num_heads;
+        Matrix x = Matrix::random(tokens, embed_dim, -1.0, 1.0);
+        Matrix w[3] = {Matrix::random(embed_dim, embed_dim, -0.1, 0.1), Matrix::random(embed_dim, embed_dim, -0.1, 0.1),
+                       Matrix::random(embed_dim, embed_dim, -0.1, 0.1)};
+        Matrix packed(embed_dim, 3 * embed_dim);
+        for (size_t h = 0; h < num_heads; h++) {
+            for (size_t part = 0; part < 3; part++) {
+                MatrixOps::copy(packed.view().block(0, (3 * h + part) * head_dim, embed_dim, head_dim),
+                                w[part].view().col_range(h * head_dim, head_dim));
+            }
+        }
+        Matrix qkv(tokens, 3 * embed_dim), separate[3] = {Matrix(tokens, embed_dim), Matrix(tokens, embed_dim),
+                                                         Matrix(tokens, embed_dim)};
+        const double packed_ms = time_ms([&] { MatrixOps::matmul_into(qkv.view(), x, packed); }, 200);
+        const double separate_ms = time_ms([&] {
+            for (int part = 0; part < 3; part++) {
+                MatrixOps::matmul_into(separate[part].view(), x, w[part]);
+            }
+        }, 200);
+
+        std::cout << "\n[QKV projection " << tokens << "x" << embed_dim << " -> 3x" << embed_dim << "]" << std::endl;
+        bool layout_ok = true;
+        for (size_t h = 0; h < num_heads; h++) {
+            for (size_t part = 0; part < 3; part++) {
+                layout_ok = layout_ok && max_error(Matrix(qkv.view().block(0, (3 * h + part) * head_dim, tokens, head_dim)),
+                                                   Matrix(separate[part].view().col_range(h * head_dim, head_dim))) < tolerance;
+            }
+        }
+        all_ok = check("Head slices of the packed product match the separate projections", layout_ok) && all_ok;
+        std::cout << std::fixed << std::setprecision(3) << "  packed: " << packed_ms << " ms, three GEMMs: "
+                  << separate_ms << " ms (" << separate_ms / packed_ms << "x)" << std::endl;
+    }
+
+    if (!all_ok) {
+        std::cout << "\n❌ Fused attention deviates from the reference" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Fused attention matches the reference!" << std::endl;
+    return 0;
+}
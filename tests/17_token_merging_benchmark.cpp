@@ -0,0 +1,288 @@
+#include "../include/transformer/vision_transformer.h"
+#include "../include/transformer/token_merging.h"
+#include "../include/matrix/matrix_ops.h"
+#include "../include/matrix/random.h"
+#include "../include/matrix/thread_pool.h"
+#include "../include/utils/file_io.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+/*
+g++ -std=c++17 -I. -O3 -pthread tests/17_token_merging_benchmark.cpp src/matrix/matrix.cpp src/matrix/memory.cpp src/matrix/random.cpp src/matrix/matrix_ops.cpp src/matrix/gemm.cpp src/matrix/half.cpp src/matrix/workspace.cpp src/matrix/thread_pool.cpp src/matrix/cpu_features.cpp src/matrix/vector_math.cpp src/matrix/reduction.cpp src/matrix/quantized.cpp src/matrix/sparse.cpp src/matrix/activation_functions.h.cpp src/transformer/multi_head_attention.cpp src/transformer/mlp.cpp src/transformer/layer_norm.cpp src/transformer/transformer_block.cpp src/transformer/patch_embedding.cpp src/transformer/positional_encoding.cpp src/transformer/token_merging.cpp src/transformer/vision_transformer.cpp src/transformer/loss_functions.cpp src/utils/file_io.cpp -o token_merging_benchmark && ./token_merging_benchmark
+*/
+
+static bool check(const char* name, bool ok) {
+    std::cout << (ok ? "  ✓ " : "  ✗ ") << name << std::endl;
+    return ok;
+}
+
+// Fashion-MNIST test set normalized as in training, or uniform noise in the
+// same range when the files are not there
+static Matrix load_test_images(std::vector<int>& labels, size_t count) {
+    try {
+        Matrix images = FileIO::load_mnist_images("data/t10k-images-idx3-ubyte/t10k-images-idx3-ubyte");
+        labels = FileIO::load_mnist_labels("data/t10k-labels-idx1-ubyte/t10k-labels-idx1-ubyte");
+        count = std::min<size_t>(count, images.getRows());
+        Matrix normalized(images.row_range(0, count));
+        for (size_t i = 0; i < normalized.size(); i++) {
+            normalized.data()[i] = (normalized.data()[i] - 0.5) / 0.5;
+        }
+        labels.resize(count);
+        std::cout << "Fashion-MNIST test set: " << count << " images" << std::endl;
+        return normalized;
+    } catch (const std::exception&) {
+        std::cout << "Fashion-MNIST not found under data/, using random images" << std::endl;
+        labels.clear();
+        return Matrix::random(count, 28 * 28, -1.0, 1.0);
+    }
+}
+
+static double accuracy(const Matrix& logits, const std::vector<int>& labels) {
+    size_t correct = 0;
+    for (size_t i = 0; i < labels.size(); i++) {
+        const Scalar* row = logits.row_ptr(i);
+        correct += std::max_element(row, row + logits.getCols()) - row == labels[i];
+    }
+    return 100.0 * correct / labels.size();
+}
+
+static double agreement(const Matrix& a, const Matrix& b) {
+    size_t agree = 0;
+    for (size_t i = 0; i < a.getRows(); i++) {
+        const Scalar* ra = a.row_ptr(i);
+        const Scalar* rb = b.row_ptr(i);
+        agree += std::max_element(ra, ra + a.getCols()) - ra == std::max_element(rb, rb + b.getCols()) - rb;
+    }
+    return 100.0 * agree / a.getRows();
+}
+
+static double max_error(const Matrix& a, const Matrix& b) {
+    double error = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        error = std::max(error, std::abs(double(a.data()[i]) - b.data()[i]));
+    }
+    return error;
+}
+
+// Largest logit change relative to the largest |logit| of the reference
+static double relative_error(const Matrix& logits, const Matrix& reference) {
+    double max_logit = 0.0;
+    for (size_t i = 0; i < reference.size(); i++) {
+        max_logit = std::max(max_logit, std::abs(double(reference.data()[i])));
+    }
+    return max_error(logits, reference) / max_logit;
+}
+
+static Matrix run(VisionTransformer& vit, const Matrix& images, size_t batch_size) {
+    Matrix all(images.getRows(), 10), batch, logits;
+    for (size_t first = 0; first < images.getRows(); first += batch_size) {
+        size_t rows = std::min(batch_size, images.getRows() - first);
+        batch = Matrix(images.row_range(first, rows));
+        vit.forward(batch, logits, false);
+        MatrixOps::copy(all.row_range(first, rows), logits);
+    }
+    return all;
+}
+
+// Milliseconds per forward of one batch
+static double time_forward(VisionTransformer& vit, const Matrix& batch) {
+    Matrix logits;
+    for (int i = 0; i < 3; i++) {
+        vit.forward(batch, logits, false);
+    }
+    const int reps = 20;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < reps; i++) {
+        vit.forward(batch, logits, false);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / reps;
+}
+
+// Merging on its own: shapes, CLS untouched, sizes and the size-weighted
+// sum of the tokens (what later blocks average over) preserved; a merged
+// layout sized for another r is rejected
+static bool merge_invariants(double tolerance) {
+    const size_t lengths[] = {50, 17, 2, 1};
+    const size_t batch = 4, dim = 32, key_dim = 8, r = 6;
+    std::vector<size_t> offsets(batch + 1, 0), merged_offsets(batch + 1, 0);
+    for (size_t b = 0; b < batch; b++) {
+        offsets[b + 1] = offsets[b] + lengths[b];
+        merged_offsets[b + 1] = merged_offsets[b] + TokenMerging::merged_length(lengths[b], r);
+    }
+    Matrix x = Matrix::random(offsets[batch], dim, -1.0, 1.0);
+    Matrix keys = Matrix::random(offsets[batch], key_dim, -1.0, 1.0);
+    Matrix merged(merged_offsets[batch], dim);
+    std::vector<Scalar> sizes(offsets[batch]), merged_sizes(merged_offsets[batch]);
+    for (size_t t = 0; t < sizes.size(); t++) {
+        sizes[t] = Scalar(1 + t % 3);
+    }
+    TokenMerging::merge(ConstPackedBatchView(x, offsets.data(), batch), keys, sizes.data(), r,
+                        PackedBatchView(merged.view(), merged_offsets.data(), batch), merged_sizes.data());
+
+    bool ok = merged_offsets[1] == 44 && merged_offsets[2] - merged_offsets[1] == 11 &&
+              merged_offsets[3] - merged_offsets[2] == 2 && merged_offsets[4] - merged_offsets[3] == 1;
+    for (size_t b = 0; b < batch; b++) {
+        ok = ok && std::equal(x.row_ptr(offsets[b]), x.row_ptr(offsets[b]) + dim, merged.row_ptr(merged_offsets[b]));
+        double size_in = 0.0, size_out = 0.0;
+        std::vector<double> mass(dim, 0.0);
+        for (size_t t = offsets[b]; t < offsets[b + 1]; t++) {
+            size_in += sizes[t];
+            for (size_t c = 0; c < dim; c++) {
+                mass[c] += sizes[t] * x(t, c);
+            }
+        }
+        for (size_t t = merged_offsets[b]; t < merged_offsets[b + 1]; t++) {
+            size_out += merged_sizes[t];
+            for (size_t c = 0; c < dim; c++) {
+                mass[c] -= merged_sizes[t] * merged(t, c);
+            }
+        }
+        ok = ok && size_in == size_out;
+        for (size_t c = 0; c < dim; c++) {
+            ok = ok && std::abs(mass[c]) < tolerance * size_in;
+        }
+    }
+
+    bool rejected = false;
+    try {
+        TokenMerging::merge(ConstPackedBatchView(x, offsets.data(), batch), keys, sizes.data(), r + 1,
+                            PackedBatchView(merged.view(), merged_offsets.data(), batch), merged_sizes.data());
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    return ok && rejected;
+}
+
+// A sequence whose patch tokens come in identical pairs: merging every pair
+// and running the next block with proportional attention gives that block's
+// unmerged CLS output (a size-2 token weighs as much as its two copies)
+static bool duplicates_are_exact(double tolerance) {
+    const size_t pairs = 12, seq_len = 1 + 2 * pairs, embed_dim = 64;
+    TransformerBlock first(embed_dim, 4, 128), second(embed_dim, 4, 128);
+    Matrix input(seq_len, embed_dim);
+    Matrix values = Matrix::random(pairs + 1, embed_dim, -1.0, 1.0);
+    MatrixOps::copy(input.row_range(0, 1), values.row_range(0, 1));
+    for (size_t p = 0; p < pairs; p++) {
+        MatrixOps::copy(input.row_range(1 + 2 * p, 1), values.row_range(1 + p, 1));
+        MatrixOps::copy(input.row_range(2 + 2 * p, 1), values.row_range(1 + p, 1));
+    }
+
+    size_t offsets[] = {0, seq_len}, merged_offsets[] = {0, seq_len - pairs};
+    Matrix hidden(seq_len, embed_dim), keys(seq_len, embed_dim / 4);
+    first.forward(ConstPackedBatchView(input, offsets, 1), PackedBatchView(hidden.view(), offsets, 1),
+                  Workspace::local(), nullptr, keys.view());
+    Matrix merged(seq_len - pairs, embed_dim);
+    std::vector<Scalar> sizes(seq_len, 1), merged_sizes(seq_len - pairs), log_sizes(seq_len - pairs);
+    TokenMerging::merge(ConstPackedBatchView(hidden, offsets, 1), keys, sizes.data(), pairs,
+                        PackedBatchView(merged.view(), merged_offsets, 1), merged_sizes.data());
+    for (size_t t = 0; t < merged_sizes.size(); t++) {
+        log_sizes[t] = std::log(merged_sizes[t]);
+    }
+
+    Matrix full(seq_len, embed_dim), reduced(seq_len - pairs, embed_dim);
+    second.forward(ConstMatrixView(hidden), full.view(), Workspace::local());
+    second.forward(ConstPackedBatchView(merged, merged_offsets, 1), PackedBatchView(reduced.view(), merged_offsets, 1),
+                   Workspace::local(), log_sizes.data());
+    bool all_size_2 = std::count(merged_sizes.begin() + 1, merged_sizes.end(), Scalar(2)) == Scalar(pairs);
+    return all_size_2 && max_error(Matrix(full.row_range(0, 1)), Matrix(reduced.row_range(0, 1))) < tolerance;
+}
+
+int main() {
+    std::cout << "=== TOKEN MERGING BENCHMARK ===" << std::endl;
+    Random::seed(5);
+    const double tolerance = std::is_same<Scalar, float>::value ? 1e-4 : 1e-12;
+    bool all_ok = true;
+
+    std::cout << "\n[Merging]" << std::endl;
+    all_ok = check("Shapes, CLS, token sizes and size-weighted sums are preserved", merge_invariants(tolerance)) && all_ok;
+    all_ok = check("Merging duplicate tokens with proportional attention is exact", duplicates_are_exact(tolerance)) &&
+             all_ok;
+
+    // 28 x 28, patch 4: 50 tokens per image, 4 blocks of the width of
+    // tests/07_optimized_training.cpp
+    const int num_layers = 4;
+    VisionTransformer vit(28, 4, 128, 8, 512, num_layers, 10, 0.0);
+    std::vector<int> labels;
+    Matrix images = load_test_images(labels, 1024);
+
+    std::cout << "\n[Model]" << std::endl;
+    const Matrix reference = run(vit, images, 64);
+    vit.set_token_merging({0, 0, 0});
+    all_ok = check("r = 0 gives the unmerged logits", max_error(run(vit, images, 64), reference) == 0.0) && all_ok;
+
+    // Merging is per image: the batched forward, the packed one and one
+    // image at a time agree, in fp32 and with the bf16 residual stream
+    vit.set_token_merging({8, 8, 8});
+    {
+        Matrix batch(images.row_range(0, 16)), batched, packed, single;
+        std::vector<Matrix> list;
+        for (size_t b = 0; b < batch.getRows(); b++) {
+            list.emplace_back(batch.row_range(b, 1));
+        }
+        const size_t sides[] = {28, 20, 12};
+        for (size_t side : sides) {
+            list.push_back(Matrix::random(side, side, -1.0, 1.0));
+        }
+        vit.forward(batch, batched, false);
+        vit.forward(list, packed, Workspace::local());
+        bool alone = true;
+        for (size_t b = 0; b < list.size(); b++) {
+            vit.forward(std::vector<Matrix>{list[b]}, single, Workspace::local());
+            alone = alone && max_error(Matrix(packed.row_range(b, 1)), single) < tolerance;
+        }
+        all_ok = check("Merged batched and packed forwards agree", max_error(Matrix(packed.row_range(0, 16)), batched) <
+                       tolerance) && all_ok;
+        all_ok = check("Each image's merged logits match running it alone", alone) && all_ok;
+
+        vit.set_storage_type(StorageType::BFloat16);
+        Matrix bf16;
+        vit.forward(list, bf16, Workspace::local());
+        vit.set_storage_type(StorageType::Float32);
+        all_ok = check("bf16 storage stays close to fp32 with merging", max_error(bf16, packed) < 5e-2) && all_ok;
+    }
+
+    // Throughput against fidelity: r tokens merged after each of the first
+    // num_layers - 1 blocks (merging after the last block saves nothing)
+    std::cout << "\nThroughput (batch 64, " << ThreadPool::num_threads() << " threads), " << images.getRows()
+              << " images:" << std::endl;
+    std::cout << "     r  last block  ms/batch      img/s  speed-up  agreement  logit err" << (labels.empty() ? "" : "   accuracy")
+              << std::endl;
+    Matrix batch(images.row_range(0, 64));
+    double base_ms = 0.0;
+    for (size_t r : {0, 2, 4, 8, 12}) {
+        vit.set_token_merging(std::vector<size_t>(num_layers - 1, r));
+        size_t tokens = 50;
+        for (int i = 0; i < num_layers - 1; i++) {
+            tokens = TokenMerging::merged_length(tokens, r);
+        }
+        const Matrix logits = run(vit, images, 64);
+        const double ms = time_forward(vit, batch);
+        if (r == 0) {
+            base_ms = ms;
+        }
+        std::cout << std::fixed << std::setprecision(2) << std::setw(6) << r << std::setw(12) << tokens
+                  << std::setw(10) << ms << std::setw(11) << 64000.0 / ms << std::setw(9) << base_ms / ms << "x"
+                  << std::setw(10) << agreement(logits, reference) << "%" << std::setw(10)
+                  << 100.0 * relative_error(logits, reference) << "%";
+        if (!labels.empty()) {
+            std::cout << std::setw(10) << accuracy(logits, labels) << "%";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "(agreement: top-1 against r = 0; logit err: max |logit change| / max |logit|"
+              << (labels.empty() ? "; untrained weights and random images" : "") << ")" << std::endl;
+    vit.set_token_merging({});
+
+    if (!all_ok) {
+        std::cout << "\n❌ Token merging deviates from the reference" << std::endl;
+        return 1;
+    }
+    std::cout << "\n✅ Token merging works!" << std::endl;
+    return 0;
+}
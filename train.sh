@@ -1,9 +1,20 @@
 #!/bin/bash
 
 echo "=== COMPILANDO ENTRENAMIENTO TRANSFORMER ==="
-g++ -std=c++17 -I. tests/04_train_fashion_mnist.cpp \
+g++ -std=c++17 -I. -O3 -pthread tests/04_train_fashion_mnist.cpp \
     src/matrix/matrix.cpp \
+    src/matrix/memory.cpp \
+    src/matrix/random.cpp \
     src/matrix/matrix_ops.cpp \
+    src/matrix/gemm.cpp \
+    src/matrix/half.cpp \
+    src/matrix/workspace.cpp \
+    src/matrix/thread_pool.cpp \
+    src/matrix/cpu_features.cpp \
+    src/matrix/vector_math.cpp \
+    src/matrix/reduction.cpp \
+    src/matrix/quantized.cpp \
+    src/matrix/sparse.cpp \
     src/matrix/activation_functions.h.cpp \
     src/transformer/multi_head_attention.cpp \
     src/transformer/mlp.cpp \
@@ -2,10 +2,25 @@
 
 echo "Compilando CPU Optimized Vision Transformer..."
 
-g++ -std=c++17 -I. -O3 -march=native -fopenmp \
+# Portable build: every SIMD kernel (GEMM, int8, 2:4 sparse, vector math,
+# reductions, Philox, 16-bit conversions) picks its ISA at startup (see
+# include/matrix/cpu_features.h). MARCH=-march=native tunes the remaining
+# scalar code for this machine only.
+g++ -std=c++17 -I. -O3 ${MARCH} -pthread \
     tests/07_optimized_training.cpp \
     src/matrix/matrix.cpp \
+    src/matrix/memory.cpp \
+    src/matrix/random.cpp \
     src/matrix/matrix_ops.cpp \
+    src/matrix/gemm.cpp \
+    src/matrix/half.cpp \
+    src/matrix/workspace.cpp \
+    src/matrix/thread_pool.cpp \
+    src/matrix/cpu_features.cpp \
+    src/matrix/vector_math.cpp \
+    src/matrix/reduction.cpp \
+    src/matrix/quantized.cpp \
+    src/matrix/sparse.cpp \
     src/matrix/activation_functions.h.cpp \
     src/transformer/multi_head_attention.cpp \
     src/transformer/mlp.cpp \
@@ -13,6 +28,7 @@ g++ -std=c++17 -I. -O3 -march=native -fopenmp \
     src/transformer/transformer_block.cpp \
     src/transformer/patch_embedding.cpp \
     src/transformer/positional_encoding.cpp \
+    src/transformer/token_merging.cpp \
     src/transformer/vision_transformer.cpp \
     src/transformer/loss_functions.cpp \
     src/training/adam_optimizer.cpp \
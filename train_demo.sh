@@ -2,10 +2,21 @@
 
 echo "Compilando Vision Transformer Training Demo..."
 
-g++ -std=c++17 -I. \
+g++ -std=c++17 -I. -O3 -pthread \
     tests/05_vit_training_demo.cpp \
     src/matrix/matrix.cpp \
+    src/matrix/memory.cpp \
+    src/matrix/random.cpp \
     src/matrix/matrix_ops.cpp \
+    src/matrix/gemm.cpp \
+    src/matrix/half.cpp \
+    src/matrix/workspace.cpp \
+    src/matrix/thread_pool.cpp \
+    src/matrix/cpu_features.cpp \
+    src/matrix/vector_math.cpp \
+    src/matrix/reduction.cpp \
+    src/matrix/quantized.cpp \
+    src/matrix/sparse.cpp \
     src/matrix/activation_functions.h.cpp \
     src/transformer/multi_head_attention.cpp \
     src/transformer/mlp.cpp \
@@ -13,6 +24,7 @@ g++ -std=c++17 -I. \
     src/transformer/transformer_block.cpp \
     src/transformer/patch_embedding.cpp \
     src/transformer/positional_encoding.cpp \
+    src/transformer/token_merging.cpp \
     src/transformer/vision_transformer.cpp \
     src/transformer/loss_functions.cpp \
     src/utils/file_io.cpp \
@@ -12,7 +12,18 @@ if command -v nvcc &> /dev/null; then
     nvcc -std=c++17 -arch=sm_75 -I. -DUSE_CUDA \
         tests/07_optimized_training.cpp \
         src/matrix/matrix.cpp \
+        src/matrix/memory.cpp \
+        src/matrix/random.cpp \
         src/matrix/matrix_ops.cpp \
+        src/matrix/gemm.cpp \
+        src/matrix/half.cpp \
+        src/matrix/workspace.cpp \
+        src/matrix/thread_pool.cpp \
+        src/matrix/cpu_features.cpp \
+        src/matrix/vector_math.cpp \
+        src/matrix/reduction.cpp \
+        src/matrix/quantized.cpp \
+        src/matrix/sparse.cpp \
         src/matrix/activation_functions.h.cpp \
         src/transformer/multi_head_attention.cpp \
         src/transformer/mlp.cpp \
@@ -20,6 +31,7 @@ if command -v nvcc &> /dev/null; then
         src/transformer/transformer_block.cpp \
         src/transformer/patch_embedding.cpp \
         src/transformer/positional_encoding.cpp \
+        src/transformer/token_merging.cpp \
         src/transformer/vision_transformer.cpp \
         src/transformer/loss_functions.cpp \
         src/training/adam_optimizer.cpp \
@@ -31,10 +43,23 @@ if command -v nvcc &> /dev/null; then
         -o optimized_vit_training
 else
     echo "CUDA not found, compiling CPU version..."
-    g++ -std=c++17 -I. -O3 -march=native -fopenmp \
+    # Portable like train_cpu_optimized.sh: the SIMD kernels pick their ISA at
+    # startup, MARCH=-march=native only tunes the scalar code
+    g++ -std=c++17 -I. -O3 ${MARCH} -pthread \
         tests/07_optimized_training.cpp \
         src/matrix/matrix.cpp \
+        src/matrix/memory.cpp \
+        src/matrix/random.cpp \
         src/matrix/matrix_ops.cpp \
+        src/matrix/gemm.cpp \
+        src/matrix/half.cpp \
+        src/matrix/workspace.cpp \
+        src/matrix/thread_pool.cpp \
+        src/matrix/cpu_features.cpp \
+        src/matrix/vector_math.cpp \
+        src/matrix/reduction.cpp \
+        src/matrix/quantized.cpp \
+        src/matrix/sparse.cpp \
         src/matrix/activation_functions.h.cpp \
         src/transformer/multi_head_attention.cpp \
         src/transformer/mlp.cpp \
@@ -42,13 +67,13 @@ else
         src/transformer/transformer_block.cpp \
         src/transformer/patch_embedding.cpp \
         src/transformer/positional_encoding.cpp \
+        src/transformer/token_merging.cpp \
         src/transformer/vision_transformer.cpp \
         src/transformer/loss_functions.cpp \
         src/training/adam_optimizer.cpp \
         src/training/lr_scheduler.cpp \
         src/utils/data_augmentation.cpp \
         src/utils/file_io.cpp \
-        -fopenmp \
         -o optimized_vit_training
 fi
 